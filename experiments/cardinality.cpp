@@ -0,0 +1,212 @@
+/* Cardinality encoding benchmark
+ *
+ * Compares the at-most-k encodings of sat2 in two settings: first,
+ * the size of the encodings of a single constraint over 3^v inputs,
+ * i.e., the number of selectors of a Helliwell instance with v
+ * variables, for several bounds; second, the linear MAXSAT search on
+ * Helliwell instances of random functions, once per encoding.  The
+ * results are reported on the terminal and optionally as JSON.
+ *
+ * Usage:
+ *   cardinality [--json FILE] [--seed N] [--num-random N]
+ *               [--helliwell-vars N] [--size-vars N]
+ */
+
+#include <easy/esop/constructors.hpp>
+#include <easy/esop/esop.hpp>
+#include <easy/sat2/cardinality.hpp>
+#include <easy/utils/stopwatch.hpp>
+
+#include <kitty/kitty.hpp>
+#include <fmt/format.h>
+#include <json/json.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace easy;
+
+struct benchmark_params
+{
+  std::string json_filename;
+
+  uint32_t seed{0xcafeu};
+  /*! Number of random functions per number of variables */
+  uint32_t num_random{5u};
+  /*! Largest number of variables of the Helliwell instances */
+  uint32_t helliwell_vars{4u};
+  /*! Largest number of variables for the size comparison (3^v inputs) */
+  uint32_t size_vars{6u};
+};
+
+/*! \brief Sink that only counts the clauses */
+struct clause_counter
+{
+  void add_clause( std::vector<int> const& clause )
+  {
+    ++num_clauses;
+    num_literals += clause.size();
+  }
+
+  uint64_t num_clauses{0};
+  uint64_t num_literals{0};
+};
+
+std::vector<std::pair<std::string, sat2::cardinality_encoding>> const encodings = {
+    {"automatic", sat2::cardinality_encoding::automatic},
+    {"totalizer", sat2::cardinality_encoding::totalizer},
+    {"sequential_counter", sat2::cardinality_encoding::sequential_counter},
+    {"sorting_network", sat2::cardinality_encoding::sorting_network},
+    {"adder", sat2::cardinality_encoding::adder},
+};
+
+/* truth table as string with the bit of minterm 0 first */
+std::string to_spec_string( kitty::dynamic_truth_table const& tt )
+{
+  std::string s( tt.num_bits(), '0' );
+  for ( auto i = 0u; i < tt.num_bits(); ++i )
+  {
+    s[i] = kitty::get_bit( tt, i ) ? '1' : '0';
+  }
+  return s;
+}
+
+nlohmann::json compare_sizes( benchmark_params const& ps )
+{
+  nlohmann::json records = nlohmann::json::array();
+
+  uint32_t n = 1u;
+  for ( auto v = 1u; v <= ps.size_vars; ++v )
+  {
+    n *= 3u;
+    for ( auto const k : {1u, n / 16u, n / 4u, n / 2u, n - 1u} )
+    {
+      std::vector<int> lits;
+      for ( auto i = 1u; i <= n; ++i )
+      {
+        lits.emplace_back( i );
+      }
+
+      for ( const auto& [name, e] : encodings )
+      {
+        int sid = n + 1;
+        clause_counter counter;
+        sat2::cardinality_encoder encoder;
+        utils::stopwatch<>::duration time{0};
+        sat2::cardinality_constraint c;
+        {
+          utils::stopwatch t( time );
+          c = encoder.encode( counter, sid, lits, k, e );
+          encoder.at_most( counter, sid, c, k );
+        }
+
+        auto const num_variables = uint64_t( sid ) - n - 1u;
+        std::cout << fmt::format( "[i] n = {:4}  k = {:4}  {:<18} variables {:8}  clauses {:9}  literals {:10}  time {:8.3f}s\n",
+                                  n, k, name, num_variables, counter.num_clauses, counter.num_literals, utils::to_seconds( time ) );
+        records.push_back( {{"num_inputs", n}, {"bound", k}, {"encoding", name}, {"num_variables", num_variables},
+                            {"num_clauses", counter.num_clauses}, {"num_literals", counter.num_literals},
+                            {"time", utils::to_seconds( time )}} );
+      }
+    }
+  }
+
+  return records;
+}
+
+nlohmann::json compare_helliwell( benchmark_params const& ps )
+{
+  nlohmann::json records = nlohmann::json::array();
+
+  for ( const auto& [name, e] : encodings )
+  {
+    auto seed = ps.seed;
+    double total_time = 0.0;
+    uint64_t total_terms = 0u, total_clauses = 0u, num_failed = 0u;
+    for ( auto v = 2u; v <= ps.helliwell_vars; ++v )
+    {
+      for ( auto i = 0u; i < ps.num_random; ++i )
+      {
+        kitty::dynamic_truth_table bits( v );
+        kitty::create_random( bits, seed++ );
+        if ( kitty::is_const0( bits ) )
+        {
+          continue;
+        }
+
+        esop::helliwell_maxsat_statistics st;
+        esop::helliwell_maxsat_params hps;
+        hps.maxsat.cardinality = e;
+        esop::esop_from_tt<kitty::dynamic_truth_table, sat2::maxsat_linear, esop::helliwell_maxsat> synthesizer( st, hps );
+
+        utils::stopwatch<>::duration time{0};
+        esop::esop_t esop;
+        {
+          utils::stopwatch t( time );
+          esop = synthesizer.synthesize( bits );
+        }
+
+        auto const verified = !esop.empty() && esop::verify_esop( esop, to_spec_string( bits ), to_spec_string( ~bits.construct() ) );
+        total_time += utils::to_seconds( time );
+        total_terms += esop.size();
+        total_clauses += st.maxsat.sat.num_clauses;
+        num_failed += verified ? 0u : 1u;
+
+        records.push_back( {{"function", kitty::to_hex( bits )}, {"num_vars", v}, {"encoding", name},
+                            {"time", utils::to_seconds( time )}, {"terms", esop.size()}, {"verified", verified},
+                            {"stats", st.to_json()}} );
+      }
+    }
+
+    std::cout << fmt::format( "[i] helliwell {:<18} failed {:3}  time {:8.3f}s  terms {:6}  clauses {:10}\n",
+                              name, num_failed, total_time, total_terms, total_clauses ) << std::flush;
+  }
+
+  return records;
+}
+
+int main( int argc, char* argv[] )
+{
+  benchmark_params ps;
+  for ( auto i = 1; i < argc; ++i )
+  {
+    std::string const arg = argv[i];
+    if ( i + 1 == argc )
+    {
+      std::cerr << fmt::format( "[e] missing value of option {}\n", arg );
+      return 2;
+    }
+
+    std::string const value = argv[++i];
+    if ( arg == "--json" )
+      ps.json_filename = value;
+    else if ( arg == "--seed" )
+      ps.seed = std::stoul( value );
+    else if ( arg == "--num-random" )
+      ps.num_random = std::stoul( value );
+    else if ( arg == "--helliwell-vars" )
+      ps.helliwell_vars = std::stoul( value );
+    else if ( arg == "--size-vars" )
+      ps.size_vars = std::stoul( value );
+    else
+    {
+      std::cerr << fmt::format( "[e] unknown option {}\n", arg );
+      return 2;
+    }
+  }
+
+  nlohmann::json report;
+  report["config"] = {{"seed", ps.seed}, {"num_random", ps.num_random}, {"helliwell_vars", ps.helliwell_vars},
+                      {"size_vars", ps.size_vars}};
+  report["sizes"] = compare_sizes( ps );
+  report["helliwell"] = compare_helliwell( ps );
+
+  if ( !ps.json_filename.empty() )
+  {
+    std::ofstream os( ps.json_filename );
+    os << report.dump( 2 ) << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,453 @@
+/* ESOP synthesis benchmark
+ *
+ * Runs all ESOP engines on fixed, seeded sets of Boolean functions:
+ * the 4-input NPN classes, random completely-specified functions with
+ * 5 to 8 inputs, and random incompletely-specified functions.  For
+ * each engine and function, the run time, the number of terms, the
+ * T-count, and the statistics of the solvers are reported as CSV
+ * and/or JSON.
+ *
+ * Each function is synthesized several times and the minimum run time
+ * is reported, which filters out most of the scheduling noise.
+ *
+ * A JSON report of an earlier run can be passed as baseline.  The
+ * benchmark fails (exit code 1) if an engine becomes slower than the
+ * baseline by more than the time threshold or computes more terms.
+ * Slowdowns below the noise floor, which scales with the number of
+ * functions, are ignored.
+ *
+ * Usage:
+ *   esop_benchmark [--csv FILE] [--json FILE] [--baseline FILE]
+ *                  [--time-threshold RATIO] [--time-noise SECONDS]
+ *                  [--repetitions N] [--seed N] [--num-random N]
+ *                  [--exact-vars N] [--helliwell-vars N] [--conflict-limit N]
+ */
+
+#include <easy/esop/constructors.hpp>
+#include <easy/esop/cost.hpp>
+#include <easy/esop/synthesis.hpp>
+#include <easy/utils/stopwatch.hpp>
+
+#include <kitty/kitty.hpp>
+#include <fmt/format.h>
+#include <json/json.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace easy;
+
+struct benchmark_params
+{
+  std::string csv_filename;
+  std::string json_filename;
+  std::string baseline_filename;
+
+  /*! Tolerated relative slowdown with respect to the baseline */
+  double time_threshold{0.10};
+  /*! Slowdowns below this value (in seconds per function) are ignored as noise */
+  double time_noise{0.0005};
+  /*! Number of runs per function, of which the fastest is reported */
+  uint32_t repetitions{3u};
+
+  uint32_t seed{0xcafeu};
+  /*! Number of random functions per number of variables */
+  uint32_t num_random{10u};
+  /*! Largest number of variables for the SAT-based k-ESOP synthesizers */
+  uint32_t exact_vars{4u};
+  /*! Largest number of variables for the Helliwell engines */
+  uint32_t helliwell_vars{4u};
+  int conflict_limit{100000};
+};
+
+/*! \brief Benchmark function
+ *
+ * The don't cares are set to 0 in bits, such that engines for
+ * completely-specified functions implement the specification.
+ */
+struct benchmark
+{
+  std::string set;
+  kitty::dynamic_truth_table bits;
+  kitty::dynamic_truth_table care;
+
+  /*! Number of terms of the optimum PKRM, an upper bound for the exact engines */
+  uint32_t upper_bound;
+};
+
+struct engine
+{
+  std::string name;
+  uint32_t max_vars;
+  std::function<esop::esop_t( benchmark const&, nlohmann::json& )> run;
+};
+
+struct record
+{
+  std::string set;
+  std::string function;
+  uint32_t num_vars;
+  std::string engine;
+  /*! Minimum run time over all repetitions */
+  double time;
+  uint64_t terms;
+  uint64_t t_count;
+  bool verified;
+  nlohmann::json stats;
+};
+
+/* truth table as string with the bit of minterm 0 first */
+std::string to_spec_string( kitty::dynamic_truth_table const& tt )
+{
+  std::string s( tt.num_bits(), '0' );
+  for ( auto i = 0u; i < tt.num_bits(); ++i )
+  {
+    s[i] = kitty::get_bit( tt, i ) ? '1' : '0';
+  }
+  return s;
+}
+
+esop::spec to_spec( benchmark const& b )
+{
+  return {to_spec_string( b.bits ), to_spec_string( b.care )};
+}
+
+std::vector<benchmark> make_benchmarks( benchmark_params const& ps )
+{
+  std::vector<benchmark> benchmarks;
+
+  const auto add = [&]( std::string const& set, kitty::dynamic_truth_table const& bits, kitty::dynamic_truth_table const& care ) {
+    /* synthesis of constants is not supported */
+    if ( kitty::is_const0( bits ) )
+    {
+      return;
+    }
+    benchmarks.push_back( {set, bits, care, uint32_t( esop::esop_from_optimum_pkrm( bits ).size() )} );
+  };
+
+  /* all 4-input NPN classes */
+  {
+    kitty::dynamic_truth_table tt( 4u );
+    std::unordered_set<kitty::dynamic_truth_table, kitty::hash<kitty::dynamic_truth_table>> classes;
+    do
+    {
+      classes.insert( std::get<0>( kitty::exact_npn_canonization( tt ) ) );
+      kitty::next_inplace( tt );
+    } while ( !kitty::is_const0( tt ) );
+
+    std::vector<kitty::dynamic_truth_table> representatives( classes.begin(), classes.end() );
+    std::sort( representatives.begin(), representatives.end() );
+    for ( const auto& r : representatives )
+    {
+      add( "npn4", r, ~r.construct() );
+    }
+  }
+
+  /* random completely-specified functions */
+  auto seed = ps.seed;
+  for ( auto n = 5u; n <= 8u; ++n )
+  {
+    for ( auto i = 0u; i < ps.num_random; ++i )
+    {
+      kitty::dynamic_truth_table bits( n );
+      kitty::create_random( bits, seed++ );
+      add( fmt::format( "random{}", n ), bits, ~bits.construct() );
+    }
+  }
+
+  /* random incompletely-specified functions */
+  for ( auto n = 4u; n <= 5u; ++n )
+  {
+    for ( auto i = 0u; i < ps.num_random; ++i )
+    {
+      kitty::dynamic_truth_table bits( n ), care( n );
+      kitty::create_random( bits, seed++ );
+      kitty::create_random( care, seed++ );
+      add( fmt::format( "incomplete{}", n ), bits & care, care );
+    }
+  }
+
+  return benchmarks;
+}
+
+template<typename Solver>
+esop::esop_t run_helliwell_maxsat( benchmark const& b, nlohmann::json& stats )
+{
+  esop::helliwell_maxsat_statistics st;
+  esop::helliwell_maxsat_params ps;
+  esop::esop_from_tt<kitty::dynamic_truth_table, Solver, esop::helliwell_maxsat> synthesizer( st, ps );
+  auto const esop = synthesizer.synthesize( b.bits, b.care );
+  stats = st.to_json();
+  return esop;
+}
+
+std::vector<engine> make_engines( benchmark_params const& ps )
+{
+  std::vector<engine> engines;
+
+  engines.push_back( {"esop_cover", 32u, []( benchmark const& b, nlohmann::json& ) {
+      /* esop_cover expects the bit of minterm 0 last */
+      auto spec = to_spec( b );
+      std::reverse( spec.bits.begin(), spec.bits.end() );
+      std::reverse( spec.care.begin(), spec.care.end() );
+      return esop::esop_cover( spec );
+    }} );
+
+  engines.push_back( {"esop_from_pprm", 32u, []( benchmark const& b, nlohmann::json& ) {
+      return esop::esop_from_pprm( b.bits );
+    }} );
+
+  engines.push_back( {"esop_from_optimum_pkrm", 32u, []( benchmark const& b, nlohmann::json& stats ) {
+      esop::pkrm_params pps;
+      esop::pkrm_statistics st;
+      auto const esop = esop::esop_from_optimum_pkrm( b.bits, pps, st );
+      stats = {{"cache_hits", st.cache_hits}, {"cache_misses", st.cache_misses}};
+      return esop;
+    }} );
+
+  engines.push_back( {"simple_synthesizer", ps.exact_vars, [&ps]( benchmark const& b, nlohmann::json& stats ) {
+      esop::simple_synthesizer_params sps;
+      sps.number_of_terms = b.upper_bound;
+      sps.conflict_limit = ps.conflict_limit;
+      sps.num_threads = 1u;
+
+      esop::simple_synthesizer synthesizer( to_spec( b ) );
+      auto const result = synthesizer.synthesize( sps );
+      stats = synthesizer.stats();
+      return result.esop;
+    }} );
+
+  engines.push_back( {"minimum_synthesizer", ps.exact_vars, [&ps]( benchmark const& b, nlohmann::json& stats ) {
+      esop::minimum_synthesizer_params mps;
+      mps.begin = 1u;
+      mps.next = [&]( uint32_t& k, sat::sat_solver::result sat ) { if ( k >= b.upper_bound || sat.is_sat() ) return false; ++k; return true; };
+      mps.conflict_limit = ps.conflict_limit;
+
+      esop::minimum_synthesizer synthesizer( to_spec( b ) );
+      auto const result = synthesizer.synthesize( mps );
+      stats = synthesizer.stats();
+      return result.esop;
+    }} );
+
+  engines.push_back( {"helliwell_sat", ps.helliwell_vars, []( benchmark const& b, nlohmann::json& stats ) {
+      esop::helliwell_sat_statistics st;
+      esop::helliwell_sat_params hps;
+      esop::esop_from_tt<kitty::dynamic_truth_table, sat2::maxsat_rc2, esop::helliwell_sat> synthesizer( st, hps );
+      auto const esop = synthesizer.synthesize( b.bits, b.care );
+      stats = st.to_json();
+      return esop;
+    }} );
+
+  engines.push_back( {"helliwell_maxsat_linear", ps.helliwell_vars, run_helliwell_maxsat<sat2::maxsat_linear>} );
+  engines.push_back( {"helliwell_maxsat_uc", ps.helliwell_vars, run_helliwell_maxsat<sat2::maxsat_uc>} );
+  engines.push_back( {"helliwell_maxsat_rc2", ps.helliwell_vars, run_helliwell_maxsat<sat2::maxsat_rc2>} );
+
+  return engines;
+}
+
+nlohmann::json summarize( std::vector<record> const& records )
+{
+  nlohmann::json summary;
+  for ( const auto& r : records )
+  {
+    auto& s = summary[r.engine];
+    if ( s.is_null() )
+    {
+      s = {{"num_functions", 0u}, {"num_failed", 0u}, {"time", 0.0}, {"terms", 0u}, {"t_count", 0u}};
+    }
+    s["num_functions"] = s["num_functions"].get<uint64_t>() + 1u;
+    s["num_failed"] = s["num_failed"].get<uint64_t>() + ( r.verified ? 0u : 1u );
+    s["time"] = s["time"].get<double>() + r.time;
+    s["terms"] = s["terms"].get<uint64_t>() + r.terms;
+    s["t_count"] = s["t_count"].get<uint64_t>() + r.t_count;
+  }
+  return summary;
+}
+
+/* returns the number of regressions with respect to the baseline */
+uint32_t compare_to_baseline( nlohmann::json const& report, nlohmann::json const& baseline, benchmark_params const& ps )
+{
+  if ( baseline["config"] != report["config"] )
+  {
+    std::cout << "[w] the baseline has been obtained with a different configuration\n";
+  }
+
+  uint32_t num_regressions = 0u;
+  for ( auto it = report["summary"].begin(); it != report["summary"].end(); ++it )
+  {
+    auto const& base = baseline["summary"];
+    if ( base.find( it.key() ) == base.end() )
+    {
+      std::cout << fmt::format( "[w] {:<24} not in baseline\n", it.key() );
+      continue;
+    }
+
+    auto const& cur = it.value();
+    auto const& old = base[it.key()];
+    auto const time = cur["time"].get<double>();
+    auto const old_time = old["time"].get<double>();
+    auto const terms = cur["terms"].get<uint64_t>();
+    auto const old_terms = old["terms"].get<uint64_t>();
+    auto const failed = cur["num_failed"].get<uint64_t>();
+    auto const old_failed = old["num_failed"].get<uint64_t>();
+
+    auto const noise = ps.time_noise * cur["num_functions"].get<uint64_t>();
+    auto const slower = time > old_time * ( 1.0 + ps.time_threshold ) && time - old_time > noise;
+    auto const worse = terms > old_terms || failed > old_failed;
+
+    std::cout << fmt::format( "[i] {:<24} time {:8.3f}s -> {:8.3f}s  terms {:6} -> {:6}  failed {:3} -> {:3}{}\n",
+                              it.key(), old_time, time, old_terms, terms, old_failed, failed,
+                              ( slower || worse ) ? "  REGRESSION" : "" );
+    if ( slower || worse )
+    {
+      ++num_regressions;
+    }
+  }
+  return num_regressions;
+}
+
+int main( int argc, char* argv[] )
+{
+  benchmark_params ps;
+  for ( auto i = 1; i < argc; ++i )
+  {
+    std::string const arg = argv[i];
+    if ( i + 1 == argc )
+    {
+      std::cerr << fmt::format( "[e] missing value of option {}\n", arg );
+      return 2;
+    }
+
+    std::string const value = argv[++i];
+    if ( arg == "--csv" )
+      ps.csv_filename = value;
+    else if ( arg == "--json" )
+      ps.json_filename = value;
+    else if ( arg == "--baseline" )
+      ps.baseline_filename = value;
+    else if ( arg == "--time-threshold" )
+      ps.time_threshold = std::stod( value );
+    else if ( arg == "--time-noise" )
+      ps.time_noise = std::stod( value );
+    else if ( arg == "--repetitions" )
+      ps.repetitions = std::max( 1u, uint32_t( std::stoul( value ) ) );
+    else if ( arg == "--seed" )
+      ps.seed = std::stoul( value );
+    else if ( arg == "--num-random" )
+      ps.num_random = std::stoul( value );
+    else if ( arg == "--exact-vars" )
+      ps.exact_vars = std::stoul( value );
+    else if ( arg == "--helliwell-vars" )
+      ps.helliwell_vars = std::stoul( value );
+    else if ( arg == "--conflict-limit" )
+      ps.conflict_limit = std::stoi( value );
+    else
+    {
+      std::cerr << fmt::format( "[e] unknown option {}\n", arg );
+      return 2;
+    }
+  }
+
+  auto const benchmarks = make_benchmarks( ps );
+  auto const engines = make_engines( ps );
+  std::cout << fmt::format( "[i] {} functions, {} engines\n", benchmarks.size(), engines.size() ) << std::flush;
+
+  std::vector<record> records;
+  for ( const auto& e : engines )
+  {
+    std::vector<record> engine_records;
+    for ( const auto& b : benchmarks )
+    {
+      uint32_t const num_vars = b.bits.num_vars();
+      if ( num_vars > e.max_vars )
+      {
+        continue;
+      }
+
+      nlohmann::json stats;
+      esop::esop_t esop;
+      double min_time = 0.0;
+      for ( auto k = 0u; k < ps.repetitions; ++k )
+      {
+        utils::stopwatch<>::duration time{0};
+        {
+          utils::stopwatch t( time );
+          esop = e.run( b, stats );
+        }
+        min_time = k == 0u ? utils::to_seconds( time ) : std::min( min_time, utils::to_seconds( time ) );
+      }
+
+      auto const spec = to_spec( b );
+      auto const verified = !esop.empty() && esop::verify_esop( esop, spec.bits, spec.care );
+      engine_records.push_back( {b.set, kitty::to_hex( b.bits ), num_vars, e.name, min_time,
+                                 esop.size(), esop::T_count( esop, num_vars + 1u ), verified, stats} );
+    }
+
+    if ( engine_records.empty() )
+    {
+      continue;
+    }
+
+    records.insert( records.end(), engine_records.begin(), engine_records.end() );
+    auto const summary = summarize( engine_records );
+
+    auto const& s = summary[e.name];
+    std::cout << fmt::format( "[i] {:<24} functions {:4}  failed {:3}  time {:8.3f}s  terms {:6}  T-count {:8}\n",
+                              e.name, s["num_functions"].get<uint64_t>(), s["num_failed"].get<uint64_t>(),
+                              s["time"].get<double>(), s["terms"].get<uint64_t>(), s["t_count"].get<uint64_t>() ) << std::flush;
+  }
+
+  nlohmann::json report;
+  report["config"] = {{"seed", ps.seed}, {"num_random", ps.num_random}, {"exact_vars", ps.exact_vars},
+                      {"helliwell_vars", ps.helliwell_vars}, {"conflict_limit", ps.conflict_limit}, {"repetitions", ps.repetitions}};
+  report["summary"] = summarize( records );
+
+  if ( !ps.csv_filename.empty() )
+  {
+    std::ofstream os( ps.csv_filename );
+    os << "set,function,num_vars,engine,time,terms,t_count,verified\n";
+    for ( const auto& r : records )
+    {
+      os << fmt::format( "{},{},{},{},{:.6f},{},{},{}\n", r.set, r.function, r.num_vars, r.engine, r.time, r.terms, r.t_count, r.verified );
+    }
+  }
+
+  if ( !ps.json_filename.empty() )
+  {
+    report["records"] = nlohmann::json::array();
+    for ( const auto& r : records )
+    {
+      report["records"].push_back( {{"set", r.set}, {"function", r.function}, {"num_vars", r.num_vars}, {"engine", r.engine},
+                                    {"time", r.time}, {"terms", r.terms}, {"t_count", r.t_count}, {"verified", r.verified},
+                                    {"stats", r.stats}} );
+    }
+    std::ofstream os( ps.json_filename );
+    os << report.dump( 2 ) << std::endl;
+  }
+
+  if ( !ps.baseline_filename.empty() )
+  {
+    std::ifstream is( ps.baseline_filename );
+    if ( !is.good() )
+    {
+      std::cerr << fmt::format( "[e] cannot read baseline {}\n", ps.baseline_filename );
+      return 2;
+    }
+
+    nlohmann::json baseline;
+    is >> baseline;
+    if ( auto const num_regressions = compare_to_baseline( report, baseline, ps ); num_regressions > 0u )
+    {
+      std::cout << fmt::format( "[e] {} regression(s) with respect to the baseline\n", num_regressions );
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -25,8 +25,13 @@
 
 #pragma once
 
+#include <easy/algorithms/lp.hpp>
+#include <easy/esop/cube_manipulators.hpp>
+#include <easy/esop/esop_from_pkrm.hpp>
+#include <easy/utils/parallel.hpp>
 #include <kitty/kitty.hpp>
 
+#include <algorithm>
 #include <unordered_set>
 #include <vector>
 
@@ -51,7 +56,7 @@ inline void kronecker_decomposition_rec( std::unordered_set<kitty::cube, kitty::
   }
   if ( is_const0( ~tt ) )
   {
-    kitty::detail::add_to_cubes( esop, c );
+    easy::esop::detail::add_to_cubes( esop, c, true, tt.num_vars() );
     return;
   }
 
@@ -62,20 +67,21 @@ inline void kronecker_decomposition_rec( std::unordered_set<kitty::cube, kitty::
   {
   case decomposition_type::positive_davio:
     kronecker_decomposition_rec( esop, tt0, decomps, var_index + 1, c );
-    kronecker_decomposition_rec( esop, tt0 ^ tt1, decomps, var_index + 1, kitty::detail::with_literal( c, var_index, true ) );
+    kronecker_decomposition_rec( esop, tt0 ^ tt1, decomps, var_index + 1, easy::esop::detail::with_literal( c, var_index, true ) );
     break;
   case decomposition_type::negative_davio:
     kronecker_decomposition_rec( esop, tt1, decomps, var_index + 1, c );
-    kronecker_decomposition_rec( esop, tt0 ^ tt1, decomps, var_index + 1, kitty::detail::with_literal( c, var_index, false ) );
+    kronecker_decomposition_rec( esop, tt0 ^ tt1, decomps, var_index + 1, easy::esop::detail::with_literal( c, var_index, false ) );
     break;
   case decomposition_type::shannon:
-    kronecker_decomposition_rec( esop, tt0, decomps, var_index + 1, kitty::detail::with_literal( c, var_index, false ) );
-    kronecker_decomposition_rec( esop, tt1, decomps, var_index + 1, kitty::detail::with_literal( c, var_index, true ) );
+    kronecker_decomposition_rec( esop, tt0, decomps, var_index + 1, easy::esop::detail::with_literal( c, var_index, false ) );
+    kronecker_decomposition_rec( esop, tt1, decomps, var_index + 1, easy::esop::detail::with_literal( c, var_index, true ) );
     break;
   }
 }
 
-}
+} /* detail */
+
 template<typename TT>
 inline std::vector<kitty::cube> kronecker_decomposition( TT const& tt, std::vector<decomposition_type> const& decomps )
 {
@@ -85,3 +91,134 @@ inline std::vector<kitty::cube> kronecker_decomposition( TT const& tt, std::vect
   detail::kronecker_decomposition_rec( cubes, tt, decomps, 0, kitty::cube() );
   return std::vector<kitty::cube>( cubes.begin(), cubes.end() );
 }
+
+/*! \brief Parameters for optimum_kronecker_decomposition */
+struct kronecker_params
+{
+  /*! \brief Number of threads used to compute and search the cost table */
+  uint32_t num_threads{1u};
+
+  /*! \brief Also consider the optimum pseudo-Kronecker form
+   *
+   * If set, the pseudo-Kronecker form, in which every subfunction picks
+   * its own decomposition, is returned when it has fewer terms than the
+   * best Kronecker form.
+   */
+  bool pseudo_kronecker{false};
+};
+
+/*! \brief Result of optimum_kronecker_decomposition */
+struct kronecker_result
+{
+  /*! \brief Decomposition types of the best Kronecker form */
+  std::vector<decomposition_type> decomps;
+
+  /*! \brief Number of terms of the best Kronecker form before merging */
+  uint32_t num_terms{0u};
+
+  /*! \brief Cubes of the returned form */
+  std::vector<kitty::cube> cubes;
+
+  /*! \brief True, if `cubes` is the pseudo-Kronecker form */
+  bool is_pseudo_kronecker{false};
+};
+
+/*! \brief Decomposition vector of a ternary index
+
+   Digit i of `index` selects the decomposition of variable i:
+   0 for positive Davio, 1 for negative Davio, and 2 for Shannon.
+ */
+inline std::vector<decomposition_type> decomposition_vector( uint64_t index, uint32_t num_vars )
+{
+  static constexpr decomposition_type types[] = { decomposition_type::positive_davio, decomposition_type::negative_davio, decomposition_type::shannon };
+
+  std::vector<decomposition_type> decomps( num_vars );
+  for ( auto i = 0u; i < num_vars; ++i )
+  {
+    decomps[i] = types[index % 3u];
+    index /= 3u;
+  }
+  return decomps;
+}
+
+/*! \brief Number of Kronecker terms for all 3^n decomposition vectors
+
+   Entry i is the number of terms of the Kronecker form with the
+   decomposition vector `decomposition_vector( i, n )`.  Along each
+   variable, the extended truth table holds the cofactors f0, f1, and
+   f0 XOR f1, of which positive Davio selects the first and the last,
+   negative Davio the last two, and Shannon the first two.  All costs are
+   therefore obtained by one ternary butterfly over the extended truth
+   table, which shares all partial sums between neighbouring vectors, in
+   O(n 3^n) instead of 3^n full recursions [T. Sasao, Logic Synthesis
+   and Optimization, 1993].
+
+   \param tt Truth table
+   \param ps Parameters
+ */
+template<typename TT>
+inline std::vector<uint32_t> kronecker_costs( TT const& tt, kronecker_params const& ps = {} )
+{
+  lp_params lps;
+  lps.num_threads = ps.num_threads;
+
+  auto costs = detail::extended_truth_table_values( tt, lps );
+  detail::extended_weight_transform( costs, tt.num_vars(), lps );
+  return costs;
+}
+
+/*! \brief Computes a minimum-size Kronecker form
+
+   Evaluates the number of terms of all 3^n Kronecker forms using
+   `kronecker_costs` and expands the function with a best decomposition
+   vector.
+
+   \param tt Truth table
+   \param ps Parameters
+ */
+template<typename TT>
+inline kronecker_result optimum_kronecker_decomposition( TT const& tt, kronecker_params const& ps = {} )
+{
+  auto const num_vars = tt.num_vars();
+  auto const costs = kronecker_costs( tt, ps );
+
+  /* parallel arg min, ties are broken towards smaller indices */
+  auto const num_chunks = std::max( 1u, ps.num_threads );
+  uint64_t const chunk = ( costs.size() + num_chunks - 1u ) / num_chunks;
+  std::vector<uint64_t> best( num_chunks, 0u );
+  easy::utils::parallel_for( 0u, num_chunks, [&]( uint64_t c ){
+      auto const first = std::min<uint64_t>( c * chunk, costs.size() );
+      auto const last = std::min<uint64_t>( first + chunk, costs.size() );
+      best[c] = std::min_element( costs.begin() + first, costs.begin() + last ) - costs.begin();
+    }, ps.num_threads );
+
+  uint64_t index = best[0u];
+  for ( auto const& b : best )
+  {
+    if ( b < costs.size() && costs[b] < costs[index] )
+    {
+      index = b;
+    }
+  }
+
+  kronecker_result result;
+  result.decomps = decomposition_vector( index, num_vars );
+  result.num_terms = costs[index];
+  result.cubes = kronecker_decomposition( tt, result.decomps );
+
+  if ( ps.pseudo_kronecker )
+  {
+    std::unordered_set<kitty::cube, kitty::hash<kitty::cube>> cubes;
+    easy::esop::detail::expansion_cache<TT> cache;
+    easy::esop::detail::find_pkrm_expansions( tt, cache, 0 );
+    easy::esop::detail::optimum_pkrm_rec( cubes, tt, cache, 0, kitty::cube() );
+
+    if ( cubes.size() < result.cubes.size() )
+    {
+      result.cubes = std::vector<kitty::cube>( cubes.begin(), cubes.end() );
+      result.is_pseudo_kronecker = true;
+    }
+  }
+
+  return result;
+}
@@ -25,15 +25,148 @@
 
 #pragma once
 
+#include <easy/utils/parallel.hpp>
 #include <kitty/kitty.hpp>
 
 #include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
 #include <vector>
 
+/*! \brief Parameters for lp_characteristic_vector */
+struct lp_params
+{
+  /*! \brief Number of threads used by the ternary transforms */
+  uint32_t num_threads{1u};
+
+  /*! \brief Number of variables transformed per cache block
+   *
+   * The lowest `block_vars` levels of each ternary transform are applied
+   * to one contiguous block of 3^block_vars entries at a time, such that
+   * the block stays in cache; the remaining levels are applied by stride.
+   */
+  uint32_t block_vars{8u};
+};
+
 namespace detail
 {
 
-static constexpr uint32_t pow3[] = { 1u, 3u, 9u, 27u, 81u, 243u, 729u };
+static constexpr uint64_t pow3[] = {
+  1ull, 3ull, 9ull, 27ull, 81ull, 243ull, 729ull, 2187ull, 6561ull, 19683ull,
+  59049ull, 177147ull, 531441ull, 1594323ull, 4782969ull, 14348907ull,
+  43046721ull, 129140163ull, 387420489ull, 1162261467ull, 3486784401ull
+};
+
+/*! \brief Maximum number of variables supported by the LP transforms
+ *
+ * The extended tables have 3^n entries of 4 bytes each, i.e., 172 MB
+ * for n = 16.
+ */
+static constexpr uint32_t lp_max_vars = 16u;
+
+/*! \brief Applies a ternary butterfly in-place
+ *
+ * For every variable k, calls `op( a[i0], a[i1], a[i2] )` on all triples
+ * of entries whose indices differ only in the k-th ternary digit (0, 1,
+ * and 2, respectively).
+ */
+template<typename Op>
+inline void ternary_butterfly( std::vector<uint32_t>& a, uint32_t num_vars, Op&& op, lp_params const& ps )
+{
+  auto const block_vars = std::min( ps.block_vars, num_vars );
+  auto const block_size = pow3[block_vars];
+
+  /* low levels: one contiguous block of 3^block_vars entries at a time */
+  easy::utils::parallel_for( 0u, pow3[num_vars - block_vars], [&]( uint64_t block ){
+      auto const base = block * block_size;
+      for ( auto k = 0u; k < block_vars; ++k )
+      {
+        for ( auto j = 0u; j < pow3[block_vars - k - 1]; ++j )
+        {
+          auto const offset = base + pow3[k] * 3u * j;
+          for ( auto i = 0u; i < pow3[k]; ++i )
+          {
+            op( a[offset + i], a[offset + pow3[k] + i], a[offset + 2u * pow3[k] + i] );
+          }
+        }
+      }
+    }, ps.num_threads );
+
+  /* high levels: by stride, the triples are independent; the inner
+     index is split into segments of 3^seg_vars entries, such that there
+     are at least as many tasks as threads also at the top levels, where
+     only few outer triples exist */
+  for ( auto k = block_vars; k < num_vars; ++k )
+  {
+    auto seg_vars = std::min( k, block_vars );
+    while ( seg_vars > 0u && pow3[num_vars - 1u - seg_vars] < ps.num_threads )
+    {
+      --seg_vars;
+    }
+    auto const num_segments = pow3[k - seg_vars];
+
+    easy::utils::parallel_for( 0u, pow3[num_vars - 1u - seg_vars], [&]( uint64_t t ){
+        auto const offset = pow3[k] * 3u * ( t / num_segments ) + pow3[seg_vars] * ( t % num_segments );
+        for ( auto i = 0u; i < pow3[seg_vars]; ++i )
+        {
+          op( a[offset + i], a[offset + pow3[k] + i], a[offset + 2u * pow3[k] + i] );
+        }
+      }, ps.num_threads );
+  }
+}
+
+/*! \brief Computes the extended truth table as a word-per-entry table
+ *
+ * Entry i of the result is the XOR of the function over all assignments
+ * to the variables whose ternary digit in i is 2, with the other
+ * variables fixed to their digits.
+ */
+template<typename TT>
+inline std::vector<uint32_t> extended_truth_table_values( TT const& tt, lp_params const& ps = {} )
+{
+  uint32_t const num_vars = tt.num_vars();
+  assert( num_vars > 0u && num_vars <= lp_max_vars );
+
+  std::vector<uint32_t> a( pow3[num_vars], 0u );
+
+  /* fill entries with no 2s */
+  for ( uint64_t i = 0u; i < ( uint64_t( 1u ) << num_vars ); ++i )
+  {
+    if ( !kitty::get_bit( tt, i ) )
+      continue;
+
+    uint64_t ett_index = 0u;
+    for ( auto j = 0u; j < num_vars; ++j )
+    {
+      if ( ( i >> j ) & 1u )
+      {
+        ett_index += pow3[j];
+      }
+    }
+    a[ett_index] = 1u;
+  }
+
+  /* entries with 2s; the result does not depend on the order of the variables */
+  ternary_butterfly( a, num_vars, []( uint32_t& a0, uint32_t& a1, uint32_t& a2 ){
+      a2 = a0 ^ a1;
+    }, ps );
+
+  return a;
+}
+
+/*! \brief Turns an extended truth table into its extended weight table in-place */
+inline void extended_weight_transform( std::vector<uint32_t>& w, uint32_t num_vars, lp_params const& ps = {} )
+{
+  ternary_butterfly( w, num_vars, []( uint32_t& w0, uint32_t& w1, uint32_t& w2 ){
+      auto const t0 = w0 + w2;
+      auto const t1 = w1 + w2;
+      auto const t2 = w0 + w1;
+      w0 = t0;
+      w1 = t1;
+      w2 = t2;
+    }, ps );
+}
 
 class extended_truth_table
 {
@@ -41,7 +174,7 @@ public:
   extended_truth_table( uint32_t num_vars )
     : _num_vars( num_vars )
   {
-    assert( num_vars > 0u && num_vars <= 6u );
+    assert( num_vars > 0u && num_vars <= lp_max_vars );
     _bits.resize( 1u + ( pow3[num_vars] >> 6u ) );
   }
 
@@ -71,9 +204,9 @@ public:
   void set_bit( uint64_t index )
   {
     assert( index < num_bits() );
-    uint64_t const packet = index >> 6u;;
-    uint64_t const offset = index % 64ul;
-    _bits[packet] |= ( 1ul << offset );
+    uint64_t const packet = index >> 6u;
+    uint64_t const offset = index % 64u;
+    _bits[packet] |= ( uint64_t( 1u ) << offset );
   }
 
   void clear_bit( uint64_t index )
@@ -81,7 +214,7 @@ public:
     assert( index < num_bits() );
     uint64_t const packet = index >> 6u;
     uint64_t const offset = index % 64u;
-    _bits[packet] &= ~( 1ul << offset );
+    _bits[packet] &= ~( uint64_t( 1u ) << offset );
   }
 
   void print_binary() const
@@ -100,139 +233,47 @@ public:
 template<typename TT>
 inline extended_truth_table create_extended_truth_table( TT const& tt )
 {
-  auto const num_vars = tt.num_vars();
-  extended_truth_table ett( num_vars );
-
-  /* sort ett indices by the number of 2s */
-  std::vector<std::vector<uint32_t>> indices( num_vars+1u );
-  for ( auto i = 0u; i < ( pow3[num_vars] ); ++i )
-  {
-    uint32_t count_2s = 0u;
-    uint32_t value = i;
-    while ( value > 0u )
-    {
-      if ( ( value % 3 ) == 2u )
-      {
-        ++count_2s;
-      }
-      value = value / 3;
-    }
-
-    indices[count_2s].emplace_back( i );
-  }
+  auto const values = extended_truth_table_values( tt );
 
-  /* fill entries with no 2s */
-  for ( auto i = 0u; i < ( 1ul << num_vars ); ++i )
+  extended_truth_table ett( tt.num_vars() );
+  for ( auto i = 0u; i < values.size(); ++i )
   {
-    uint64_t tt_index = 0u;
-    uint64_t ett_index = 0u;
-
-    for ( auto j = 0u; j < num_vars; ++j )
-    {
-      bool const entry = ( i >> j ) & 1u;
-      if ( entry )
-      {
-        ett_index += pow3[j];
-        tt_index += 1ul << j;
-      }
-    }
-
-    if ( kitty::get_bit( tt, tt_index ) )
+    if ( values[i] )
     {
-      ett.set_bit( ett_index );
-    }
-    else
-    {
-      ett.clear_bit( ett_index );
+      ett.set_bit( i );
     }
   }
+  return ett;
+}
 
-  /* fill other entries in ascending order, first those with 1x 2, then those with 2x 2, and so forth */
-  for ( auto i = 1u; i < num_vars + 1u; ++i )
+inline std::vector<uint32_t> create_extended_weight_table( extended_truth_table const& ett )
+{
+  std::vector<uint32_t> w( ett.num_bits() );
+  for ( auto i = 0u; i < ett.num_bits(); ++i )
   {
-    for ( auto const& ett_index : indices[i] )
-    {
-      uint64_t ett_index0{0u};
-      uint64_t ett_index1{0u};
-
-      uint32_t value = ett_index;
-      uint32_t var_index = 0u;
-
-      bool first_two = true;
-      while ( value > 0u )
-      {
-        if ( ( value % 3 ) == 2u )
-        {
-          if ( first_two )
-          {
-            ett_index0 += 0*(pow3[var_index]);
-            ett_index1 += 1*(pow3[var_index]);
-            first_two = false;
-          }
-          else
-          {
-            ett_index0 += 2u*pow3[var_index];
-            ett_index1 += 2u*pow3[var_index];
-          }
-        }
-        else if ( ( value % 3 ) == 1u )
-        {
-          ett_index0 += pow3[var_index];
-          ett_index1 += pow3[var_index];
-        }
-
-        value /= 3;
-        ++var_index;
-      }
-
-      if ( ett.get_bit( ett_index0 ) ^ ett.get_bit( ett_index1 ) )
-      {
-        ett.set_bit( ett_index );
-      }
-    }
+    w[i] = ett.get_bit( i );
   }
 
-  return ett;
+  extended_weight_transform( w, ett.num_vars() );
+  return w;
 }
 
-inline std::vector<uint8_t> create_extended_weight_table( extended_truth_table const& ett )
+/*! \brief Sorts weights in-place by counting, weights are at most 2^num_vars */
+inline void sort_weights( std::vector<uint32_t>& w, uint32_t num_vars )
 {
-  std::vector<uint8_t> w( ett.num_bits() );
-  std::vector<uint8_t> w_tmp( ett.num_bits() );
-
-  for ( auto i = 0u; i < ett.num_bits(); ++i )
+  std::vector<uint64_t> counts( ( uint64_t( 1u ) << num_vars ) + 1u, 0u );
+  for ( auto const& v : w )
   {
-    if ( ett.get_bit( i ) )
-    {
-      w[i] = 1;
-    }
-    else
-    {
-      w[i] = 0;
-    }
+    assert( v < counts.size() );
+    ++counts[v];
   }
 
-  auto const n = ett.num_vars();
-  for ( auto k = 0u; k < n; ++k )
+  uint64_t pos = 0u;
+  for ( auto v = 0u; v < counts.size(); ++v )
   {
-    for ( auto j = 0u; j < pow3[n - k - 1]; ++j )
-    {
-      for ( auto i = 0u; i < pow3[k]; ++i )
-      {
-        auto const i0 = pow3[k] * (3*j + 0) + i;
-        auto const i1 = pow3[k] * (3*j + 1) + i;
-        auto const i2 = pow3[k] * (3*j + 2) + i;
-
-        w_tmp[i0] = w[i0] + w[i2];
-        w_tmp[i1] = w[i1] + w[i2];
-        w_tmp[i2] = w[i0] + w[i1];
-      }
-    }
-
-    w = w_tmp;
+    std::fill_n( w.begin() + pos, counts[v], v );
+    pos += counts[v];
   }
-
-  return w;
 }
 
 } /* detail */
@@ -243,16 +284,22 @@ inline std::vector<uint8_t> create_extended_weight_table( extended_truth_table c
    table using the method described in [N. Koda and T. Sasao, RM
    Workshop, 1993].
 
+   The extended truth table and the extended weight table are computed
+   in the same table of 3^n words by two in-place ternary butterflies,
+   which supports functions with up to 16 variables.
+
    \param Truth table
+   \param ps Parameters
    \return LP characteristic vector
  */
 template<typename TT>
-std::vector<uint8_t> lp_characteristic_vector( TT const& tt )
+std::vector<uint32_t> lp_characteristic_vector( TT const& tt, lp_params const& ps = {} )
 {
   // static_assert( is_complete_truth_table<TT>::value, "Can only be applied on complete truth tables." );
 
-  auto const ett = detail::create_extended_truth_table( tt );
-  auto ewt = detail::create_extended_weight_table( ett );
-  std::sort( std::begin( ewt ), std::end( ewt ) );
+  auto const num_vars = tt.num_vars();
+  auto ewt = detail::extended_truth_table_values( tt, ps );
+  detail::extended_weight_transform( ewt, num_vars, ps );
+  detail::sort_weights( ewt, num_vars );
   return ewt;
 }
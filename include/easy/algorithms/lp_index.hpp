@@ -0,0 +1,249 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2018-2020  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <easy/algorithms/lp.hpp>
+#include <kitty/detail/constants.hpp>
+#include <kitty/operations.hpp>
+#include <kitty/operators.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/*! \brief Hash function for LP characteristic vectors */
+struct lp_vector_hash
+{
+  std::size_t operator()( std::vector<uint32_t> const& v ) const
+  {
+    /* FNV-1a over the words of the vector */
+    uint64_t h = 0xcbf29ce484222325ull;
+    for ( auto const& w : v )
+    {
+      h ^= w;
+      h *= 0x100000001b3ull;
+    }
+    h ^= v.size();
+    return std::size_t( h );
+  }
+};
+
+/*! \brief LP classification index
+
+   Partitions functions into buckets of equal LP characteristic vectors.
+   Two functions that are equivalent under input negation and input
+   permutation always end up in the same bucket.  The converse does not
+   hold: equal LP characteristic vectors are only a necessary condition
+   for equivalence.  The index is therefore a pre-filter, and the
+   functions in a bucket are candidates for exact matching, e.g., with
+   exact_np_representative.
+
+   Functions are identified by the order in which they are inserted.
+
+   \verbatim embed:rst
+
+   Example
+
+   .. code-block:: c++
+
+      lp_index index;
+      for ( auto const& tt : functions )
+      {
+        index.insert( tt );
+      }
+
+      for ( auto b = 0u; b < index.num_buckets(); ++b )
+      {
+        // match the functions in index.bucket( b ) exactly
+      }
+   \endverbatim
+ */
+class lp_index
+{
+public:
+  using key_type = std::vector<uint32_t>;
+  using bucket_type = std::vector<uint64_t>;
+
+public:
+  explicit lp_index( lp_params const& ps = {} )
+    : _ps( ps )
+  {
+  }
+
+  /*! \brief Inserts a function and returns the index of its bucket */
+  template<typename TT>
+  uint64_t insert( TT const& tt )
+  {
+    return insert_key( lp_characteristic_vector( tt, _ps ) );
+  }
+
+  /*! \brief Inserts a function by its LP characteristic vector */
+  uint64_t insert_key( key_type const& key )
+  {
+    auto const id = _bucket_of.size();
+
+    auto it = _buckets_by_key.find( key );
+    if ( it == _buckets_by_key.end() )
+    {
+      it = _buckets_by_key.emplace( key, _buckets.size() ).first;
+      _buckets.emplace_back();
+    }
+
+    _buckets[it->second].emplace_back( id );
+    _bucket_of.emplace_back( it->second );
+    return it->second;
+  }
+
+  /*! \brief Returns the bucket of a function that is not in the index, or -1 */
+  template<typename TT>
+  int64_t find( TT const& tt ) const
+  {
+    auto const it = _buckets_by_key.find( lp_characteristic_vector( tt, _ps ) );
+    return it == _buckets_by_key.end() ? -1 : int64_t( it->second );
+  }
+
+  /*! \brief Number of inserted functions */
+  uint64_t num_functions() const
+  {
+    return _bucket_of.size();
+  }
+
+  /*! \brief Number of buckets, i.e., distinct LP characteristic vectors */
+  uint64_t num_buckets() const
+  {
+    return _buckets.size();
+  }
+
+  /*! \brief Bucket index of the function with identifier `id` */
+  uint64_t bucket_of( uint64_t id ) const
+  {
+    return _bucket_of.at( id );
+  }
+
+  /*! \brief Identifiers of the functions in a bucket, in insertion order */
+  bucket_type const& bucket( uint64_t index ) const
+  {
+    return _buckets.at( index );
+  }
+
+  /*! \brief First inserted function of each bucket
+   *
+   * The functions of a bucket are not necessarily equivalent, such that
+   * the first function does not represent the other ones in general.
+   */
+  std::vector<uint64_t> representatives() const
+  {
+    std::vector<uint64_t> reprs;
+    reprs.reserve( _buckets.size() );
+    for ( auto const& b : _buckets )
+    {
+      reprs.emplace_back( b.front() );
+    }
+    return reprs;
+  }
+
+  /*! \brief Maps bucket sizes to the number of buckets of that size */
+  std::map<uint64_t, uint64_t> bucket_size_histogram() const
+  {
+    std::map<uint64_t, uint64_t> histogram;
+    for ( auto const& b : _buckets )
+    {
+      ++histogram[b.size()];
+    }
+    return histogram;
+  }
+
+private:
+  lp_params _ps;
+  std::unordered_map<key_type, uint64_t, lp_vector_hash> _buckets_by_key;
+  std::vector<bucket_type> _buckets;
+  std::vector<uint64_t> _bucket_of;
+}; /* lp_index */
+
+/*! \brief Exact NP representative of an incompletely-specified function
+
+   Returns the smallest pair (care, bits) over all input negations and
+   input permutations, applied to both truth tables; the don't cares
+   of `bits` are set to 0.  Two functions are equivalent under input
+   negation and input permutation, including their care sets, if and
+   only if their representatives are equal.
+
+   All 2^n n! transformations are enumerated, hence the function is
+   restricted to at most 6 variables.
+
+   \param bits Truth table of the function
+   \param care Truth table of the care set
+ */
+template<typename TT>
+std::pair<TT, TT> exact_np_representative( TT const& bits, TT const& care )
+{
+  auto const num_vars = bits.num_vars();
+  assert( num_vars == care.num_vars() && num_vars <= 6 );
+
+  auto tc = care, tb = bits & care;
+  auto best = std::make_pair( tc, tb );
+  if ( num_vars == 0 )
+  {
+    return best;
+  }
+
+  if ( num_vars == 1 )
+  {
+    kitty::flip_inplace( tc, 0 );
+    kitty::flip_inplace( tb, 0 );
+    return std::min( best, std::make_pair( tc, tb ) );
+  }
+
+  /* same enumeration order as kitty::exact_npn_canonization, without output negation */
+  auto const& swaps = kitty::detail::swaps[num_vars - 2u];
+  auto const& flips = kitty::detail::flips[num_vars - 2u];
+
+  auto const apply_swaps = [&]() {
+    for ( auto const pos : swaps )
+    {
+      kitty::swap_adjacent_inplace( tc, pos );
+      kitty::swap_adjacent_inplace( tb, pos );
+      best = std::min( best, std::make_pair( tc, tb ) );
+    }
+  };
+
+  apply_swaps();
+  for ( auto const pos : flips )
+  {
+    kitty::swap_adjacent_inplace( tc, 0 );
+    kitty::flip_inplace( tc, pos );
+    kitty::swap_adjacent_inplace( tb, 0 );
+    kitty::flip_inplace( tb, pos );
+    best = std::min( best, std::make_pair( tc, tb ) );
+
+    apply_swaps();
+  }
+
+  return best;
+}
@@ -0,0 +1,151 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2017-2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <alice/alice.hpp>
+#include <easy/algorithms/lp_index.hpp>
+#include <kitty/operations.hpp>
+
+#include <set>
+#include <utility>
+
+namespace alice
+{
+
+class classify_command : public command
+{
+public:
+  explicit classify_command( const environment::ptr& env )
+      : command( env, "partitions the functions in the store into classes of equal LP characteristic vectors" )
+  {
+    opts.add_option( "--threads,-t", num_threads, "Number of threads used to compute LP characteristic vectors (default: 1)" );
+    opts.add_flag( "--representatives,-r", representatives, "Replace the function store by one representative per NP class (exact up to 6 variables)" );
+    opts.add_flag( "--verbose,-v", verbose, "Print the members of each class" );
+  }
+
+protected:
+  rules validity_rules() const
+  {
+    rules rules;
+
+    rules.push_back( {[this]() { return store<function_storee>().size() > 0; }, "function store is empty"} );
+    rules.push_back( {[this]() { return num_threads > 0; }, "number of threads must be positive"} );
+
+    return rules;
+  }
+
+  void execute()
+  {
+    auto& functions = store<function_storee>();
+
+    lp_params ps;
+    ps.num_threads = num_threads;
+    lp_index index( ps );
+
+    auto num_incomplete = 0u;
+    for ( auto i = 0u; i < functions.size(); ++i )
+    {
+      auto const& elm = functions[i];
+      if ( !kitty::is_const0( ~elm.care ) )
+      {
+        ++num_incomplete;
+      }
+      index.insert( elm.bits );
+    }
+
+    if ( num_incomplete > 0 )
+    {
+      std::cout << "[w] " << num_incomplete << " functions are incompletely-specified, their don't cares are classified as 0 in the LP classes" << std::endl;
+    }
+
+    std::cout << fmt::format( "[i] functions = {}   classes = {}", index.num_functions(), index.num_buckets() ) << std::endl;
+    for ( auto const& [size, count] : index.bucket_size_histogram() )
+    {
+      std::cout << fmt::format( "[i] {:6} classes of size {}", count, size ) << std::endl;
+    }
+
+    if ( verbose )
+    {
+      for ( auto b = 0u; b < index.num_buckets(); ++b )
+      {
+        std::cout << fmt::format( "[i] class {}:", b );
+        for ( auto const& id : index.bucket( b ) )
+        {
+          std::cout << ' ' << id;
+        }
+        std::cout << std::endl;
+      }
+    }
+
+    if ( representatives )
+    {
+      /* equal LP characteristic vectors are only necessary for NP equivalence, match the functions of each class exactly */
+      std::vector<function_storee> reprs;
+      auto num_large = 0u;
+      for ( auto b = 0u; b < index.num_buckets(); ++b )
+      {
+        std::set<std::pair<kitty::dynamic_truth_table, kitty::dynamic_truth_table>> seen;
+        for ( auto const& id : index.bucket( b ) )
+        {
+          auto const& elm = functions[id];
+          uint32_t const num_vars = elm.bits.num_vars();
+
+          /* beyond 6 variables, only identical functions are merged */
+          auto const key = num_vars <= 6u ? exact_np_representative( elm.bits, elm.care )
+                                          : std::make_pair( elm.care, elm.bits & elm.care );
+          num_large += num_vars > 6u ? 1u : 0u;
+          if ( seen.insert( key ).second )
+          {
+            reprs.emplace_back( elm );
+          }
+        }
+      }
+
+      std::cout << fmt::format( "[i] NP classes = {}", reprs.size() ) << std::endl;
+      if ( num_large > 0 )
+      {
+        std::cout << "[w] " << num_large << " functions have more than 6 variables, only identical ones are merged" << std::endl;
+      }
+
+      functions.clear();
+      for ( auto const& elm : reprs )
+      {
+        functions.extend() = elm;
+      }
+    }
+  }
+
+private:
+  uint32_t num_threads = 1u;
+  bool representatives = false;
+  bool verbose = false;
+}; /* classify_command */
+
+} // namespace alice
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
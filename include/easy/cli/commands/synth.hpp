@@ -39,7 +39,9 @@ public:
     opts.add_option( "--strategy,-s", strategy, "Synthesis strategy (default: 0)\n"
                                                 "\tfixed-size 0\n"
                                                 "\tdownward 1\n"
-                                                "\tupward 2\n" );
+                                                "\tupward 2\n"
+                                                "\tparallel 3\n" );
+    opts.add_option( "--threads", number_of_threads, "Number of threads used by the parallel strategy (default: number of cores)" );
     opts.add_flag( "--all,-a", all_flag, "Use all functions in the function store" );
     opts.add_flag( "--delete,-d", delete_flag, "Do not store any result but delete them" );
   }
@@ -99,6 +101,17 @@ protected:
         easy::esop::minimum_synthesizer synthesizer( easy::esop::spec{bits, care} );
         synthesis_result = synthesizer.synthesize( params );
       }
+      else if ( strategy == 3 )
+      {
+        easy::esop::parallel_minimum_synthesizer_params params;
+        params.conflict_limit = number_of_conflicts;
+        params.lower_bound = 1;
+        params.upper_bound = number_of_terms;
+        params.num_threads = number_of_threads;
+
+        easy::esop::minimum_synthesizer synthesizer( easy::esop::spec{bits, care} );
+        synthesis_result = synthesizer.synthesize( params );
+      }
       else
       {
         std::cout << "[e] unknown strategy" << std::endl;
@@ -172,6 +185,17 @@ protected:
           easy::esop::minimum_synthesizer synthesizer( easy::esop::spec{bits, care} );
           synthesis_result = synthesizer.synthesize( params );
         }
+        else if ( strategy == 3 )
+        {
+          easy::esop::parallel_minimum_synthesizer_params params;
+          params.conflict_limit = number_of_conflicts;
+          params.lower_bound = 1;
+          params.upper_bound = number_of_terms;
+          params.num_threads = number_of_threads;
+
+          easy::esop::minimum_synthesizer synthesizer( easy::esop::spec{bits, care} );
+          synthesis_result = synthesizer.synthesize( params );
+        }
         else
         {
           std::cout << "[e] unknown strategy" << std::endl;
@@ -213,6 +237,7 @@ protected:
 private:
   unsigned number_of_terms = 8u;
   unsigned number_of_conflicts = 10000u;
+  unsigned number_of_threads = std::max( 1u, std::thread::hardware_concurrency() );
   bool all_flag = false;
   bool delete_flag = false;
   int strategy = 0;
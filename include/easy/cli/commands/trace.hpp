@@ -0,0 +1,104 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <alice/alice.hpp>
+#include <easy/utils/trace.hpp>
+#include <fstream>
+
+namespace alice
+{
+
+class trace_command : public command
+{
+public:
+  explicit trace_command( const environment::ptr& env )
+      : command( env, "records trace spans of the main phases and writes them as Chrome trace-event JSON" )
+  {
+    opts.add_flag( "--enable,-e", enable, "Enable tracing" );
+    opts.add_flag( "--disable,-d", disable, "Disable tracing" );
+    opts.add_flag( "--clear,-c", clear, "Remove the recorded spans" );
+    opts.add_option( "--capacity", capacity, "Number of spans kept per thread (default: 65536)" );
+    opts.add_option( "--output,-o", filename, "Write the recorded spans to file (open with chrome://tracing or Perfetto)" );
+  }
+
+protected:
+  rules validity_rules() const
+  {
+    rules rules;
+
+    rules.push_back( {[this]() { return !( enable && disable ); }, "tracing cannot be enabled and disabled at the same time"} );
+    rules.push_back( {[this]() { return capacity > 0; }, "capacity must be positive"} );
+
+    return rules;
+  }
+
+  void execute()
+  {
+    auto& tracer = easy::utils::tracer::instance();
+
+    if ( !filename.empty() )
+    {
+      std::ofstream os( filename );
+      if ( !os.good() )
+      {
+        std::cout << "[e] cannot open file " << filename << std::endl;
+        return;
+      }
+      tracer.write_chrome_trace( os );
+      std::cout << fmt::format( "[i] wrote {} spans to {}", tracer.num_events(), filename ) << std::endl;
+    }
+
+    if ( clear )
+    {
+      tracer.clear();
+    }
+
+    if ( enable )
+    {
+      tracer.enable( capacity );
+    }
+    else if ( disable )
+    {
+      tracer.disable();
+    }
+
+    std::cout << fmt::format( "[i] tracing is {}   spans = {}", tracer.is_enabled() ? "enabled" : "disabled", tracer.num_events() ) << std::endl;
+  }
+
+private:
+  bool enable = false;
+  bool disable = false;
+  bool clear = false;
+  uint64_t capacity = 1u << 16u;
+  std::string filename;
+}; /* trace_command */
+
+} // namespace alice
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
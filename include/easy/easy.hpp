@@ -26,6 +26,7 @@
 #pragma once
 
 #include "algorithms/lp.hpp"
+#include "algorithms/lp_index.hpp"
 #include "algorithms/kronecker_decomposition.hpp"
 #include "esop/esop.hpp"
 #include "esop/exorlink.hpp"
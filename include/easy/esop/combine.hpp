@@ -25,34 +25,159 @@
 
 #pragma once
 
-#include <esop/esop.hpp>
+#include <easy/esop/esop.hpp>
 #include <kitty/cube.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <set>
+#include <unordered_set>
+
 /***
  *
  * Combine operations for ESOPs based on
  *
  * Stergios Stergiou, George K. Papakonstantinou: Exact Minimization Of Esop Expressions With Less Than
  * Eight Product Terms. Journal of Circuits, Systems, and Computers 13(1): 1-15, 2004.
+ *
+ * The literal value i of a variable x is 0 for the negative literal
+ * !x, 1 for the positive literal x, and 2 for the constant 1.
  */
 
 namespace easy::esop
 {
 
-void simple_combine_inplace( esop_t& expr, uint8_t var_index, uint8_t i )
+/*! \cond PRIVATE */
+namespace detail
+{
+
+/* adds literal value i, which is no literal for i = 2 */
+inline void add_literal_value( kitty::cube& c, uint8_t var_index, uint8_t i )
+{
+  assert( i <= 2 );
+  if ( i != 2 )
+  {
+    c.add_literal( var_index, i == 1 );
+  }
+}
+
+/* 64-bit fingerprint of an ESOP in canonical (sorted) form */
+inline uint64_t esop_fingerprint( const esop_t& expr )
+{
+  uint64_t h = 0x9e3779b97f4a7c15ull ^ expr.size();
+  for ( const auto& c : expr )
+  {
+    /* splitmix64 finalizer on each cube */
+    uint64_t z = h + c._value + 0x9e3779b97f4a7c15ull;
+    z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ull;
+    z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebull;
+    h = z ^ ( z >> 31 );
+  }
+  return h;
+}
+
+/* hash of an ESOP in canonical (sorted) form */
+struct esop_fingerprint_hash
+{
+  std::size_t operator()( const esop_t& expr ) const
+  {
+    return static_cast<std::size_t>( esop_fingerprint( expr ) );
+  }
+};
+
+/* combines two ESOPs whose cubes are sorted in a single merge pass
+ *
+ * The cubes must not contain variable `var_index`.  Adding the same
+ * literal to such cubes then preserves their order, hence the cubes
+ * that get literal value 0, 1, and 2 form three sorted runs, which are
+ * merged in linear time.
+ */
+inline esop_t complex_combine_sorted( const esop_t& a, const esop_t& b, uint8_t var_index, uint8_t i, uint8_t j )
+{
+  std::array<esop_t, 3> runs;
+
+  const auto add = [&]( const kitty::cube& c, uint8_t value ) {
+    assert( !c.get_mask( var_index ) && !c.get_bit( var_index ) );
+    runs[value].emplace_back( c );
+    add_literal_value( runs[value].back(), var_index, value );
+  };
+
+  /* a cube in both ESOPs gets literal x^i XOR x^j, i.e., literal value 3 - i - j */
+  auto ia = a.begin();
+  auto ib = b.begin();
+  while ( ia != a.end() || ib != b.end() )
+  {
+    if ( ib == b.end() || ( ia != a.end() && *ia < *ib ) )
+    {
+      add( *ia++, i );
+    }
+    else if ( ia == a.end() || *ib < *ia )
+    {
+      add( *ib++, j );
+    }
+    else
+    {
+      add( *ia++, 3 - i - j );
+      ++ib;
+    }
+  }
+
+  esop_t partial;
+  partial.reserve( runs[0].size() + runs[1].size() );
+  std::merge( runs[0].begin(), runs[0].end(), runs[1].begin(), runs[1].end(), std::back_inserter( partial ) );
+
+  esop_t result;
+  result.reserve( partial.size() + runs[2].size() );
+  std::merge( partial.begin(), partial.end(), runs[2].begin(), runs[2].end(), std::back_inserter( result ) );
+  return result;
+}
+
+inline esops_t sorted_esops( const esops_t& esops )
+{
+  esops_t result = esops;
+  for ( auto& e : result )
+  {
+    std::sort( e.begin(), e.end() );
+  }
+  return result;
+}
+
+/* calls `fn` with the combination of each pair of ESOPs in `as` and `bs`, including duplicates */
+template<typename Fn>
+inline void foreach_combination_pair( const esops_t& as, const esops_t& bs, uint8_t var_index, uint8_t i, uint8_t j, Fn&& fn )
 {
-  assert( i >= 0 && i <= 2 );
+  auto const sorted_bs = sorted_esops( bs );
+  for ( auto a : as )
+  {
+    std::sort( a.begin(), a.end() );
+    for ( const auto& b : sorted_bs )
+    {
+      fn( complex_combine_sorted( a, b, var_index, i, j ) );
+    }
+  }
+}
+
+} // namespace detail
+/*! \endcond */
+
+inline void simple_combine_inplace( esop_t& expr, uint8_t var_index, uint8_t i )
+{
+  assert( i <= 2 );
   if ( i == 2 )
     return;
   for ( auto& c : expr )
   {
-    c.add_literal( var_index, i );
+    detail::add_literal_value( c, var_index, i );
   }
 }
 
-void simple_combine_inplace( esops_t& esops, uint8_t var_index, uint8_t i )
+inline void simple_combine_inplace( esops_t& esops, uint8_t var_index, uint8_t i )
 {
-  assert( i >= 0 && i <= 2 );
+  assert( i <= 2 );
   if ( i == 2 )
     return;
   for ( auto& e : esops )
@@ -61,84 +186,146 @@ void simple_combine_inplace( esops_t& esops, uint8_t var_index, uint8_t i )
   }
 }
 
-esop_t simple_combine( const esop_t& expr, uint8_t var_index, uint8_t i )
+inline esop_t simple_combine( const esop_t& expr, uint8_t var_index, uint8_t i )
 {
   esop_t result = expr;
   simple_combine_inplace( result, var_index, i );
   return result;
 }
 
-esops_t simple_combine( const esops_t& esops, uint8_t var_index, uint8_t i )
+inline esops_t simple_combine( const esops_t& esops, uint8_t var_index, uint8_t i )
 {
   esops_t result = esops;
   simple_combine_inplace( result, var_index, i );
   return result;
 }
 
-esop_t complex_combine( esop_t a, esop_t b, uint8_t var_index, uint8_t i, uint8_t j )
+/*! \brief Combines two ESOPs
+
+  Computes the ESOP for `a x^i XOR b x^j` of two ESOPs `a` and `b`,
+  where cubes that appear in both ESOPs are combined into a single cube.
+  The cubes of the result are sorted.
+
+  \param a First ESOP
+  \param b Second ESOP
+  \param var_index Variable x
+  \param i Literal value for `a`
+  \param j Literal value for `b`, different from `i`
+*/
+inline esop_t complex_combine( esop_t a, esop_t b, uint8_t var_index, uint8_t i, uint8_t j )
 {
-  assert( i != j );
+  assert( i <= 2 && j <= 2 && i != j );
 
-  std::vector<kitty::cube> common;
   std::sort( a.begin(), a.end() );
   std::sort( b.begin(), b.end() );
-  std::set_intersection( a.begin(), a.end(), b.begin(), b.end(), std::back_inserter( common ) );
+  return detail::complex_combine_sorted( a, b, var_index, i, j );
+}
 
-  for ( const auto& c : common )
-  {
-    a.erase( std::remove( a.begin(), a.end(), c ), a.end() );
-  }
+/*! \brief Enumerates all distinct pairwise combinations of two ESOP sets
 
-  for ( const auto& c : common )
-  {
-    b.erase( std::remove( b.begin(), b.end(), c ), b.end() );
-  }
+  Calls `fn` with each distinct ESOP `complex_combine( a, b, var_index,
+  i, j )` for `a` in `as` and `b` in `bs` as soon as it is generated,
+  without materializing the cross product.  Duplicates are looked up by
+  a 64-bit fingerprint of the (sorted) combination and confirmed by
+  comparing the cubes.  To this end, a copy of every distinct
+  combination is kept until the enumeration ends, i.e., the memory grows
+  with the number of distinct combinations.  Use the `top_k` overload of
+  `complex_combine` if only the best combinations are needed.
 
-  for ( auto& c : common )
-  {
-    c.add_literal( var_index, 3 - i - j );
-  }
+  \param as First set of ESOPs
+  \param bs Second set of ESOPs
+  \param var_index Variable
+  \param i Literal value for ESOPs in `as`
+  \param j Literal value for ESOPs in `bs`
+  \param fn Callback, called with `const esop_t&`
+*/
+template<typename Fn>
+inline void foreach_complex_combination( const esops_t& as, const esops_t& bs, uint8_t var_index, uint8_t i, uint8_t j, Fn&& fn )
+{
+  assert( i <= 2 && j <= 2 && i != j );
 
-  for ( auto& c : a )
-  {
-    if ( i != 2 )
+  std::unordered_set<esop_t, detail::esop_fingerprint_hash> seen;
+  detail::foreach_combination_pair( as, bs, var_index, i, j, [&]( esop_t&& combination ) {
+    auto const [it, inserted] = seen.insert( std::move( combination ) );
+    if ( inserted )
     {
-      c.add_literal( var_index, i );
+      fn( *it );
     }
-    common.push_back( c );
-  }
+  } );
+}
 
-  for ( auto& c : b )
-  {
-    if ( j != 2 )
-    {
-      c.add_literal( var_index, j );
-    }
-    common.push_back( c );
-  }
+/*! \brief Combines two sets of ESOPs
+
+  Returns all distinct combinations of ESOPs in `as` and `bs` in sorted
+  order.
 
-  return common;
+  \param as First set of ESOPs
+  \param bs Second set of ESOPs
+  \param var_index Variable
+  \param i Literal value for ESOPs in `as`
+  \param j Literal value for ESOPs in `bs`
+*/
+inline esops_t complex_combine( const esops_t& as, const esops_t& bs, uint8_t var_index, uint8_t i, uint8_t j )
+{
+  esops_t combinations;
+  foreach_complex_combination( as, bs, var_index, i, j, [&]( const esop_t& e ) {
+    combinations.emplace_back( e );
+  } );
+
+  std::sort( combinations.begin(), combinations.end() );
+  return combinations;
 }
 
-esops_t complex_combine( const esops_t& as, const esops_t& bs, uint8_t var_index, uint8_t i, uint8_t j )
+/*! \brief Combines two sets of ESOPs and keeps the best ones
+
+  Returns at most `top_k` distinct combinations of ESOPs in `as` and
+  `bs` with the lowest costs, ordered by ascending cost.  Ties are broken
+  by the lexicographic order of the ESOPs.  Only the (at most `top_k`)
+  kept combinations and the combination at hand are stored at any time;
+  duplicates are recognized by comparing against the kept combinations
+  only.  A duplicate of a dropped combination is dropped again, since the
+  worst kept combination never gets worse.
+
+  \param as First set of ESOPs
+  \param bs Second set of ESOPs
+  \param var_index Variable
+  \param i Literal value for ESOPs in `as`
+  \param j Literal value for ESOPs in `bs`
+  \param top_k Maximum number of combinations
+  \param cost_fn Cost of an ESOP (default: number of cubes)
+*/
+inline esops_t complex_combine( const esops_t& as, const esops_t& bs, uint8_t var_index, uint8_t i, uint8_t j, uint64_t top_k,
+                                std::function<uint64_t( const esop_t& )> const& cost_fn = []( const esop_t& e ) { return e.size(); } )
 {
-  assert( i >= 0 && i <= 2 );
-  assert( j >= 0 && j <= 2 );
-  assert( i != j );
+  assert( i <= 2 && j <= 2 && i != j );
 
-  esops_t combinations;
-  for ( const auto& a : as )
+  using entry_t = std::pair<uint64_t, esop_t>;
+
+  /* kept combinations ordered by (cost, esop), the worst one is last */
+  std::set<entry_t> kept;
+  if ( top_k > 0u )
   {
-    for ( const auto& b : bs )
-    {
-      combinations.push_back( complex_combine( a, b, var_index, i, j ) );
-    }
+    detail::foreach_combination_pair( as, bs, var_index, i, j, [&]( esop_t&& e ) {
+      auto const cost = cost_fn( e );
+      entry_t entry{cost, std::move( e )};
+      if ( kept.size() < top_k )
+      {
+        kept.emplace( std::move( entry ) );
+      }
+      else if ( entry < *kept.rbegin() && kept.find( entry ) == kept.end() )
+      {
+        kept.erase( std::prev( kept.end() ) );
+        kept.emplace( std::move( entry ) );
+      }
+    } );
   }
 
-  /* remove duplicates */
-  std::sort( combinations.begin(), combinations.end() );
-  combinations.erase( std::unique( combinations.begin(), combinations.end() ), combinations.end() );
-
+  esops_t combinations;
+  combinations.reserve( kept.size() );
+  for ( auto& entry : kept )
+  {
+    combinations.emplace_back( entry.second );
+  }
   return combinations;
 }
 
@@ -35,38 +35,115 @@
 
 #include <kitty/cube.hpp>
 
+#include <cassert>
+#include <cstdint>
 #include <unordered_set>
 
 namespace easy::esop::detail
 {
 
-inline void add_to_cubes( std::unordered_set<kitty::cube, kitty::hash<kitty::cube>>& pkrm, const kitty::cube& c, bool distance_one_merging = true )
+/*! \brief Finds a cube of distance 1 to `c` in `cubes`
+ *
+ * A cube of distance 1 differs from `c` in exactly one variable, which
+ * is either missing in one of the cubes or appears with opposite
+ * polarities.  The (at most) two such neighbours per variable are
+ * looked up in the hash set, i.e., 2n lookups for cubes over n
+ * variables.  If the set has fewer than 2n cubes, it is scanned instead,
+ * which is cheaper for functions with few cubes.
+ *
+ * \param cubes Set of cubes
+ * \param c Cube
+ * \param num_vars Number of variables of the cubes (at most 32)
+ */
+inline std::unordered_set<kitty::cube, kitty::hash<kitty::cube>>::iterator find_distance_one_cube( std::unordered_set<kitty::cube, kitty::hash<kitty::cube>>& cubes, const kitty::cube& c, uint32_t num_vars = 32u )
 {
-  /* first check whether cube is already contained; if so, delete it */
-  const auto it = pkrm.find( c );
-  if ( it != pkrm.end() )
+  assert( num_vars <= 32u );
+  assert( num_vars == 32u || ( c._mask >> num_vars ) == 0u );
+
+  if ( cubes.size() < 2u * num_vars )
   {
-    pkrm.erase( it );
-    return;
+    for ( auto it = cubes.begin(); it != cubes.end(); ++it )
+    {
+      if ( c.distance( *it ) == 1 )
+      {
+        return it;
+      }
+    }
+    return cubes.end();
   }
 
-  /* otherwise, check if there is a distance-1 cube; if so, merge it */
-  if ( distance_one_merging )
+  for ( auto i = 0u; i < num_vars; ++i )
   {
-    for ( auto it = pkrm.begin(); it != pkrm.end(); ++it )
+    const uint32_t var = uint32_t( 1 ) << i;
+
+    kitty::cube neighbour = c;
+    if ( c._mask & var )
     {
-      if ( c.distance( *it ) == 1 )
+      /* opposite polarity */
+      neighbour._bits ^= var;
+      if ( auto it = cubes.find( neighbour ); it != cubes.end() )
+      {
+        return it;
+      }
+
+      /* variable removed */
+      neighbour._bits &= ~var;
+      neighbour._mask &= ~var;
+      if ( auto it = cubes.find( neighbour ); it != cubes.end() )
+      {
+        return it;
+      }
+    }
+    else
+    {
+      /* variable added in both polarities */
+      neighbour._mask |= var;
+      if ( auto it = cubes.find( neighbour ); it != cubes.end() )
       {
-        auto new_cube = c.merge( *it );
-        pkrm.erase( it );
-        add_to_cubes( pkrm, new_cube );
-        return;
+        return it;
+      }
+
+      neighbour._bits |= var;
+      if ( auto it = cubes.find( neighbour ); it != cubes.end() )
+      {
+        return it;
       }
     }
   }
 
-  /* otherwise, just add the cube */
-  pkrm.insert( c );
+  return cubes.end();
+}
+
+inline void add_to_cubes( std::unordered_set<kitty::cube, kitty::hash<kitty::cube>>& pkrm, const kitty::cube& c, bool distance_one_merging = true, uint32_t num_vars = 32u )
+{
+  /* merging may produce a new cube, which is added in turn */
+  auto cube = c;
+  while ( true )
+  {
+    /* first check whether cube is already contained; if so, delete it */
+    const auto it = pkrm.find( cube );
+    if ( it != pkrm.end() )
+    {
+      pkrm.erase( it );
+      return;
+    }
+
+    /* otherwise, check if there is a distance-1 cube; if so, merge it */
+    if ( distance_one_merging )
+    {
+      const auto it_d1 = find_distance_one_cube( pkrm, cube, num_vars );
+      if ( it_d1 != pkrm.end() )
+      {
+        cube = cube.merge( *it_d1 );
+        pkrm.erase( it_d1 );
+        continue;
+      }
+    }
+
+    /* otherwise, just add the cube */
+    pkrm.insert( cube );
+    return;
+  }
 }
 
 inline kitty::cube with_literal( const kitty::cube& c, uint8_t var_index, bool polarity )
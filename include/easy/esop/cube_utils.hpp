@@ -25,8 +25,14 @@
 
 #pragma once
 
+#include <easy/utils/parallel.hpp>
 #include <kitty/cube.hpp>
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <iterator>
+#include <limits>
+#include <thread>
 #include <vector>
 
 namespace easy::esop
@@ -38,16 +44,46 @@ namespace detail
 static uint64_t pow3[32] = {
     0x1, 0x3, 0x9, 0x1b, 0x51, 0xf3, 0x2d9, 0x88b, 0x19a1, 0x4ce3, 0xe6a9, 0x2b3fb, 0x81bf1, 0x1853d3, 0x48fb79, 0xdaf26b, 0x290d741, 0x7b285c3, 0x17179149, 0x4546b3db, 0xcfd41b91, 0x26f7c52b3, 0x74e74f819, 0x15eb5ee84b, 0x41c21cb8e1, 0xc546562aa3, 0x24fd3027fe9, 0x6ef79077fbb, 0x14ce6b167f31, 0x3e6b41437d93, 0xbb41c3ca78b9, 0x231c54b5f6a2b}; /* pow3 */
 
+/* byte_weight[b] is the sum of 3^i over all bits i set in b */
+static constexpr auto byte_weight = []() {
+  std::array<uint32_t, 256> table{};
+  for ( auto b = 0u; b < 256u; ++b )
+  {
+    uint32_t w = 0u, p = 1u;
+    for ( auto i = 0u; i < 8u; ++i, p *= 3u )
+    {
+      if ( ( b >> i ) & 1u )
+      {
+        w += p;
+      }
+    }
+    table[b] = w;
+  }
+  return table;
+}();
+
+/* interprets the binary digits of x as ternary digits */
+inline uint64_t ternary_from_binary( uint32_t x )
+{
+  return uint64_t( byte_weight[x & 0xff] ) +
+         uint64_t( byte_weight[( x >> 8 ) & 0xff] ) * 6561ull +
+         uint64_t( byte_weight[( x >> 16 ) & 0xff] ) * 43046721ull +
+         uint64_t( byte_weight[x >> 24] ) * 282429536481ull;
+}
+
 } // namespace detail
 
+/*! \brief Ternary weight of a cube
+ *
+ * The weight is the ternary number whose i-th digit is 0 for a negative
+ * literal, 1 for a positive literal, and 2 if variable i does not occur
+ * in the cube.  It is computed with one table lookup per byte of the
+ * cube's bits and mask.
+ */
 inline uint64_t cube_weight( const kitty::cube& c, unsigned num_vars )
 {
-  uint64_t value = 0;
-  for ( auto i = 0u; i < num_vars; ++i )
-  {
-    value += c.get_mask( i ) ? ( c.get_bit( i ) ? detail::pow3[i] : 0 ) : 2 * detail::pow3[i];
-  }
-  return value;
+  const uint32_t vars = num_vars >= 32u ? ~uint32_t( 0 ) : ( ( uint32_t( 1 ) << num_vars ) - 1u );
+  return detail::ternary_from_binary( c._bits & c._mask & vars ) + 2u * detail::ternary_from_binary( ~c._mask & vars );
 }
 
 class cube_weight_compare
@@ -67,81 +103,280 @@ protected:
   unsigned _num_vars;
 }; /* cube_weight_compare */
 
-inline std::vector<std::vector<kitty::cube>> combinations( const std::vector<kitty::cube>& e, std::size_t t )
+/*! \brief Sorts cubes by their ternary weight
+ *
+ * Same order as `std::sort` with `cube_weight_compare`, but the weight
+ * of each cube is computed once.  Larger ESOPs are sorted with an LSD
+ * radix sort on the weights, which only runs as many byte passes as the
+ * largest weight needs.
+ */
+inline void sort_by_cube_weight( std::vector<kitty::cube>& cubes, unsigned num_vars )
 {
-  const auto n = e.size();
-  if ( n == t )
-    return {e};
+  using entry_t = std::pair<uint64_t, kitty::cube>;
 
-  assert( n > t );
+  std::vector<entry_t> entries( cubes.size() );
+  uint64_t max_weight = 0u;
+  for ( auto i = 0u; i < cubes.size(); ++i )
+  {
+    entries[i] = {cube_weight( cubes[i], num_vars ), cubes[i]};
+    max_weight = std::max( max_weight, entries[i].first );
+  }
 
-  std::vector<std::vector<kitty::cube>> result;
+  if ( entries.size() < 64u )
+  {
+    std::sort( entries.begin(), entries.end(), []( const entry_t& a, const entry_t& b ) { return a.first < b.first; } );
+  }
+  else
+  {
+    std::vector<entry_t> buffer( entries.size() );
+    for ( auto shift = 0u; shift < 64u && ( max_weight >> shift ) > 0u; shift += 8u )
+    {
+      std::array<std::size_t, 257> offsets{};
+      for ( const auto& e : entries )
+      {
+        ++offsets[( ( e.first >> shift ) & 0xff ) + 1u];
+      }
+      for ( auto d = 1u; d < offsets.size(); ++d )
+      {
+        offsets[d] += offsets[d - 1u];
+      }
+      for ( const auto& e : entries )
+      {
+        buffer[offsets[( e.first >> shift ) & 0xff]++] = e;
+      }
+      entries.swap( buffer );
+    }
+  }
 
-  // T1 [initialize.]
-  int j, x;
-  std::vector<int> c( t + 2 );
-  for ( auto j = 0u; j < t; ++j )
+  for ( auto i = 0u; i < cubes.size(); ++i )
   {
-    c[j] = j;
+    cubes[i] = entries[i].second;
   }
-  c[t] = n;
-  c[t + 1] = 0;
+}
+
+/*! \brief Lazy range over all t-subsets of {0, ..., n-1}
 
-  j = t;
+  Subsets are visited in colexicographic order as sorted index vectors,
+  which are updated in place; advancing an iterator does not allocate.
+  The rank of a subset c_0 < ... < c_{t-1} is the sum of the binomial
+  coefficients C(c_i, i+1), and any subset can be obtained from its rank
+  with `unrank`, such that a range can be partitioned by rank.
+ */
+class combination_range
+{
+public:
+  using value_type = std::vector<uint32_t>;
 
-  while ( true )
+  class iterator
   {
-    // T2 [visit.]
-    std::vector<kitty::cube> v;
-    for ( auto i = 0u; i < t; ++i )
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = combination_range::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    iterator( value_type c, uint32_t n, uint64_t rank )
+        : _c( std::move( c ) ), _n( n ), _rank( rank )
     {
-      v.push_back( e[c[i]] );
     }
-    result.push_back( v );
 
-    if ( j > 0 )
+    reference operator*() const
     {
-      x = j;
+      return _c;
+    }
+
+    pointer operator->() const
+    {
+      return &_c;
+    }
+
+    iterator& operator++()
+    {
+      ++_rank;
 
-      // T6 [increase c_j.]
-      c[j - 1] = x;
-      j = j - 1;
-      continue;
+      /* increase the first index that has room, reset all indices below it */
+      auto const t = _c.size();
+      for ( auto j = 0u; j < t; ++j )
+      {
+        auto const bound = j + 1 < t ? _c[j + 1] : _n;
+        if ( _c[j] + 1 < bound )
+        {
+          ++_c[j];
+          for ( auto i = 0u; i < j; ++i )
+          {
+            _c[i] = i;
+          }
+          return *this;
+        }
+      }
+      return *this;
+    }
+
+    uint64_t rank() const
+    {
+      return _rank;
     }
 
-    // T3 [easy case.]
-    if ( c[0] + 1 < c[1] )
+    bool operator==( const iterator& other ) const
     {
-      c[0] = c[0] + 1;
-      continue;
+      return _rank == other._rank;
     }
-    else
+
+    bool operator!=( const iterator& other ) const
     {
-      j = 2;
+      return _rank != other._rank;
     }
 
-    // T4 [find j.]
-    while ( true )
+  private:
+    value_type _c;
+    uint32_t _n;
+    uint64_t _rank;
+  };
+
+public:
+  /*! \brief Range over the t-subsets with ranks in [first, last)
+   *
+   * The default covers all C(n, t) subsets.
+   */
+  combination_range( uint32_t n, uint32_t t, uint64_t first = 0u, uint64_t last = std::numeric_limits<uint64_t>::max() )
+      : _n( n ), _t( t )
+  {
+    assert( t <= n );
+
+    /* Pascal's triangle up to C(n, t), saturating on overflow */
+    _binomial.resize( ( n + 1u ) * ( t + 2u ), 0u );
+    for ( auto m = 0u; m <= n; ++m )
     {
-      c[j - 2] = j - 2;
-      x = c[j - 1] + 1;
-      if ( x != c[j] )
+      binomial_ref( m, 0u ) = 1u;
+      for ( auto k = 1u; k <= std::min( m, t + 1u ); ++k )
       {
-        break;
+        auto const a = binomial_ref( m - 1u, k - 1u );
+        auto const b = binomial_ref( m - 1u, k );
+        binomial_ref( m, k ) = a > std::numeric_limits<uint64_t>::max() - b ? std::numeric_limits<uint64_t>::max() : a + b;
       }
-      j = j + 1;
     }
 
-    // T5 [done?]
-    if ( j > int( t ) )
+    _first = std::min( first, binomial( n, t ) );
+    _last = std::max( _first, std::min( last, binomial( n, t ) ) );
+  }
+
+  /*! \brief Binomial coefficient C(m, k) for m <= n and k <= t + 1 */
+  uint64_t binomial( uint32_t m, uint32_t k ) const
+  {
+    return k > m ? 0u : _binomial[m * ( _t + 2u ) + k];
+  }
+
+  uint64_t size() const
+  {
+    return _last - _first;
+  }
+
+  /*! \brief Subset with the given colexicographic rank */
+  value_type unrank( uint64_t rank ) const
+  {
+    assert( rank < binomial( _n, _t ) );
+
+    value_type c( _t );
+    uint32_t m = _n;
+    for ( auto i = _t; i > 0u; --i )
+    {
+      /* largest m with C(m, i) <= rank */
+      do
+      {
+        --m;
+      } while ( binomial( m, i ) > rank );
+      c[i - 1u] = m;
+      rank -= binomial( m, i );
+    }
+    return c;
+  }
+
+  /*! \brief Colexicographic rank of a subset */
+  uint64_t rank( const value_type& c ) const
+  {
+    uint64_t r = 0u;
+    for ( auto i = 0u; i < c.size(); ++i )
     {
-      break;
+      r += binomial( c[i], i + 1u );
     }
+    return r;
+  }
+
+  iterator begin() const
+  {
+    return iterator( _first < _last ? unrank( _first ) : value_type(), _n, _first );
+  }
+
+  iterator end() const
+  {
+    return iterator( value_type(), _n, _last );
+  }
 
-    c[j - 1] = x;
-    j = j - 1;
+private:
+  uint64_t& binomial_ref( uint32_t m, uint32_t k )
+  {
+    return _binomial[m * ( _t + 2u ) + k];
   }
 
+private:
+  uint32_t _n;
+  uint32_t _t;
+  uint64_t _first;
+  uint64_t _last;
+  std::vector<uint64_t> _binomial;
+}; /* combination_range */
+
+/*! \brief Calls `fn` with the indices of every t-subset of `n` elements
+ *
+ * The range of ranks is split into `num_threads` contiguous parts, which
+ * are enumerated concurrently; `fn` must be thread-safe if `num_threads`
+ * is larger than 1.  C(n, t) must fit into 64 bits.
+ */
+template<typename Fn>
+inline void parallel_foreach_combination( uint32_t n, uint32_t t, Fn&& fn, uint32_t num_threads = std::thread::hardware_concurrency() )
+{
+  combination_range const all( n, t );
+  assert( all.binomial( n, t ) < std::numeric_limits<uint64_t>::max() && "C(n, t) saturates" );
+
+  auto const size = all.size();
+  uint64_t const parts = std::max( 1u, num_threads );
+  auto const part_size = size / parts + ( size % parts != 0u ? 1u : 0u );
+
+  utils::parallel_for( 0u, parts, [&]( uint64_t p ) {
+    /* p * part_size does not overflow for p <= size / part_size */
+    if ( part_size == 0u || p > size / part_size )
+    {
+      return;
+    }
+    auto const first = p * part_size;
+    auto const last = first + std::min( part_size, size - first );
+    for ( const auto& c : combination_range( n, t, first, last ) )
+    {
+      fn( c );
+    }
+  }, num_threads );
+}
+
+/*! \brief Returns all t-subsets of the cubes in `e`
+ *
+ * Materializes C(|e|, t) subsets; prefer iterating over a
+ * `combination_range` for large inputs.
+ */
+inline std::vector<std::vector<kitty::cube>> combinations( const std::vector<kitty::cube>& e, std::size_t t )
+{
+  assert( e.size() >= t );
+
+  std::vector<std::vector<kitty::cube>> result;
+  for ( const auto& c : combination_range( e.size(), t ) )
+  {
+    auto& v = result.emplace_back();
+    v.reserve( t );
+    for ( const auto& i : c )
+    {
+      v.push_back( e[i] );
+    }
+  }
   return result;
 }
 
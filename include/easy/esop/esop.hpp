@@ -133,7 +133,7 @@ inline bool verify_esop( const esop_t& esop, const std::string& bits, const std:
 
   for ( auto i = 0u; i < bits.size(); ++i )
   {
-    if ( care[i] && bits[i] != '0' + char(get_bit( tt, i )) )
+    if ( care[i] == '1' && bits[i] != '0' + char(get_bit( tt, i )) )
     {
       return false;
     }
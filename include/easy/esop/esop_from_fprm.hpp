@@ -0,0 +1,252 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file esop_from_fprm.hpp
+  \brief Fixed-polarity Reed-Muller forms
+
+  \author Mathias Soeken
+  \author Winston Haaswijk
+*/
+
+#pragma once
+
+#include <easy/esop/esop.hpp>
+#include <easy/utils/bit_operations.hpp>
+#include <kitty/cube.hpp>
+#include <kitty/detail/constants.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace easy
+{
+
+namespace esop
+{
+
+/*! \cond PRIVATE */
+namespace detail
+{
+
+/*! \brief Copies the truth table into words, unused bits are cleared */
+template<typename TT>
+inline std::vector<uint64_t> rm_words( const TT& tt )
+{
+  uint32_t const num_vars = tt.num_vars();
+  std::vector<uint64_t> words( tt.cbegin(), tt.cend() );
+  if ( num_vars < 6u )
+  {
+    words[0u] &= kitty::detail::masks[num_vars];
+  }
+  return words;
+}
+
+/*! \brief Positive Davio step for one variable on all words
+ *
+ * Replaces each pair of coefficients (c0, c1), which differ in the
+ * variable, by (c0, c0 XOR c1).
+ */
+inline void rm_butterfly( std::vector<uint64_t>& words, uint32_t var_index )
+{
+  if ( var_index < 6u )
+  {
+    auto const shift = uint64_t( 1u ) << var_index;
+    for ( auto& w : words )
+    {
+      w ^= ( w & kitty::detail::projections_neg[var_index] ) << shift;
+    }
+  }
+  else
+  {
+    auto const stride = std::size_t( 1u ) << ( var_index - 6u );
+    for ( auto j = 0u; j < words.size(); j += 2u * stride )
+    {
+      for ( auto i = j; i < j + stride; ++i )
+      {
+        words[i + stride] ^= words[i];
+      }
+    }
+  }
+}
+
+/*! \brief In-place Reed-Muller transform of a truth table in words */
+inline void rm_transform( std::vector<uint64_t>& words, uint32_t num_vars )
+{
+  for ( auto i = 0u; i < num_vars; ++i )
+  {
+    rm_butterfly( words, i );
+  }
+}
+
+/*! \brief Changes the polarity of one variable in an RM spectrum
+ *
+ * Substituting the complement of a variable turns each pair of
+ * coefficients (c0, c1) into (c0 XOR c1, c1).
+ */
+inline void rm_flip_polarity( std::vector<uint64_t>& words, uint32_t var_index )
+{
+  if ( var_index < 6u )
+  {
+    auto const shift = uint64_t( 1u ) << var_index;
+    for ( auto& w : words )
+    {
+      w ^= ( w & kitty::detail::projections[var_index] ) >> shift;
+    }
+  }
+  else
+  {
+    auto const stride = std::size_t( 1u ) << ( var_index - 6u );
+    for ( auto j = 0u; j < words.size(); j += 2u * stride )
+    {
+      for ( auto i = j; i < j + stride; ++i )
+      {
+        words[i] ^= words[i + stride];
+      }
+    }
+  }
+}
+
+inline uint64_t rm_num_terms( const std::vector<uint64_t>& words )
+{
+  uint64_t count = 0u;
+  for ( const auto& w : words )
+  {
+    count += utils::popcount( w );
+  }
+  return count;
+}
+
+/*! \brief Collects the terms of an RM spectrum with the given polarity
+ *
+ * Variable i appears as a negative literal if bit i of `polarity` is
+ * set and as a positive literal otherwise.
+ */
+inline esop_t esop_from_rm_spectrum( const std::vector<uint64_t>& words, uint32_t polarity )
+{
+  esop_t esop;
+  esop.reserve( rm_num_terms( words ) );
+  for ( auto j = 0u; j < words.size(); ++j )
+  {
+    auto w = words[j];
+    while ( w )
+    {
+      uint32_t const monomial = ( j << 6u ) | utils::count_trailing_zeros( w );
+      esop.emplace_back( monomial & ~polarity, monomial );
+      w &= w - 1u;
+    }
+  }
+  return esop;
+}
+
+} // namespace detail
+/*! \endcond */
+
+/*! \brief Computes the FPRM representation for a function
+
+  Computes the fixed-polarity Reed-Muller form by an in-place
+  word-level butterfly over the truth table.
+
+  \param tt Truth table
+  \param polarity Bit i is set, if variable i has negative polarity
+*/
+template<typename TT>
+inline esop_t esop_from_fprm( const TT& tt, uint32_t polarity )
+{
+  uint32_t const num_vars = tt.num_vars();
+  assert( num_vars <= 32u );
+
+  auto words = detail::rm_words( tt );
+  detail::rm_transform( words, num_vars );
+  for ( auto i = 0u; i < num_vars; ++i )
+  {
+    if ( ( polarity >> i ) & 1u )
+    {
+      detail::rm_flip_polarity( words, i );
+    }
+  }
+  return detail::esop_from_rm_spectrum( words, polarity );
+}
+
+/*! \brief Finds a polarity vector of a minimum FPRM form
+
+  Evaluates all 2^n polarity vectors in Gray code order, such that
+  consecutive spectra differ in the polarity of a single variable and
+  are updated in place by one butterfly step.  Ties are broken towards
+  the first polarity visited.
+
+  \param tt Truth table
+  \return Polarity vector, bit i is set, if variable i has negative polarity
+*/
+template<typename TT>
+inline uint32_t optimum_fprm_polarity( const TT& tt )
+{
+  uint32_t const num_vars = tt.num_vars();
+  assert( num_vars <= 32u );
+
+  auto words = detail::rm_words( tt );
+  detail::rm_transform( words, num_vars );
+
+  uint32_t polarity = 0u;
+  uint32_t best_polarity = 0u;
+  uint64_t best_num_terms = detail::rm_num_terms( words );
+
+  for ( uint64_t step = 1u; step < ( uint64_t( 1u ) << num_vars ); ++step )
+  {
+    auto const var_index = utils::count_trailing_zeros( step );
+    detail::rm_flip_polarity( words, var_index );
+    polarity ^= 1u << var_index;
+
+    auto const num_terms = detail::rm_num_terms( words );
+    if ( num_terms < best_num_terms )
+    {
+      best_num_terms = num_terms;
+      best_polarity = polarity;
+    }
+  }
+
+  return best_polarity;
+}
+
+/*! \brief Computes a minimum FPRM representation for a function
+
+  \param tt Truth table
+*/
+template<typename TT>
+inline esop_t esop_from_optimum_fprm( const TT& tt )
+{
+  return esop_from_fprm( tt, optimum_fprm_polarity( tt ) );
+}
+
+} // namespace esop
+
+} // namespace easy
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
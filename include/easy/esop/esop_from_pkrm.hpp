@@ -35,9 +35,15 @@
 
 #include <easy/esop/esop.hpp>
 #include <easy/esop/cube_manipulators.hpp>
+#include <easy/utils/stopwatch.hpp>
+#include <easy/utils/trace.hpp>
 #include <kitty/hash.hpp>
 #include <kitty/operations.hpp>
 #include <kitty/operators.hpp>
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -58,6 +64,25 @@ enum class pkrm_decomposition
 template<typename TT>
 using expansion_cache = std::unordered_map<TT, std::pair<uint32_t, pkrm_decomposition>, kitty::hash<TT>>;
 
+/* drops the most expensive of the three subfunctions */
+inline std::pair<uint32_t, pkrm_decomposition> select_pkrm_decomposition( uint32_t ex0, uint32_t ex1, uint32_t ex2 )
+{
+  const auto ex_max = std::max( std::max( ex0, ex1 ), ex2 );
+
+  if ( ex_max == ex0 )
+  {
+    return {ex1 + ex2, pkrm_decomposition::positive_davio};
+  }
+  else if ( ex_max == ex1 )
+  {
+    return {ex0 + ex2, pkrm_decomposition::negative_davio};
+  }
+  else
+  {
+    return {ex0 + ex1, pkrm_decomposition::shannon};
+  }
+}
+
 template<typename TT>
 inline uint32_t find_pkrm_expansions( const TT& tt, expansion_cache<TT>& cache, uint8_t var_index )
 {
@@ -85,28 +110,9 @@ inline uint32_t find_pkrm_expansions( const TT& tt, expansion_cache<TT>& cache,
   const auto ex1 = find_pkrm_expansions( tt1, cache, var_index + 1 );
   const auto ex2 = find_pkrm_expansions( tt0 ^ tt1, cache, var_index + 1 );
 
-  const auto ex_max = std::max( std::max( ex0, ex1 ), ex2 );
-
-  uint32_t cost{};
-  pkrm_decomposition decomp;
-
-  if ( ex_max == ex0 )
-  {
-    cost = ex1 + ex2;
-    decomp = pkrm_decomposition::positive_davio;
-  }
-  else if ( ex_max == ex1 )
-  {
-    cost = ex0 + ex2;
-    decomp = pkrm_decomposition::negative_davio;
-  }
-  else
-  {
-    cost = ex0 + ex1;
-    decomp = pkrm_decomposition::shannon;
-  }
-  cache.insert( {tt, {cost, decomp}} );
-  return cost;
+  const auto p = select_pkrm_decomposition( ex0, ex1, ex2 );
+  cache.insert( {tt, p} );
+  return p.first;
 }
 
 template<typename TT>
@@ -119,7 +125,7 @@ inline void optimum_pkrm_rec( std::unordered_set<kitty::cube, kitty::hash<kitty:
   }
   if ( is_const0( ~tt ) )
   {
-    add_to_cubes( pkrm, c );
+    add_to_cubes( pkrm, c, true, tt.num_vars() );
     return;
   }
 
@@ -144,6 +150,324 @@ inline void optimum_pkrm_rec( std::unordered_set<kitty::cube, kitty::hash<kitty:
     break;
   }
 }
+
+/* expansion cache split into independently locked shards */
+template<typename TT>
+class sharded_expansion_cache
+{
+public:
+  explicit sharded_expansion_cache( uint32_t num_shards )
+    : _shards( std::max( num_shards, 1u ) )
+  {
+  }
+
+  bool lookup( const TT& tt, std::pair<uint32_t, pkrm_decomposition>& p ) const
+  {
+    const auto& s = shard( tt );
+    std::lock_guard<std::mutex> lock( s.mutex );
+    const auto it = s.cache.find( tt );
+    if ( it == s.cache.end() )
+    {
+      return false;
+    }
+    p = it->second;
+    return true;
+  }
+
+  void insert( const TT& tt, const std::pair<uint32_t, pkrm_decomposition>& p )
+  {
+    auto& s = shard( tt );
+    std::lock_guard<std::mutex> lock( s.mutex );
+    s.cache.insert( {tt, p} );
+  }
+
+  uint64_t size() const
+  {
+    uint64_t size = 0u;
+    for ( const auto& s : _shards )
+    {
+      size += s.cache.size();
+    }
+    return size;
+  }
+
+  uint64_t num_evictions() const
+  {
+    return 0u;
+  }
+
+private:
+  struct cache_shard
+  {
+    mutable std::mutex mutex;
+    expansion_cache<TT> cache;
+  };
+
+  cache_shard& shard( const TT& tt )
+  {
+    return _shards[kitty::hash<TT>{}( tt ) % _shards.size()];
+  }
+
+  const cache_shard& shard( const TT& tt ) const
+  {
+    return _shards[kitty::hash<TT>{}( tt ) % _shards.size()];
+  }
+
+private:
+  std::vector<cache_shard> _shards;
+};
+
+/* 64-bit fingerprint of a truth table */
+template<typename TT>
+inline uint64_t truth_table_fingerprint( const TT& tt )
+{
+  uint64_t h = 0x9e3779b97f4a7c15ull ^ tt.num_vars();
+  for ( auto it = tt.cbegin(); it != tt.cend(); ++it )
+  {
+    /* splitmix64 finalizer on each word */
+    uint64_t z = h + *it + 0x9e3779b97f4a7c15ull;
+    z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ull;
+    z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebull;
+    h = z ^ ( z >> 31 );
+  }
+  return h;
+}
+
+/* memory-bounded expansion cache
+ *
+ * Set-associative table of `capacity` entries with CLOCK replacement
+ * inside each set.  Keys are stored as 64-bit fingerprints instead of
+ * truth tables.  A fingerprint collision can only lead to a suboptimal
+ * decomposition choice, since every decomposition yields a valid
+ * expansion.  Sets are protected by striped locks.
+ */
+template<typename TT>
+class bounded_expansion_cache
+{
+public:
+  static constexpr uint32_t num_ways = 8u;
+  static constexpr uint32_t num_locks = 64u;
+
+public:
+  explicit bounded_expansion_cache( uint64_t capacity )
+    : _num_sets( std::max<uint64_t>( 1u, capacity / num_ways ) ),
+      _entries( _num_sets * num_ways ),
+      _hands( _num_sets, 0u ),
+      _locks( num_locks )
+  {
+  }
+
+  bool lookup( const TT& tt, std::pair<uint32_t, pkrm_decomposition>& p ) const
+  {
+    const auto key = truth_table_fingerprint( tt );
+    const auto set = key % _num_sets;
+    std::lock_guard<std::mutex> lock( _locks[set % num_locks] );
+
+    for ( auto i = set * num_ways; i < ( set + 1 ) * num_ways; ++i )
+    {
+      auto& e = _entries[i];
+      if ( e.valid && e.key == key )
+      {
+        e.referenced = true;
+        p = {e.cost, e.decomp};
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void insert( const TT& tt, const std::pair<uint32_t, pkrm_decomposition>& p )
+  {
+    const auto key = truth_table_fingerprint( tt );
+    const auto set = key % _num_sets;
+    std::lock_guard<std::mutex> lock( _locks[set % num_locks] );
+
+    const auto first = set * num_ways;
+
+    /* update or fill a free way */
+    for ( auto i = first; i < first + num_ways; ++i )
+    {
+      auto& e = _entries[i];
+      if ( !e.valid || e.key == key )
+      {
+        e = {key, p.first, p.second, true, true};
+        return;
+      }
+    }
+
+    /* CLOCK: skip referenced ways, clearing their reference bit */
+    auto& hand = _hands[set];
+    while ( _entries[first + hand].referenced )
+    {
+      _entries[first + hand].referenced = false;
+      hand = ( hand + 1u ) % num_ways;
+    }
+    _entries[first + hand] = {key, p.first, p.second, true, true};
+    hand = ( hand + 1u ) % num_ways;
+    ++_num_evictions;
+  }
+
+  uint64_t size() const
+  {
+    return std::count_if( _entries.begin(), _entries.end(), []( const auto& e ) { return e.valid; } );
+  }
+
+  uint64_t num_evictions() const
+  {
+    return _num_evictions;
+  }
+
+private:
+  struct entry
+  {
+    uint64_t key{0};
+    uint32_t cost{0};
+    pkrm_decomposition decomp{pkrm_decomposition::positive_davio};
+    bool valid{false};
+    mutable bool referenced{false};
+  };
+
+  uint64_t _num_sets;
+  mutable std::vector<entry> _entries;
+  std::vector<uint8_t> _hands;
+  mutable std::vector<std::mutex> _locks;
+  std::atomic<uint64_t> _num_evictions{0};
+};
+
+struct pkrm_counters
+{
+  std::atomic<uint64_t> cache_hits{0};
+  std::atomic<uint64_t> cache_misses{0};
+  std::atomic<uint64_t> num_tasks{0};
+};
+
+template<typename TT, typename Cache>
+inline std::pair<uint32_t, pkrm_decomposition> find_pkrm_expansions_parallel( const TT& tt, Cache& cache, uint8_t var_index, uint32_t depth, uint32_t fork_depth, pkrm_counters& counters )
+{
+  /* terminal cases */
+  if ( is_const0( tt ) )
+  {
+    return {0, pkrm_decomposition::positive_davio};
+  }
+  if ( is_const0( ~tt ) )
+  {
+    return {1, pkrm_decomposition::positive_davio};
+  }
+
+  /* already computed */
+  std::pair<uint32_t, pkrm_decomposition> p;
+  if ( cache.lookup( tt, p ) )
+  {
+    ++counters.cache_hits;
+    return p;
+  }
+  ++counters.cache_misses;
+
+  const auto tt0 = cofactor0( tt, var_index );
+  const auto tt1 = cofactor1( tt, var_index );
+  const auto tt2 = tt0 ^ tt1;
+
+  uint32_t ex0, ex1, ex2;
+  if ( depth < fork_depth )
+  {
+    /* fork two subproblems, solve the third one in this thread */
+    counters.num_tasks += 2u;
+    auto f0 = std::async( std::launch::async, [&]() {
+        utils::trace_span span( "pkrm::expansions_task", "esop" );
+        return find_pkrm_expansions_parallel( tt0, cache, var_index + 1, depth + 1, fork_depth, counters ).first;
+      } );
+    auto f1 = std::async( std::launch::async, [&]() {
+        utils::trace_span span( "pkrm::expansions_task", "esop" );
+        return find_pkrm_expansions_parallel( tt1, cache, var_index + 1, depth + 1, fork_depth, counters ).first;
+      } );
+    ex2 = find_pkrm_expansions_parallel( tt2, cache, var_index + 1, depth + 1, fork_depth, counters ).first;
+    ex0 = f0.get();
+    ex1 = f1.get();
+  }
+  else
+  {
+    ex0 = find_pkrm_expansions_parallel( tt0, cache, var_index + 1, depth + 1, fork_depth, counters ).first;
+    ex1 = find_pkrm_expansions_parallel( tt1, cache, var_index + 1, depth + 1, fork_depth, counters ).first;
+    ex2 = find_pkrm_expansions_parallel( tt2, cache, var_index + 1, depth + 1, fork_depth, counters ).first;
+  }
+
+  p = select_pkrm_decomposition( ex0, ex1, ex2 );
+  cache.insert( tt, p );
+  return p;
+}
+
+template<typename TT, typename Cache>
+inline void optimum_pkrm_rec_parallel( std::unordered_set<kitty::cube, kitty::hash<kitty::cube>>& pkrm, const TT& tt, Cache& cache, uint8_t var_index, const kitty::cube& c,
+                                       uint32_t depth, uint32_t fork_depth, pkrm_counters& counters )
+{
+  /* terminal cases */
+  if ( is_const0( tt ) )
+  {
+    return;
+  }
+  if ( is_const0( ~tt ) )
+  {
+    add_to_cubes( pkrm, c, true, tt.num_vars() );
+    return;
+  }
+
+  /* recompute the decomposition if it has been evicted */
+  std::pair<uint32_t, pkrm_decomposition> p;
+  if ( !cache.lookup( tt, p ) )
+  {
+    p = find_pkrm_expansions_parallel( tt, cache, var_index, fork_depth, fork_depth, counters );
+  }
+
+  const auto tt0 = cofactor0( tt, var_index );
+  const auto tt1 = cofactor1( tt, var_index );
+
+  /* the two subfunctions of the chosen decomposition with their cubes */
+  auto sub0 = tt0;
+  auto sub1 = tt1;
+  kitty::cube c0, c1;
+  switch ( p.second )
+  {
+  case pkrm_decomposition::positive_davio:
+    c0 = c;
+    sub1 = tt0 ^ tt1;
+    c1 = with_literal( c, var_index, true );
+    break;
+  case pkrm_decomposition::negative_davio:
+    sub0 = tt1;
+    c0 = c;
+    sub1 = tt0 ^ tt1;
+    c1 = with_literal( c, var_index, false );
+    break;
+  case pkrm_decomposition::shannon:
+    c0 = with_literal( c, var_index, false );
+    c1 = with_literal( c, var_index, true );
+    break;
+  }
+
+  if ( depth < fork_depth )
+  {
+    /* fork one subproblem into a cube set of its own and merge it afterwards */
+    ++counters.num_tasks;
+    std::unordered_set<kitty::cube, kitty::hash<kitty::cube>> forked;
+    auto f = std::async( std::launch::async, [&]() {
+        utils::trace_span span( "pkrm::cubes_task", "esop" );
+        optimum_pkrm_rec_parallel( forked, sub1, cache, var_index + 1, c1, depth + 1, fork_depth, counters );
+      } );
+    optimum_pkrm_rec_parallel( pkrm, sub0, cache, var_index + 1, c0, depth + 1, fork_depth, counters );
+    f.get();
+
+    for ( const auto& cube : forked )
+    {
+      add_to_cubes( pkrm, cube, true, tt.num_vars() );
+    }
+  }
+  else
+  {
+    optimum_pkrm_rec_parallel( pkrm, sub0, cache, var_index + 1, c0, depth + 1, fork_depth, counters );
+    optimum_pkrm_rec_parallel( pkrm, sub1, cache, var_index + 1, c1, depth + 1, fork_depth, counters );
+  }
+}
+
 } // namespace detail
 /*! \endcond */
 
@@ -162,8 +486,113 @@ inline esop_t esop_from_optimum_pkrm( const TT& tt )
   std::unordered_set<kitty::cube, kitty::hash<kitty::cube>> cubes;
   detail::expansion_cache<TT> cache;
 
-  detail::find_pkrm_expansions( tt, cache, 0 );
-  detail::optimum_pkrm_rec( cubes, tt, cache, 0, kitty::cube() );
+  {
+    utils::trace_span span( "pkrm::expansions", "esop" );
+    detail::find_pkrm_expansions( tt, cache, 0 );
+  }
+  {
+    utils::trace_span span( "pkrm::cubes", "esop" );
+    detail::optimum_pkrm_rec( cubes, tt, cache, 0, kitty::cube() );
+  }
+
+  return esop_t( cubes.begin(), cubes.end() );
+}
+
+struct pkrm_params
+{
+  /*! \brief Number of threads (1 runs sequentially) */
+  uint32_t num_threads{1u};
+
+  /*! \brief Number of shards of the expansion cache */
+  uint32_t num_shards{64u};
+
+  /*! \brief Maximum number of expansion cache entries (0 for unbounded)
+   *
+   * A bounded cache stores 64-bit fingerprints instead of truth tables
+   * and evicts entries with the CLOCK policy; evicted subfunctions are
+   * recomputed when needed.
+   */
+  uint64_t cache_capacity{0u};
+};
+
+struct pkrm_statistics
+{
+  /*! \brief Expansion cache hits */
+  uint64_t cache_hits{0};
+
+  /*! \brief Expansion cache misses, i.e., computed subfunctions */
+  uint64_t cache_misses{0};
+
+  /*! \brief Expansion cache evictions */
+  uint64_t cache_evictions{0};
+
+  /*! \brief Number of forked tasks */
+  uint64_t num_tasks{0};
+
+  /*! \brief Total time */
+  utils::stopwatch<>::duration time_total{0};
+};
+
+/*! \brief Computes ESOP representation using optimum PKRM in parallel
+
+  Task-parallel variant of `esop_from_optimum_pkrm`.  Both the cost
+  computation and the cube construction fork their independent
+  subproblems up to a cutoff depth, chosen such that about
+  `num_threads` tasks run concurrently.  The cost computation shares a
+  sharded expansion cache, or a memory-bounded one if `cache_capacity`
+  is set; forked cube constructions collect their cubes in sets of their
+  own, which are merged afterwards.
+
+  \param tt Truth table
+  \param ps Parameters
+  \param st Statistics
+*/
+template<typename TT>
+inline esop_t esop_from_optimum_pkrm( const TT& tt, const pkrm_params& ps, pkrm_statistics& st )
+{
+  utils::stopwatch t( st.time_total );
+
+  /* the cost computation forks 3 ways per level, the cube construction 2 ways */
+  uint32_t fork_depth = 0u;
+  for ( uint64_t tasks = 1u; tasks < ps.num_threads; tasks *= 3u )
+  {
+    ++fork_depth;
+  }
+  uint32_t rec_fork_depth = 0u;
+  for ( uint64_t tasks = 1u; tasks < ps.num_threads; tasks *= 2u )
+  {
+    ++rec_fork_depth;
+  }
+
+  std::unordered_set<kitty::cube, kitty::hash<kitty::cube>> cubes;
+  detail::pkrm_counters counters;
+
+  const auto run = [&]( auto& cache ) {
+    {
+      utils::trace_span span( "pkrm::expansions", "esop" );
+      detail::find_pkrm_expansions_parallel( tt, cache, 0, 0u, fork_depth, counters );
+    }
+    {
+      utils::trace_span span( "pkrm::cubes", "esop" );
+      detail::optimum_pkrm_rec_parallel( cubes, tt, cache, 0, kitty::cube(), 0u, rec_fork_depth, counters );
+    }
+    st.cache_evictions += cache.num_evictions();
+  };
+
+  if ( ps.cache_capacity == 0u )
+  {
+    detail::sharded_expansion_cache<TT> cache( ps.num_shards );
+    run( cache );
+  }
+  else
+  {
+    detail::bounded_expansion_cache<TT> cache( ps.cache_capacity );
+    run( cache );
+  }
+
+  st.cache_hits += counters.cache_hits;
+  st.cache_misses += counters.cache_misses;
+  st.num_tasks += counters.num_tasks;
 
   return esop_t( cubes.begin(), cubes.end() );
 }
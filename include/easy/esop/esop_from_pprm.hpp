@@ -34,10 +34,7 @@
 #pragma once
 
 #include <easy/esop/esop.hpp>
-#include <easy/esop/cube_manipulators.hpp>
-#include <kitty/cube.hpp>
-
-#include <unordered_set>
+#include <easy/esop/esop_from_fprm.hpp>
 
 namespace easy
 {
@@ -45,49 +42,19 @@ namespace easy
 namespace esop
 {
 
-/*! \cond PRIVATE */
-namespace detail
-{
-
-template<typename TT>
-inline void esop_from_pprm_rec( std::unordered_set<kitty::cube, kitty::hash<kitty::cube>>& cubes, const TT& tt, uint8_t var_index, const kitty::cube& c )
-{
-  /* terminal cases */
-  if ( is_const0( tt ) )
-  {
-    return;
-  }
-  if ( is_const0( ~tt ) )
-  {
-    /* add to cubes, but do not apply distance-1 merging */
-    add_to_cubes( cubes, c, false );
-    return;
-  }
-
-  const auto tt0 = cofactor0( tt, var_index );
-  const auto tt1 = cofactor1( tt, var_index );
-
-  esop_from_pprm_rec( cubes, tt0, var_index + 1, c );
-  esop_from_pprm_rec( cubes, tt0 ^ tt1, var_index + 1, with_literal( c, var_index, true ) );
-}
-
-} // namespace detail
-/*! \endcond */
-
 /*! \brief Computes PPRM representation for a function
 
-  This algorithm applies recursively the positive Davio decomposition which
-  eventually leads into the PPRM representation of a function.
+  This algorithm applies the positive Davio decomposition to all
+  variables, implemented as an in-place word-level Reed-Muller butterfly
+  over the truth table, which leads into the PPRM representation of a
+  function.
 
   \param tt Truth table
 */
 template<typename TT>
 inline esop_t esop_from_pprm( const TT& tt )
 {
-  std::unordered_set<kitty::cube, kitty::hash<kitty::cube>> cubes;
-  detail::esop_from_pprm_rec( cubes, tt, 0, kitty::cube() );
-
-  return esop_t( cubes.begin(), cubes.end() );
+  return esop_from_fprm( tt, 0u );
 }
 
 } // namespace esop
@@ -142,7 +142,7 @@ inline esops_t exact_synthesis_from_binary_string( const std::string& bits, cons
 
     if ( dump )
     {
-      const std::string filename = fmt::format( "0x%s-%d.cnf", utils::hex_string_from_binary_string( bits ), k );
+      const std::string filename = fmt::format( "0x{}-{}.cnf", utils::hex_string_from_binary_string( bits ), k );
       std::cout << "[i] write CNF file " << filename << std::endl;
       std::ofstream os( filename );
       {
@@ -209,7 +209,7 @@ inline esops_t exact_synthesis_from_binary_string( const std::string& bits, cons
         return {esop};
       }
 
-      std::sort( esop.begin(), esop.end(), cube_weight_compare( num_vars ) );
+      sort_by_cube_weight( esop, num_vars );
       esops.push_back( esop );
 
       /* add one blocking clause for each possible permutation of the cubes */
@@ -28,9 +28,12 @@
 #include <easy/sat2/maxsat.hpp>
 #include <easy/sat2/cnf_from_xcnf.hpp>
 #include <easy/utils/dynamic_bitset.hpp>
+#include <easy/utils/stopwatch.hpp>
+#include <easy/utils/trace.hpp>
 
 #include <map>
 #include <unordered_map>
+#include <unordered_set>
 #include <cstdlib>
 
 namespace easy::esop
@@ -56,7 +59,7 @@ inline int32_t get_lowest_set_bit( int32_t num )
 #endif
 }
 
-std::vector<uint32_t> compute_flips( uint32_t n )
+inline std::vector<uint32_t> compute_flips( uint32_t n )
 {
   auto const size = ( 1u << n );
   auto const total_flips = size - 1;
@@ -74,7 +77,7 @@ std::vector<uint32_t> compute_flips( uint32_t n )
   return flip_vec;
 }
 
-std::vector<kitty::cube> compute_implicants( const kitty::cube& c, uint32_t num_vars )
+inline std::vector<kitty::cube> compute_implicants( const kitty::cube& c, uint32_t num_vars )
 {
   const auto flips = compute_flips( num_vars );
 
@@ -199,7 +202,9 @@ void derive_xor_clauses( std::vector<std::vector<int>>& xor_clauses, helliwell_d
   } while ( minterm._bits < ( 1u << bits.num_vars() ) );
 }
 
-esop_t esop_from_model( sat2::model const& m, helliwell_decision_variables const& g )
+/* Model is either sat2::model or sat2::model_view */
+template<typename Model>
+inline esop_t esop_from_model( Model const& m, helliwell_decision_variables const& g )
 {
   esop_t esop;
   for ( const auto& v : g )
@@ -212,7 +217,7 @@ esop_t esop_from_model( sat2::model const& m, helliwell_decision_variables const
   return esop;
 }
 
-esop_t esop_from_clause_selectors( std::vector<int> const& sels, helliwell_decision_variables const& g, std::unordered_map<int,int> soft_clause_map )
+inline esop_t esop_from_clause_selectors( std::vector<int> const& sels, helliwell_decision_variables const& g, std::unordered_map<int,int> soft_clause_map )
 {
   esop_t esop;
   for ( const auto& s : sels )
@@ -222,7 +227,39 @@ esop_t esop_from_clause_selectors( std::vector<int> const& sels, helliwell_decis
   return esop;
 }
 
-std::vector<std::vector<int>> translate_to_cnf( int& sid, std::vector<std::vector<int>> const& xcnf, uint32_t num_vars )
+/*! \brief Translates an ESOP into an assignment of the decision variables
+ *
+ * Cubes that do not correspond to a decision variable are ignored.
+ * A cube that appears an even number of times cancels out.
+ */
+inline std::vector<int> assignment_from_esop( esop_t const& esop, helliwell_decision_variables const& g )
+{
+  std::unordered_set<kitty::cube, kitty::hash<kitty::cube>> cubes;
+  for ( auto c : esop )
+  {
+    /* normalize the cube */
+    c._bits &= c._mask;
+
+    auto const it = cubes.find( c );
+    if ( it == cubes.end() )
+    {
+      cubes.insert( c );
+    }
+    else
+    {
+      cubes.erase( it );
+    }
+  }
+
+  std::vector<int> lits;
+  for ( const auto& v : g )
+  {
+    lits.emplace_back( cubes.find( v.second ) != cubes.end() ? v.first : -v.first );
+  }
+  return lits;
+}
+
+inline std::vector<std::vector<int>> translate_to_cnf( int& sid, std::vector<std::vector<int>> const& xcnf, uint32_t num_vars )
 {
   return sat2::cnf_from_xcnf( sid, xcnf, num_vars ).get();
 }
@@ -233,10 +270,46 @@ struct helliwell_maxsat {};
 
 struct helliwell_maxsat_statistics
 {
+  /*! \brief Number of variables */
+  uint64_t num_variables{0};
+
+  /*! \brief Number of clauses */
+  uint64_t num_clauses{0};
+
+  /*! \brief Number of XOR-clauses before the elimination */
+  uint64_t num_xor_clauses{0};
+
+  /*! \brief Number of XOR-clauses after the elimination */
+  uint64_t num_xor_clauses_gauss{0};
+
+  /*! \brief Encoding time */
+  utils::stopwatch<>::duration time_encode{0};
+
+  /*! \brief Solving time */
+  utils::stopwatch<>::duration time_solve{0};
+
+  /*! \brief Statistics of the MAXSAT-solver */
+  sat2::maxsat_solver_statistics maxsat;
+
+  /*! \brief Exports the statistics as JSON */
+  nlohmann::json to_json() const
+  {
+    return nlohmann::json{
+      {"num_variables", num_variables},
+      {"num_clauses", num_clauses},
+      {"num_xor_clauses", num_xor_clauses},
+      {"num_xor_clauses_gauss", num_xor_clauses_gauss},
+      {"time_encode", utils::to_seconds( time_encode )},
+      {"time_solve", utils::to_seconds( time_solve )},
+      {"maxsat", maxsat.to_json()},
+    };
+  }
 };
 
 struct helliwell_maxsat_params
 {
+  /*! \brief Parameters of the MAXSAT-solver */
+  sat2::maxsat_solver_params maxsat;
 };
 
 template<typename TT, typename Solver>
@@ -249,7 +322,8 @@ public:
   explicit esop_from_tt( helliwell_maxsat_statistics& stats, helliwell_maxsat_params& ps )
     : _stats( stats )
     , _ps( ps )
-    , _solver( _maxsat_stats, _maxsat_ps, _sid )
+    , _maxsat_ps( ps.maxsat )
+    , _solver( _stats.maxsat, _maxsat_ps, _sid )
   {}
 
   /*! \brief Synthesizes an ESOP form from an incompletely-specified Boolean function
@@ -263,14 +337,25 @@ public:
 
     detail::helliwell_decision_variables g( _sid );
 
-    /* derive 2^n constraints in 3^n variables */
-    std::vector<std::vector<int>> xor_clauses;
-    detail::derive_xor_clauses( xor_clauses, g, bits, care );
-
-    /* apply gause algorithm to translate XOR-clauses to clauses */
-    for ( const auto& c : detail::translate_to_cnf( _sid, xor_clauses, g.size() ) )
     {
-      _solver.add_clause( c );
+      utils::trace_span span( "helliwell::encoding", "esop" );
+      utils::stopwatch t( _stats.time_encode );
+
+      /* derive 2^n constraints in 3^n variables */
+      std::vector<std::vector<int>> xor_clauses;
+      detail::derive_xor_clauses( xor_clauses, g, bits, care );
+
+      /* apply gause algorithm to translate XOR-clauses to clauses */
+      sat2::cnf_from_xcnf cnf( _sid, xor_clauses, g.size() );
+      auto const clauses = cnf.get();
+      for ( const auto& c : clauses )
+      {
+        _solver.add_clause( c );
+      }
+
+      _stats.num_xor_clauses += cnf.num_xor_clauses();
+      _stats.num_xor_clauses_gauss += cnf.num_translated_xor_clauses();
+      _stats.num_clauses += clauses.size();
     }
 
     /* add soft clauses and remember how they map onto g */
@@ -281,8 +366,19 @@ public:
       soft_clause_map.insert( std::make_pair( cid, v.first ) );
     }
 
+    /* seed the solver with the initial solution */
+    if ( !_warm_start.empty() )
+    {
+      _solver.warm_start( detail::assignment_from_esop( _warm_start, g ) );
+    }
+
+    _stats.num_variables = std::max<uint64_t>( _stats.num_variables, _sid - 1 );
+
     /* extract the esop from the model */
-    auto const state = _solver.solve();
+    auto const state = [&]() {
+      utils::stopwatch t( _stats.time_solve );
+      return _solver.solve();
+    }();
     if ( state == maxsat_solver_t::state::success )
     {
       auto const clause_selectors = _solver.get_disabled_clauses();
@@ -294,6 +390,20 @@ public:
     }
   }
 
+  /*! \brief Warm-starts the synthesis from a known ESOP form
+   *
+   * The ESOP form, e.g., obtained with a heuristic, is used to seed
+   * the phases of the solver and serves as initial upper bound of the
+   * costs.  An ESOP form that does not implement the function is
+   * ignored.
+   *
+   * \param esop An ESOP form
+   */
+  void warm_start( esop_t const& esop )
+  {
+    _warm_start = esop;
+  }
+
   /*! \brief Synthesizes an ESOP form from a completely-specified Boolean function
    *
    * \param bits Truth table of function
@@ -309,15 +419,51 @@ protected:
   helliwell_maxsat_params const& _ps;
 
   int _sid = 1;
+  esop_t _warm_start;
 
-  sat2::maxsat_solver_statistics _maxsat_stats;
   sat2::maxsat_solver_params _maxsat_ps;
   maxsat_solver_t _solver;
 }; /* esop_from_tt */
 
 struct helliwell_sat {};
 
-struct helliwell_sat_statistics {};
+struct helliwell_sat_statistics
+{
+  /*! \brief Number of variables */
+  uint64_t num_variables{0};
+
+  /*! \brief Number of clauses */
+  uint64_t num_clauses{0};
+
+  /*! \brief Number of XOR-clauses before the elimination */
+  uint64_t num_xor_clauses{0};
+
+  /*! \brief Number of XOR-clauses after the elimination */
+  uint64_t num_xor_clauses_gauss{0};
+
+  /*! \brief Encoding time */
+  utils::stopwatch<>::duration time_encode{0};
+
+  /*! \brief Solving time */
+  utils::stopwatch<>::duration time_solve{0};
+
+  /*! \brief Statistics of the SAT-solver */
+  sat2::sat_solver_statistics sat;
+
+  /*! \brief Exports the statistics as JSON */
+  nlohmann::json to_json() const
+  {
+    return nlohmann::json{
+      {"num_variables", num_variables},
+      {"num_clauses", num_clauses},
+      {"num_xor_clauses", num_xor_clauses},
+      {"num_xor_clauses_gauss", num_xor_clauses_gauss},
+      {"time_encode", utils::to_seconds( time_encode )},
+      {"time_solve", utils::to_seconds( time_solve )},
+      {"sat", sat.to_json()},
+    };
+  }
+};
 
 struct helliwell_sat_params {};
 
@@ -328,7 +474,7 @@ public:
   explicit esop_from_tt( helliwell_sat_statistics& stats, helliwell_sat_params& ps )
     : _stats( stats )
     , _ps( ps )
-    , _solver( _sat_stats, _sat_ps )
+    , _solver( _stats.sat, _sat_ps )
   {}
 
   /*! \brief Synthesizes an ESOP form from an incompletely-specified Boolean function
@@ -342,21 +488,37 @@ public:
 
     detail::helliwell_decision_variables g( _sid );
 
-    /* derive 2^n constraints in 3^n variables */
-    std::vector<std::vector<int>> xor_clauses;
-    detail::derive_xor_clauses( xor_clauses, g, bits, care );
-
-    /* apply gause algorithm to translate XOR-clauses to clauses */
-    for ( const auto& c : detail::translate_to_cnf( _sid, xor_clauses, g.size() ) )
     {
-      _solver.add_clause( c );
+      utils::trace_span span( "helliwell::encoding", "esop" );
+      utils::stopwatch t( _stats.time_encode );
+
+      /* derive 2^n constraints in 3^n variables */
+      std::vector<std::vector<int>> xor_clauses;
+      detail::derive_xor_clauses( xor_clauses, g, bits, care );
+
+      /* apply gause algorithm to translate XOR-clauses to clauses */
+      sat2::cnf_from_xcnf cnf( _sid, xor_clauses, g.size() );
+      auto const clauses = cnf.get();
+      for ( const auto& c : clauses )
+      {
+        _solver.add_clause( c );
+      }
+
+      _stats.num_xor_clauses += cnf.num_xor_clauses();
+      _stats.num_xor_clauses_gauss += cnf.num_translated_xor_clauses();
+      _stats.num_clauses += clauses.size();
     }
 
+    _stats.num_variables = std::max<uint64_t>( _stats.num_variables, _sid - 1 );
+
     /* extract the esop from the model */
-    auto const state = _solver.solve();
+    auto const state = [&]() {
+      utils::stopwatch t( _stats.time_solve );
+      return _solver.solve();
+    }();
     if ( state == sat2::sat_solver::state::sat )
     {
-      auto const model = _solver.get_model();
+      auto const model = _solver.get_model_view();
       assert( model.size() != 0 );
       return detail::esop_from_model( model, g );
     }
@@ -382,7 +544,6 @@ protected:
 
   int _sid = 1;
 
-  sat2::sat_solver_statistics _sat_stats;
   sat2::sat_solver_params _sat_ps;
   sat2::sat_solver _solver;
 }; /* esop_from_tt */
@@ -0,0 +1,302 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <easy/esop/synthesis.hpp>
+#include <easy/sat2/sat_solver.hpp>
+
+#include <unordered_map>
+
+namespace easy::esop
+{
+
+struct incremental_synthesizer_params
+{
+  /*! Conflict limit per call to synthesize (-1 indicates no conflict limit) */
+  int conflict_limit = -1;
+}; /* incremental_synthesizer_params */
+
+/*! \brief Incremental ESOP synthesizer
+ *
+ * Synthesizes a $k$-ESOP for a specification that changes over time.
+ *
+ * In contrast to simple_synthesizer, the specification is not encoded
+ * as a whole.  For each minterm, the synthesizer defines a literal
+ * that is true if and only if an odd number of terms contain the
+ * minterm.  The definitions do not restrict the terms and are added
+ * once, when a minterm is set for the first time.  The value of a
+ * care minterm is enforced by assuming its literal; don't-care
+ * minterms are not assumed.  Hence, updates of the specification do
+ * not require re-encoding and the SAT-solver keeps its learnt clauses
+ * between calls.
+ *
+ * Example:
+ *   incremental_synthesizer synthesizer( 3, 2 );
+ *   synthesizer.set_minterm( 3, '1' );
+ *   synthesizer.set_minterm( 5, '0' );
+ *   auto const r1 = synthesizer.synthesize();
+ *   synthesizer.set_minterm( 5, '-' );
+ *   auto const r2 = synthesizer.synthesize();
+ */
+class incremental_synthesizer
+{
+public:
+  /*! \brief constructor
+   *
+   * Creates an incremental ESOP synthesizer.  Initially, all minterms
+   * are don't cares.
+   *
+   * \param num_vars Number of variables
+   * \param num_terms Number of product terms
+   */
+  incremental_synthesizer( uint32_t num_vars, uint32_t num_terms )
+      : _num_vars( num_vars )
+      , _num_terms( num_terms )
+      , _spec{std::string( 1ull << num_vars, '0' ), std::string( 1ull << num_vars, '0' )}
+      , _solver( _sat_stats, _sat_ps )
+      , _sid( 1 + 2 * num_vars * num_terms )
+  {
+    assert( num_vars <= 32 && "cube data structure cannot store more than 32 variables" );
+    assert( num_terms >= 1 );
+  }
+
+  /*! \brief set_minterm
+   *
+   * Updates the value of a minterm.
+   *
+   * \param index Index of the minterm
+   * \param value '0' or '1' for care minterms, and '-' for don't cares
+   */
+  void set_minterm( uint64_t index, char value )
+  {
+    assert( index < _spec.bits.size() );
+    assert( value == '0' || value == '1' || value == '-' );
+
+    if ( value == '-' )
+    {
+      _spec.care[index] = '0';
+      return;
+    }
+
+    _spec.bits[index] = value;
+    _spec.care[index] = '1';
+    output_literal( index );
+  }
+
+  /*! \brief set_spec
+   *
+   * Updates all minterms according to a specification.
+   *
+   * \param spec Truth-table of a(n) (incompletely-specified) Boolean function
+   */
+  void set_spec( const spec& spec )
+  {
+    assert( spec.bits.size() == _spec.bits.size() );
+    assert( spec.care.size() == _spec.care.size() );
+
+    for ( auto i = 0u; i < spec.bits.size(); ++i )
+    {
+      const auto is_care = spec.care[i] == '1' && ( spec.bits[i] == '0' || spec.bits[i] == '1' );
+      set_minterm( i, is_care ? spec.bits[i] : '-' );
+    }
+  }
+
+  /*! \brief get_spec
+   *
+   * Returns the current specification.
+   */
+  const spec& get_spec() const
+  {
+    return _spec;
+  }
+
+  /*! \brief synthesize
+   *
+   * SAT-based ESOP synthesis for the current specification.
+   *
+   * \params params Parameters
+   * \return Synthesis result. If the specification is realizable and
+   *         the no resource limit is reached, the result contains an ESOP
+   *         that implements the specification.
+   */
+  result synthesize( const incremental_synthesizer_params& params = {} )
+  {
+    std::vector<int> assumptions;
+    for ( const auto& o : _outputs )
+    {
+      if ( _spec.care[o.first] == '1' )
+      {
+        assumptions.emplace_back( _spec.bits[o.first] == '1' ? o.second : -o.second );
+      }
+    }
+
+    if ( params.conflict_limit != -1 )
+    {
+      _solver.set_budget( params.conflict_limit );
+    }
+    else
+    {
+      _solver.reset_budget();
+    }
+
+    const auto state = _solver.solve( assumptions );
+    if ( state == sat2::sat_solver::state::sat )
+    {
+      return result( make_esop( _solver.get_model() ) );
+    }
+    else if ( state == sat2::sat_solver::state::unsat )
+    {
+      return result( unrealizable );
+    }
+    else
+    {
+      return result();
+    }
+  }
+
+private:
+  int p( uint32_t j, uint32_t l ) const
+  {
+    return 1 + _num_vars * j + l;
+  }
+
+  int q( uint32_t j, uint32_t l ) const
+  {
+    return 1 + _num_vars * _num_terms + _num_vars * j + l;
+  }
+
+  /*! \brief output_literal
+   *
+   * Returns the literal that is true if and only if an odd number of
+   * terms contains the minterm.  The defining clauses are added on the
+   * first call.
+   *
+   * \param index Index of the minterm
+   */
+  int output_literal( uint64_t index )
+  {
+    const auto it = _outputs.find( index );
+    if ( it != _outputs.end() )
+    {
+      return it->second;
+    }
+
+    /* z_j <-> term j contains the minterm */
+    std::vector<int> z_vars( _num_terms );
+    for ( auto j = 0u; j < _num_terms; ++j )
+    {
+      const int z = z_vars[j] = _sid++;
+
+      std::vector<int> clause = {z};
+      for ( auto l = 0u; l < _num_vars; ++l )
+      {
+        const int lit = ( ( index >> l ) & 1 ) ? q( j, l ) : p( j, l );
+        _solver.add_clause( {-z, -lit} );
+        clause.push_back( lit );
+      }
+      _solver.add_clause( clause );
+    }
+
+    /* Tseitin encoding of the XOR-chain over the z-variables */
+    int t = z_vars[0u];
+    for ( auto j = 1u; j < _num_terms; ++j )
+    {
+      const int z = z_vars[j];
+      const int y = _sid++;
+      _solver.add_clause( {-y, t, z} );
+      _solver.add_clause( {-y, -t, -z} );
+      _solver.add_clause( {y, -t, z} );
+      _solver.add_clause( {y, t, -z} );
+      t = y;
+    }
+
+    _outputs.emplace( index, t );
+    return t;
+  }
+
+  /*! \brief make_esop
+   *
+   * Extract the ESOP from a satisfying assignment.
+   *
+   * \param model Satisfying assignment
+   */
+  esop_t make_esop( const sat2::model& model ) const
+  {
+    esop_t esop;
+    for ( auto j = 0u; j < _num_terms; ++j )
+    {
+      kitty::cube c;
+      bool cancel_cube = false;
+      for ( auto l = 0u; l < _num_vars; ++l )
+      {
+        /* variables that do not occur in any clause are false */
+        const auto p_value = uint32_t( p( j, l ) ) <= model.size() && model[p( j, l )];
+        const auto q_value = uint32_t( q( j, l ) ) <= model.size() && model[q( j, l )];
+
+        if ( p_value && q_value )
+        {
+          cancel_cube = true;
+          break;
+        }
+        else if ( p_value )
+        {
+          c.add_literal( l, true );
+        }
+        else if ( q_value )
+        {
+          c.add_literal( l, false );
+        }
+      }
+
+      if ( !cancel_cube )
+      {
+        esop.push_back( c );
+      }
+    }
+    return esop;
+  }
+
+private:
+  const uint32_t _num_vars;
+  const uint32_t _num_terms;
+  spec _spec;
+
+  sat2::sat_solver_statistics _sat_stats;
+  sat2::sat_solver_params _sat_ps;
+  sat2::sat_solver _solver;
+  int _sid;
+
+  /* maps minterms to their output literal */
+  std::unordered_map<uint64_t, int> _outputs;
+}; /* incremental_synthesizer */
+
+} // namespace easy::esop
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
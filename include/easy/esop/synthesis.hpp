@@ -27,9 +27,18 @@
 
 #include <easy/esop/esop.hpp>
 #include <easy/esop/exact_synthesis.hpp>
+#include <easy/sat/cube_and_conquer.hpp>
 #include <easy/sat/gauss.hpp>
 #include <easy/sat/xor_clauses_to_cnf.hpp>
+#include <easy/utils/stopwatch.hpp>
+#include <easy/utils/trace.hpp>
 #include <json/json.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
 
 namespace easy::esop
 {
@@ -37,7 +46,9 @@ namespace easy::esop
 namespace detail
 {
 
-inline esop_t esop_from_model( const sat::sat_solver::model_t& model, unsigned num_terms, unsigned num_vars )
+/* Model is either sat::sat_solver::model_t or sat::sat_solver::model_view */
+template<typename Model>
+inline esop_t esop_from_model( const Model& model, unsigned num_terms, unsigned num_vars )
 {
   assert( !( num_terms > 0 ) || ( model.size() != 0 ) );
 
@@ -48,8 +59,8 @@ inline esop_t esop_from_model( const sat::sat_solver::model_t& model, unsigned n
     bool cancel_cube = false;
     for ( auto l = 0u; l < num_vars; ++l )
     {
-      const auto p_value = model[j * num_vars + l] == l_True;
-      const auto q_value = model[num_vars * num_terms + j * num_vars + l] == l_True;
+      const auto p_value = model[j * num_vars + l] == Glucose::l_True;
+      const auto q_value = model[num_vars * num_terms + j * num_vars + l] == Glucose::l_True;
 
       if ( p_value && q_value )
       {
@@ -113,6 +124,267 @@ struct result
   esop_t esop;
 }; /* result */
 
+namespace detail
+{
+
+/*! \brief Encodes the $k$-ESOP synthesis problem
+ *
+ * Adds the clauses and XOR-clauses of the SAT-encoding to the
+ * constraints.  The variables 1, ..., num_vars * num_terms are the
+ * p-variables, the subsequent num_vars * num_terms variables are the
+ * q-variables.
+ *
+ * \param constraints Constraints
+ * \param spec Truth-table of a(n) (incompletely-specified) Boolean function
+ * \param num_vars Number of variables
+ * \param num_terms Number of product terms
+ * \return Next free variable id
+ */
+inline int add_esop_constraints( sat::constraints& constraints, const spec& spec, uint32_t num_vars, uint32_t num_terms )
+{
+  int sid = 1 + 2 * num_vars * num_terms;
+
+  /* each care minterm adds num_terms * num_vars binary clauses and num_terms clauses with num_vars + 1 literals */
+  uint32_t num_samples = 0u;
+  for ( auto i = 0u; i < ( 1u << num_vars ); ++i )
+  {
+    num_samples += ( spec.bits[i] == '0' || spec.bits[i] == '1' ) && spec.care[i] == '1';
+  }
+  constraints.reserve_clauses( num_samples * num_terms * ( num_vars + 1 ), uint64_t( num_samples ) * num_terms * ( 3 * num_vars + 1 ) );
+
+  std::vector<int> clause;
+  kitty::cube minterm = kitty::cube::neg_cube( num_vars );
+
+  auto sample_counter = 0u;
+  do
+  {
+    /* skip don't cares */
+    if ( ( spec.bits[minterm._bits] != '0' && spec.bits[minterm._bits] != '1' ) || spec.care[minterm._bits] != '1' )
+    {
+      ++minterm._bits;
+      continue;
+    }
+
+    std::vector<int> z_vars( num_terms, 0u );
+    for ( auto j = 0u; j < num_terms; ++j )
+    {
+      assert( uint32_t(sid) == 1 + 2 * num_vars * num_terms + sample_counter * num_terms + j );
+      z_vars[j] = sid++;
+    }
+
+    for ( auto j = 0u; j < num_terms; ++j )
+    {
+      const int z = z_vars[j];
+
+      // positive
+      for ( auto l = 0u; l < num_vars; ++l )
+      {
+        if ( minterm.get_bit( l ) )
+        {
+          constraints.add_clause( {-z,                                                     // - z_j
+                                   -int( 1 + num_vars * num_terms + num_vars * j + l )} ); // -q_j,l
+        }
+        else
+        {
+          constraints.add_clause( {-z,                                // -z_j
+                                   -int( 1 + num_vars * j + l )} );   // -p_j,l
+        }
+      }
+    }
+
+    for ( auto j = 0u; j < num_terms; ++j )
+    {
+      const int z = z_vars[j];
+
+      // negative
+      clause.assign( 1u, z );
+      for ( auto l = 0u; l < num_vars; ++l )
+      {
+        if ( minterm.get_bit( l ) )
+        {
+          clause.push_back( 1 + num_vars * num_terms + num_vars * j + l ); // q_j,l
+        }
+        else
+        {
+          clause.push_back( 1 + num_vars * j + l ); // p_j,l
+        }
+      }
+
+      constraints.add_clause( clause );
+    }
+
+    constraints.add_xor_clause( z_vars, spec.bits[minterm._bits] == '1' );
+
+    ++sample_counter;
+    ++minterm._bits;
+  } while ( minterm._bits < ( 1u << num_vars ) );
+
+  return sid;
+}
+
+/*! \brief Seeds the phases of the p- and q-variables from an ESOP
+ *
+ * The j-th cube of the ESOP determines the phases of the j-th term.
+ * Terms without a corresponding cube are canceled.
+ *
+ * \param solver SAT-solver
+ * \param esop ESOP form with at most num_terms cubes
+ * \param num_vars Number of variables
+ * \param num_terms Number of product terms
+ */
+inline void set_esop_phases( sat::sat_solver& solver, const esop_t& esop, uint32_t num_vars, uint32_t num_terms )
+{
+  for ( auto j = 0u; j < num_terms; ++j )
+  {
+    for ( auto l = 0u; l < num_vars; ++l )
+    {
+      const int p = 1 + num_vars * j + l;
+      const int q = 1 + num_vars * num_terms + num_vars * j + l;
+
+      if ( j >= esop.size() )
+      {
+        /* cancel the term using its first variable */
+        solver.set_phase( l == 0 ? p : -p );
+        solver.set_phase( l == 0 ? q : -q );
+      }
+      else if ( esop[j].get_mask( l ) )
+      {
+        solver.set_phase( esop[j].get_bit( l ) ? p : -p );
+        solver.set_phase( esop[j].get_bit( l ) ? -q : q );
+      }
+      else
+      {
+        solver.set_phase( -p );
+        solver.set_phase( -q );
+      }
+    }
+  }
+}
+
+/*! \brief Encodes the $k$-ESOP synthesis problem as CNF
+ *
+ * Adds the ESOP constraints, simplifies the XOR-clauses with Gaussian
+ * elimination and translates the remaining XOR-clauses into clauses.
+ *
+ * \param constraints Constraints
+ * \param spec Specification
+ * \param num_vars Number of variables
+ * \param num_terms Number of product terms
+ * \return A json log with the size of the encoding and the time spent in each step
+ */
+inline nlohmann::json encode_esop_constraints( sat::constraints& constraints, const spec& spec, uint32_t num_vars, uint32_t num_terms )
+{
+  utils::trace_span span( "encoding", "esop" );
+
+  utils::stopwatch<>::duration time_encode{0};
+  utils::stopwatch<>::duration time_gauss{0};
+  nlohmann::json log;
+
+  int sid;
+  {
+    utils::stopwatch t( time_encode );
+    sid = add_esop_constraints( constraints, spec, num_vars, num_terms );
+  }
+  log["num_xor_clauses"] = constraints.num_xor_clauses();
+
+  {
+    utils::stopwatch t( time_gauss );
+    sat::gauss_elimination().apply( constraints );
+  }
+  log["num_xor_clauses_gauss"] = constraints.num_xor_clauses();
+
+  {
+    utils::stopwatch t( time_encode );
+    sat::xor_clauses_to_cnf( sid ).apply( constraints );
+  }
+  log["num_variables"] = constraints.num_variables();
+  log["num_clauses"] = constraints.num_clauses();
+  log["time_encode"] = utils::to_seconds( time_encode );
+  log["time_gauss"] = utils::to_seconds( time_gauss );
+  return log;
+}
+
+/*! \brief Returns a json log of a call to the SAT-solver
+ *
+ * \param result Result of the call
+ * \param time_solve Time spent in the call
+ * \param solver SAT-solver (nullptr if the problem has been solved with cube-and-conquer)
+ */
+inline nlohmann::json solve_log( const sat::sat_solver::result& result, utils::stopwatch<>::duration time_solve, const sat::sat_solver* solver = nullptr )
+{
+  nlohmann::json log;
+  log["result"] = result.is_sat() ? "sat" : ( result.is_unsat() ? "unsat" : "undef" );
+  log["time_solve"] = utils::to_seconds( time_solve );
+  if ( solver )
+  {
+    log["conflicts"] = solver->get_conflicts();
+    log["decisions"] = solver->get_decisions();
+    log["propagations"] = solver->get_propagations();
+  }
+  return log;
+}
+
+/*! \brief Splits the $k$-ESOP synthesis problem into cubes
+ *
+ * For each of the first split_vars variables, each of the first
+ * split_terms terms is assigned one of the states absent, positive,
+ * negative, or canceled by fixing its p- and q-variable.  Since the
+ * terms can be permuted, only cubes in which the states of the split
+ * terms are ordered are generated.
+ *
+ * \param num_vars Number of variables
+ * \param num_terms Number of product terms
+ * \param split_terms Number of terms used for splitting
+ * \param split_vars Number of variables per term used for splitting
+ * \return Cubes that cover the search space up to term permutation
+ */
+inline std::vector<std::vector<int>> esop_split_cubes( uint32_t num_vars, uint32_t num_terms, uint32_t split_terms, uint32_t split_vars )
+{
+  split_terms = std::min( split_terms, num_terms );
+  split_vars = std::min( split_vars, num_vars );
+  if ( split_terms == 0u || split_vars == 0u )
+  {
+    return {{}};
+  }
+
+  const uint32_t num_codes = 1u << ( 2u * split_vars );
+  std::vector<uint32_t> codes( split_terms, 0u );
+
+  std::vector<std::vector<int>> cubes;
+  for ( ;; )
+  {
+    std::vector<int> cube;
+    for ( auto j = 0u; j < split_terms; ++j )
+    {
+      for ( auto l = 0u; l < split_vars; ++l )
+      {
+        const auto state = ( codes[j] >> ( 2u * l ) ) & 3u;
+        const int p = 1 + num_vars * j + l;
+        const int q = 1 + num_vars * num_terms + num_vars * j + l;
+        cube.push_back( ( state & 1u ) ? p : -p );
+        cube.push_back( ( state & 2u ) ? q : -q );
+      }
+    }
+    cubes.emplace_back( cube );
+
+    /* next non-decreasing sequence of codes */
+    auto j = split_terms;
+    while ( j > 0u && codes[j - 1u] + 1u == num_codes )
+    {
+      --j;
+    }
+    if ( j == 0u )
+    {
+      break;
+    }
+    ++codes[j - 1u];
+    std::fill( codes.begin() + j, codes.end(), codes[j - 1u] );
+  }
+  return cubes;
+}
+
+} // namespace detail
+
 /*! \brief Compute a cover from a truth table.
  *
  * Convert each minterm of the specification into one cube.
@@ -137,11 +409,67 @@ inline esop_t esop_cover( const spec& spec )
   return cover;
 }
 
+/*! \brief Learnt clauses of a $k$-ESOP synthesis problem
+ *
+ * The clauses only refer to the p- and q-variables, which have the
+ * same meaning for all specifications with equal number of variables
+ * and terms.  The clauses remain valid for every specification that
+ * refines the source specification.
+ */
+struct learnt_clause_db
+{
+  /*! Specification for which the clauses have been learnt */
+  spec source;
+  uint32_t num_vars = 0u;
+  uint32_t num_terms = 0u;
+  std::vector<std::vector<int>> clauses;
+}; /* learnt_clause_db */
+
+/*! \brief Checks if a specification refines another specification
+ *
+ * A specification refines another specification if its care set
+ * contains the care set of the other specification and both agree on
+ * the latter.  Every ESOP that implements the refined specification
+ * also implements the other specification.
+ *
+ * \param refined Specification
+ * \param other Other specification
+ * \return true if and only if refined refines other
+ */
+inline bool refines( const spec& refined, const spec& other )
+{
+  if ( refined.bits.size() != other.bits.size() )
+  {
+    return false;
+  }
+
+  const auto is_care = []( const spec& s, uint64_t i ) {
+    return s.care[i] == '1' && ( s.bits[i] == '0' || s.bits[i] == '1' );
+  };
+
+  for ( auto i = 0u; i < other.bits.size(); ++i )
+  {
+    if ( is_care( other, i ) && ( !is_care( refined, i ) || refined.bits[i] != other.bits[i] ) )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
 struct simple_synthesizer_params
 {
   /*! A fixed number of product terms (= k) */
   unsigned number_of_terms;
   int conflict_limit = -1;
+  /*! Number of terms used to split the problem into cubes (0 disables cube-and-conquer) */
+  uint32_t split_terms = 0u;
+  /*! Number of variables per term used to split the problem into cubes */
+  uint32_t split_vars = 1u;
+  /*! Number of threads used to solve the cubes */
+  uint32_t num_threads = std::max( 1u, std::thread::hardware_concurrency() );
+  /*! Maximum size of exported learnt clauses (0 disables the export) */
+  uint32_t max_learnt_clause_size = 0u;
 }; /* simple_synthesizer_params */
 
 /*! \brief Simple ESOP synthesizer
@@ -181,92 +509,51 @@ public:
     const auto num_terms = params.number_of_terms;
     assert( num_terms >= 1 );
 
-    int sid = 1 + 2 * num_vars * num_terms;
-
     sat::constraints constraints;
     sat::sat_solver solver;
     if ( params.conflict_limit != -1 )
     {
       solver.set_conflict_limit( params.conflict_limit );
     }
+    solver.set_lazy_model( true );
 
     /* add constraints */
-    kitty::cube minterm = kitty::cube::neg_cube( num_vars );
+    nlohmann::json run;
+    run["num_terms"] = num_terms;
+    run["encoding"] = detail::encode_esop_constraints( constraints, _spec, num_vars, num_terms );
 
-    auto sample_counter = 0u;
-    do
+    sat::sat_solver::result sat;
+    utils::stopwatch<>::duration time_solve{0};
+    if ( params.split_terms > 0u )
     {
-      /* skip don't cares */
-      if ( ( _spec.bits[minterm._bits] != '0' && _spec.bits[minterm._bits] != '1' ) || _spec.care[minterm._bits] != '1' )
+      const auto cubes = detail::esop_split_cubes( num_vars, num_terms, params.split_terms, params.split_vars );
       {
-        ++minterm._bits;
-        continue;
+        utils::stopwatch t( time_solve );
+        sat = sat::cube_and_conquer( constraints, cubes, {params.num_threads, params.conflict_limit} );
       }
-
-      std::vector<int> z_vars( num_terms, 0u );
-      for ( auto j = 0u; j < num_terms; ++j )
+      run["solving"] = detail::solve_log( sat, time_solve );
+    }
+    else
+    {
+      /* reuse clauses learnt for a related specification */
+      if ( _imported.num_terms == num_terms )
       {
-        assert( uint32_t(sid) == 1 + 2 * num_vars * num_terms + sample_counter * num_terms + j );
-        z_vars[j] = sid++;
+        solver.import_learnt_clauses( _imported.clauses );
       }
 
-      for ( auto j = 0u; j < num_terms; ++j )
       {
-        const int z = z_vars[j];
-
-        // positive
-        for ( auto l = 0u; l < num_vars; ++l )
-        {
-          if ( minterm.get_bit( l ) )
-          {
-            std::vector<int> clause;
-            clause.push_back( -z );                                               // - z_j
-            clause.push_back( -( 1 + num_vars * num_terms + num_vars * j + l ) ); // -q_j,l
-
-            constraints.add_clause( clause );
-          }
-          else
-          {
-            std::vector<int> clause;
-            clause.push_back( -z );                        // -z_j
-            clause.push_back( -( 1 + num_vars * j + l ) ); // -p_j,l
-
-            constraints.add_clause( clause );
-          }
-        }
+        utils::stopwatch t( time_solve );
+        sat = solver.solve( constraints );
       }
+      run["solving"] = detail::solve_log( sat, time_solve, &solver );
 
-      for ( auto j = 0u; j < num_terms; ++j )
+      if ( params.max_learnt_clause_size > 0u )
       {
-        const int z = z_vars[j];
-
-        // negative
-        std::vector<int> clause = {z};
-        for ( auto l = 0u; l < num_vars; ++l )
-        {
-          if ( minterm.get_bit( l ) )
-          {
-            clause.push_back( 1 + num_vars * num_terms + num_vars * j + l ); // q_j,l
-          }
-          else
-          {
-            clause.push_back( 1 + num_vars * j + l ); // p_j,l
-          }
-        }
-
-        constraints.add_clause( clause );
+        _exported = learnt_clause_db{_spec, num_vars, num_terms, solver.export_learnt_clauses( params.max_learnt_clause_size, 2 * num_vars * num_terms )};
       }
+    }
+    _stats["runs"].push_back( run );
 
-      constraints.add_xor_clause( z_vars, _spec.bits[minterm._bits] == '1' );
-
-      ++sample_counter;
-      ++minterm._bits;
-    } while ( minterm._bits < ( 1 << num_vars ) );
-
-    sat::gauss_elimination().apply( constraints );
-    sat::xor_clauses_to_cnf( sid ).apply( constraints );
-
-    const auto sat = solver.solve( constraints );
     if ( sat.is_undef() )
     {
       return result();
@@ -278,8 +565,43 @@ public:
     else
     {
       assert( sat.is_sat() );
-      return result( make_esop( sat.model, num_terms, num_vars ) );
+      if ( params.split_terms > 0u )
+      {
+        return result( make_esop( sat.model, num_terms, num_vars ) );
+      }
+      return result( make_esop( solver.get_model(), num_terms, num_vars ) );
+    }
+  }
+
+  /*! \brief export_learnt_clauses
+   *
+   * Returns the short learnt clauses over the p- and q-variables of
+   * the last call to synthesize (see max_learnt_clause_size).
+   */
+  learnt_clause_db export_learnt_clauses() const
+  {
+    return _exported;
+  }
+
+  /*! \brief import_learnt_clauses
+   *
+   * Imports clauses learnt for a related specification.  The clauses
+   * are only used if the specification of this synthesizer refines
+   * the source specification and the number of terms match.
+   *
+   * \param db Learnt clauses
+   * \return true if and only if the clauses are accepted
+   */
+  bool import_learnt_clauses( const learnt_clause_db& db )
+  {
+    const uint32_t num_vars = log2( _spec.bits.size() );
+    if ( db.num_vars != num_vars || !refines( _spec, db.source ) )
+    {
+      return false;
     }
+
+    _imported = db;
+    return true;
   }
 
   /*! \brief stats
@@ -300,13 +622,16 @@ private:
    * \param num_terms Number of terms
    * \param num_vars Number of variables
    */
-  esop_t make_esop( const sat::sat_solver::model_t& model, unsigned num_terms, unsigned num_vars )
+  template<typename Model>
+  esop_t make_esop( const Model& model, unsigned num_terms, unsigned num_vars )
   {
     return detail::esop_from_model( model, num_terms, num_vars );
   }
 
 private:
   const spec _spec;
+  learnt_clause_db _imported;
+  learnt_clause_db _exported;
   nlohmann::json _stats;
 }; /* simple_synthesizer */
 
@@ -335,8 +660,35 @@ struct minimum_synthesizer_params
       terminate, and updates the value */
   std::function<bool( uint32_t&, sat::sat_solver::result )> next;
   int conflict_limit = -1;
+  /*! Number of terms used to split the problem into cubes (0 disables cube-and-conquer) */
+  uint32_t split_terms = 0u;
+  /*! Number of variables per term used to split the problem into cubes */
+  uint32_t split_vars = 1u;
+  /*! Number of threads used to solve the cubes */
+  uint32_t num_threads = std::max( 1u, std::thread::hardware_concurrency() );
 }; /* minimum_synthesizer_params */
 
+/*! \brief parallel_minimum_synthesizer_params
+ *
+ * Parameters for the parallel search of the minimum ESOP synthesizer.
+ *
+ * The values of k in [lower_bound, upper_bound] are solved
+ * concurrently.  Since a k-ESOP can always be extended to a
+ * (k+1)-ESOP, a realizable k narrows the bracket from above and an
+ * unrealizable k narrows it from below.  Runs for values outside of
+ * the bracket are canceled.
+ */
+struct parallel_minimum_synthesizer_params
+{
+  /*! Smallest number of terms considered */
+  uint32_t lower_bound = 1u;
+  /*! Largest number of terms considered */
+  uint32_t upper_bound = 1u;
+  /*! Number of concurrently solved values of k */
+  uint32_t num_threads = std::max( 1u, std::thread::hardware_concurrency() );
+  int conflict_limit = -1;
+}; /* parallel_minimum_synthesizer_params */
+
 /*! \brief Minimum ESOP synthesizer
  *
  * Similar to simple_synthesizer, but searches for a minimum ESOP in a
@@ -370,113 +722,76 @@ public:
     assert( _spec.care.size() == ( 1ull << num_vars ) && "bit-width of care is not a power of 2" );
     assert( num_vars <= 32 && "cube data structure cannot store more than 32 variables" );
 
-    esop_t esop;
+    esop_t esop = _warm_start;
     sat::sat_solver::result result;
-    bool all_unsat = true;
+    bool all_unsat = esop.empty();
 
-    uint32_t k = params.begin;
-    do
-    {
-      assert( k != 0 && "synthesis of constants not supported" );
-      int sid = 1 + 2 * num_vars * k;
+    /* values of k that have already been tried */
+    std::set<uint32_t> tried;
 
-      sat::constraints constraints;
-      sat::sat_solver solver;
+    uint32_t k = params.begin;
 
-      if ( params.conflict_limit != -1 )
+    /* an incumbent ESOP with m terms makes all k >= m redundant */
+    const auto bound_by_incumbent = [&]() {
+      if ( esop.empty() || k < esop.size() )
       {
-        solver.set_conflict_limit( params.conflict_limit );
+        return true;
       }
+      k = esop.size() - 1u;
+      return k != 0 && tried.find( k ) == tried.end();
+    };
 
-      /* add constraints */
-      kitty::cube minterm = kitty::cube::neg_cube( num_vars );
+    if ( !bound_by_incumbent() )
+    {
+      return esop;
+    }
 
-      auto sample_counter = 0u;
-      do
+    do
+    {
+      assert( k != 0 && "synthesis of constants not supported" );
+      tried.insert( k );
+
+      nlohmann::json run;
+      if ( params.split_terms > 0u )
       {
-        /* skip don't cares */
-        if ( ( _spec.bits[minterm._bits] != '0' && _spec.bits[minterm._bits] != '1' ) || _spec.care[minterm._bits] != '1' )
+        const auto cubes = detail::esop_split_cubes( num_vars, k, params.split_terms, params.split_vars );
+        auto constraints = make_constraints( num_vars, k, run );
+
+        utils::stopwatch<>::duration time_solve{0};
         {
-          ++minterm._bits;
-          continue;
+          utils::stopwatch t( time_solve );
+          result = sat::cube_and_conquer( constraints, cubes, {params.num_threads, params.conflict_limit} );
         }
+        run["solving"] = detail::solve_log( result, time_solve );
 
-        std::vector<int> z_vars( k, 0u );
-        for ( auto j = 0u; j < k; ++j )
+        if ( result.is_sat() )
         {
-          assert( uint32_t(sid) == 1 + 2 * num_vars * k + sample_counter * k + j );
-          z_vars[j] = sid++;
+          esop = make_esop( result.model, k, num_vars );
         }
+      }
+      else
+      {
+        sat::sat_solver solver;
 
-        for ( auto j = 0u; j < k; ++j )
+        if ( params.conflict_limit != -1 )
         {
-          const int z = z_vars[j];
-
-          // positive
-          for ( auto l = 0u; l < num_vars; ++l )
-          {
-            if ( minterm.get_bit( l ) )
-            {
-              std::vector<int> clause;
-              clause.push_back( -z );                                       // - z_j
-              clause.push_back( -( 1 + num_vars * k + num_vars * j + l ) ); // -q_j,l
-
-              constraints.add_clause( clause );
-            }
-            else
-            {
-              std::vector<int> clause;
-              clause.push_back( -z );                        // -z_j
-              clause.push_back( -( 1 + num_vars * j + l ) ); // -p_j,l
-
-              constraints.add_clause( clause );
-            }
-          }
+          solver.set_conflict_limit( params.conflict_limit );
         }
+        solver.set_lazy_model( true );
 
-        for ( auto j = 0u; j < k; ++j )
+        result = solve( solver, esop, num_vars, k, run );
+        if ( result.is_sat() )
         {
-          const int z = z_vars[j];
-
-          // negative
-          std::vector<int> clause = {z};
-          for ( auto l = 0u; l < num_vars; ++l )
-          {
-            if ( minterm.get_bit( l ) )
-            {
-              clause.push_back( 1 + num_vars * k + num_vars * j + l ); // q_j,l
-            }
-            else
-            {
-              clause.push_back( 1 + num_vars * j + l ); // p_j,l
-            }
-          }
-
-          constraints.add_clause( clause );
+          esop = make_esop( solver.get_model(), k, num_vars );
         }
-
-        constraints.add_xor_clause( z_vars, _spec.bits[minterm._bits] == '1' );
-
-        ++sample_counter;
-        ++minterm._bits;
-      } while ( minterm._bits < ( 1 << num_vars ) );
-
-      sat::gauss_elimination().apply( constraints );
-      sat::xor_clauses_to_cnf( sid ).apply( constraints );
-      // sat::cnf_symmetry_breaking( sid ).apply( constraints );
-
-      result = solver.solve( constraints );
-
-      if ( result.is_sat() )
-      {
-        esop = make_esop( result.model, k, num_vars );
       }
+      _stats["runs"].push_back( run );
 
       if ( !result.is_unsat() )
       {
         all_unsat = false;
       }
-    } while ( params.next( k, result ) );
+    } while ( params.next( k, result ) && bound_by_incumbent() );
 
     /* no ESOP constructed, either UNSAT or UNREALIZABLE */
     if ( esop.size() == 0u )
@@ -490,6 +805,166 @@ public:
     return esop;
   }
 
+  /*! \brief synthesize
+   *
+   * SAT-based ESOP synthesis, which concurrently solves the problem
+   * for different numbers of terms.
+   *
+   * Starting from the middle of the bracket [lower_bound,
+   * upper_bound], one value of k is assigned to each thread.  If k is
+   * realizable, all values greater or equal than k are canceled; if
+   * k is unrealizable, all values less or equal than k are canceled.
+   *
+   * \params params Parameters
+   * \return An ESOP form
+   */
+  result synthesize( const parallel_minimum_synthesizer_params& params )
+  {
+    const uint32_t num_vars = log2( _spec.bits.size() );
+    assert( _spec.bits.size() == ( 1ull << num_vars ) && "bit-width of bits is not a power of 2" );
+    assert( _spec.care.size() == ( 1ull << num_vars ) && "bit-width of care is not a power of 2" );
+    assert( num_vars <= 32 && "cube data structure cannot store more than 32 variables" );
+    assert( params.lower_bound != 0 && "synthesis of constants not supported" );
+    assert( params.num_threads >= 1u );
+
+    std::mutex mutex;
+    std::condition_variable cv;
+
+    /* all k < lower are unrealizable, all k >= upper are realizable */
+    esop_t esop = _warm_start;
+    uint32_t lower = params.lower_bound;
+    uint32_t upper = esop.empty() ? params.upper_bound + 1 : std::min<uint32_t>( esop.size(), params.upper_bound + 1 );
+    bool unknown = false;
+
+    std::set<uint32_t> tried;
+    std::map<uint32_t, sat::sat_solver*> running;
+
+    /* select the untried value closest to the middle of the bracket */
+    const auto select = [&]() -> uint32_t {
+      const auto mid = lower + ( upper - lower ) / 2;
+      for ( auto d = 0u; d <= upper - lower; ++d )
+      {
+        if ( mid + d < upper && tried.find( mid + d ) == tried.end() )
+          return mid + d;
+        if ( d > 0 && mid >= lower + d && tried.find( mid - d ) == tried.end() )
+          return mid - d;
+      }
+      return 0u;
+    };
+
+    const auto worker = [&]() {
+      std::unique_lock<std::mutex> lock( mutex );
+      for ( ;; )
+      {
+        const auto k = lower < upper ? select() : 0u;
+        if ( k == 0u )
+        {
+          if ( running.empty() )
+          {
+            cv.notify_all();
+            return;
+          }
+
+          /* wait until the bracket changes */
+          cv.wait( lock );
+          continue;
+        }
+
+        tried.insert( k );
+
+        sat::sat_solver solver;
+        if ( params.conflict_limit != -1 )
+        {
+          solver.set_conflict_limit( params.conflict_limit );
+        }
+        solver.set_lazy_model( true );
+        running.emplace( k, &solver );
+        const auto phases = esop;
+
+        lock.unlock();
+        nlohmann::json run;
+        const auto sat = solve( solver, phases, num_vars, k, run );
+        lock.lock();
+
+        running.erase( k );
+        _stats["runs"].push_back( run );
+        if ( sat.is_sat() )
+        {
+          const auto candidate = make_esop( solver.get_model(), k, num_vars );
+          if ( candidate.size() < upper )
+          {
+            esop = candidate;
+            upper = candidate.size();
+          }
+        }
+        else if ( sat.is_unsat() )
+        {
+          lower = std::max( lower, k + 1 );
+        }
+        else if ( k >= lower && k < upper )
+        {
+          /* conflict limit reached */
+          unknown = true;
+        }
+
+        /* cancel the runs that became irrelevant */
+        for ( const auto& r : running )
+        {
+          if ( r.first < lower || r.first >= upper )
+          {
+            r.second->interrupt();
+          }
+        }
+        cv.notify_all();
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for ( auto i = 1u; i < params.num_threads; ++i )
+    {
+      threads.emplace_back( worker );
+    }
+    worker();
+    for ( auto& t : threads )
+    {
+      t.join();
+    }
+
+    if ( !esop.empty() )
+    {
+      return esop;
+    }
+    else if ( !unknown && lower > params.upper_bound )
+    {
+      return easy::esop::result( unrealizable );
+    }
+    else
+    {
+      return easy::esop::result();
+    }
+  }
+
+  /*! \brief warm_start
+   *
+   * Provides an initial ESOP, e.g., computed with a heuristic.  The
+   * ESOP serves as an upper bound on the number of terms and seeds
+   * the phases of the SAT-solver.  An ESOP that does not implement
+   * the specification is ignored.
+   *
+   * \param esop An ESOP form
+   * \return true if and only if the ESOP is accepted
+   */
+  bool warm_start( const esop_t& esop )
+  {
+    if ( esop.empty() || !verify_esop( esop, _spec.bits, _spec.care ) )
+    {
+      return false;
+    }
+
+    _warm_start = esop;
+    return true;
+  }
+
   /*! \brief stats
    *
    * \Return A json log with statistics logged during the synthesis
@@ -500,6 +975,56 @@ public:
   }
 
 private:
+  /*! \brief solve
+   *
+   * Solves the synthesis problem for a fixed number of terms.
+   *
+   * \param solver SAT-solver
+   * \param phases Best known ESOP used to seed the phases (may be empty)
+   * \param num_vars Number of variables
+   * \param num_terms Number of terms
+   * \param run Json log of the run
+   */
+  sat::sat_solver::result solve( sat::sat_solver& solver, const esop_t& phases, uint32_t num_vars, uint32_t num_terms, nlohmann::json& run ) const
+  {
+    auto constraints = make_constraints( num_vars, num_terms, run );
+
+    /* seed the phases with the best known ESOP */
+    if ( !phases.empty() )
+    {
+      detail::set_esop_phases( solver, phases, num_vars, num_terms );
+    }
+
+    utils::stopwatch<>::duration time_solve{0};
+    sat::sat_solver::result result;
+    {
+      utils::stopwatch t( time_solve );
+      result = solver.solve( constraints );
+    }
+    run["solving"] = detail::solve_log( result, time_solve, &solver );
+    return result;
+  }
+
+  /*! \brief make_constraints
+   *
+   * Creates the CNF encoding for a fixed number of terms.
+   *
+   * \param num_vars Number of variables
+   * \param num_terms Number of terms
+   * \param run Json log of the run
+   */
+  sat::constraints make_constraints( uint32_t num_vars, uint32_t num_terms, nlohmann::json& run ) const
+  {
+    sat::constraints constraints;
+
+    /* add constraints */
+    run["num_terms"] = num_terms;
+    run["encoding"] = detail::encode_esop_constraints( constraints, _spec, num_vars, num_terms );
+    // sat::cnf_symmetry_breaking( sid ).apply( constraints );
+
+    return constraints;
+  }
+
   /*! \brief make_esop
    *
    * Extract the ESOP from a satisfying assignments.
@@ -508,13 +1033,15 @@ private:
    * \param num_terms Number of terms
    * \param num_vars Number of variables
    */
-  esop_t make_esop( const sat::sat_solver::model_t& model, unsigned num_terms, unsigned num_vars )
+  template<typename Model>
+  esop_t make_esop( const Model& model, unsigned num_terms, unsigned num_vars )
   {
     return detail::esop_from_model( model, num_terms, num_vars );
   }
 
 private:
   const spec _spec;
+  esop_t _warm_start;
   nlohmann::json _stats;
 }; /* minimum_synthesizer */
 
@@ -587,83 +1114,11 @@ public:
     uint32_t k = params.begin;
     do
     {
-      int sid = 1 + 2 * num_vars * k;
-
       constraints.reset( new sat::constraints );
       solver.reset( new sat::sat_solver );
 
       /* add constraints */
-      kitty::cube minterm = kitty::cube::neg_cube( num_vars );
-
-      auto sample_counter = 0u;
-      do
-      {
-        /* skip don't cares */
-        if ( ( _spec.bits[minterm._bits] != '0' && _spec.bits[minterm._bits] != '1' ) || _spec.care[minterm._bits] != '1' )
-        {
-          ++minterm._bits;
-          continue;
-        }
-
-        std::vector<int> z_vars( k, 0u );
-        for ( auto j = 0u; j < k; ++j )
-        {
-          assert( uint32_t(sid) == 1 + 2 * num_vars * k + sample_counter * k + j );
-          z_vars[j] = sid++;
-        }
-
-        for ( auto j = 0u; j < k; ++j )
-        {
-          const int z = z_vars[j];
-
-          // positive
-          for ( auto l = 0u; l < num_vars; ++l )
-          {
-            if ( minterm.get_bit( l ) )
-            {
-              std::vector<int> clause;
-              clause.push_back( -z );                                       // - z_j
-              clause.push_back( -( 1 + num_vars * k + num_vars * j + l ) ); // -q_j,l
-
-              constraints->add_clause( clause );
-            }
-            else
-            {
-              std::vector<int> clause;
-              clause.push_back( -z );                        // -z_j
-              clause.push_back( -( 1 + num_vars * j + l ) ); // -p_j,l
-
-              constraints->add_clause( clause );
-            }
-          }
-        }
-
-        for ( auto j = 0u; j < k; ++j )
-        {
-          const int z = z_vars[j];
-
-          // negative
-          std::vector<int> clause = {z};
-          for ( auto l = 0u; l < num_vars; ++l )
-          {
-            if ( minterm.get_bit( l ) )
-            {
-              clause.push_back( 1 + num_vars * k + num_vars * j + l ); // q_j,l
-            }
-            else
-            {
-              clause.push_back( 1 + num_vars * j + l ); // p_j,l
-            }
-          }
-
-          constraints->add_clause( clause );
-        }
-
-        constraints->add_xor_clause( z_vars, _spec.bits[minterm._bits] == '1' );
-
-        ++sample_counter;
-        ++minterm._bits;
-      } while ( minterm._bits < ( 1 << num_vars ) );
+      int sid = detail::add_esop_constraints( *constraints, _spec, num_vars, k );
 
       sat::gauss_elimination().apply( *constraints );
       sat::xor_clauses_to_cnf( sid ).apply( *constraints );
@@ -680,83 +1135,11 @@ public:
     {
       k = esop.size();
 
-      int sid = 1 + 2 * num_vars * k;
-
       constraints.reset( new sat::constraints );
       solver.reset( new sat::sat_solver );
 
       /* add constraints */
-      kitty::cube minterm = kitty::cube::neg_cube( num_vars );
-
-      auto sample_counter = 0u;
-      do
-      {
-        /* skip don't cares */
-        if ( ( _spec.bits[minterm._bits] != '0' && _spec.bits[minterm._bits] != '1' ) || _spec.care[minterm._bits] != '1' )
-        {
-          ++minterm._bits;
-          continue;
-        }
-
-        std::vector<int> z_vars( k, 0u );
-        for ( auto j = 0u; j < k; ++j )
-        {
-          assert( uint32_t(sid) == 1 + 2 * num_vars * k + sample_counter * k + j );
-          z_vars[j] = sid++;
-        }
-
-        for ( auto j = 0u; j < k; ++j )
-        {
-          const int z = z_vars[j];
-
-          // positive
-          for ( auto l = 0u; l < num_vars; ++l )
-          {
-            if ( minterm.get_bit( l ) )
-            {
-              std::vector<int> clause;
-              clause.push_back( -z );                                       // - z_j
-              clause.push_back( -( 1 + num_vars * k + num_vars * j + l ) ); // -q_j,l
-
-              constraints->add_clause( clause );
-            }
-            else
-            {
-              std::vector<int> clause;
-              clause.push_back( -z );                        // -z_j
-              clause.push_back( -( 1 + num_vars * j + l ) ); // -p_j,l
-
-              constraints->add_clause( clause );
-            }
-          }
-        }
-
-        for ( auto j = 0u; j < k; ++j )
-        {
-          const int z = z_vars[j];
-
-          // negative
-          std::vector<int> clause = {z};
-          for ( auto l = 0u; l < num_vars; ++l )
-          {
-            if ( minterm.get_bit( l ) )
-            {
-              clause.push_back( 1 + num_vars * k + num_vars * j + l ); // q_j,l
-            }
-            else
-            {
-              clause.push_back( 1 + num_vars * j + l ); // p_j,l
-            }
-          }
-
-          constraints->add_clause( clause );
-        }
-
-        constraints->add_xor_clause( z_vars, _spec.bits[minterm._bits] == '1' );
-
-        ++sample_counter;
-        ++minterm._bits;
-      } while ( minterm._bits < ( 1 << num_vars ) );
+      int sid = detail::add_esop_constraints( *constraints, _spec, num_vars, k );
 
       sat::gauss_elimination().apply( *constraints );
       sat::xor_clauses_to_cnf( sid ).apply( *constraints );
@@ -777,7 +1160,7 @@ public:
 
       esop = make_esop( result.model, k, num_vars );
 
-      std::sort( esop.begin(), esop.end(), cube_weight_compare( num_vars ) );
+      sort_by_cube_weight( esop, num_vars );
 
       /* add one blocking clause for each possible permutation of the cubes */
       do
@@ -787,8 +1170,8 @@ public:
         {
           for ( auto l = 0u; l < num_vars; ++l )
           {
-            const auto p_value = result.model[j * num_vars + l] == l_True;
-            const auto q_value = result.model[num_vars * k + j * num_vars + l] == l_True;
+            const auto p_value = result.model[j * num_vars + l] == Glucose::l_True;
+            const auto q_value = result.model[num_vars * k + j * num_vars + l] == Glucose::l_True;
 
             /* do not consider all possibilities for canceled cubes */
             if ( p_value && q_value )
@@ -830,7 +1213,8 @@ private:
    * \param num_terms Number of terms
    * \param num_vars Number of variables
    */
-  esop_t make_esop( const sat::sat_solver::model_t& model, unsigned num_terms, unsigned num_vars )
+  template<typename Model>
+  esop_t make_esop( const Model& model, unsigned num_terms, unsigned num_vars )
   {
     return detail::esop_from_model( model, num_terms, num_vars );
   }
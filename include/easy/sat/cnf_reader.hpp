@@ -0,0 +1,537 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <easy/sat/constraints.hpp>
+#include <easy/utils/parallel.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace easy::sat
+{
+
+struct cnf_reader_params
+{
+  /*! Number of threads that convert the text into numbers */
+  uint32_t num_threads{1u};
+
+  /*! Number of bytes converted by one thread at a time */
+  uint64_t block_size{1u << 22u};
+}; /* cnf_reader_params */
+
+namespace detail
+{
+
+/* numbers of a range of complete lines and the positions of the XOR-clauses in it */
+struct dimacs_tokens
+{
+  std::vector<int64_t> numbers;
+  std::vector<uint64_t> xor_marks;
+  bool error = false;
+};
+
+inline void tokenize_dimacs( const char* begin, const char* end, dimacs_tokens& tokens )
+{
+  tokens.numbers.clear();
+  tokens.xor_marks.clear();
+  tokens.error = false;
+
+  auto p = begin;
+  while ( p != end )
+  {
+    switch ( *p )
+    {
+    case ' ':
+    case '\t':
+    case '\r':
+    case '\n':
+      ++p;
+      break;
+
+    case 'c':
+      p = std::find( p, end, '\n' );
+      break;
+
+    case 'x':
+      tokens.xor_marks.emplace_back( tokens.numbers.size() );
+      ++p;
+      break;
+
+    default:
+      {
+        int64_t value;
+        auto const r = std::from_chars( p, end, value );
+        if ( r.ec != std::errc() )
+        {
+          tokens.error = true;
+          return;
+        }
+        tokens.numbers.emplace_back( value );
+        p = r.ptr;
+      }
+      break;
+    }
+  }
+}
+
+/* read-only view of the contents of a file, memory-mapped where available */
+class mapped_file
+{
+public:
+  explicit mapped_file( std::string const& filename )
+  {
+#if defined( __unix__ ) || defined( __APPLE__ )
+    auto const fd = ::open( filename.c_str(), O_RDONLY );
+    if ( fd < 0 )
+    {
+      return;
+    }
+
+    struct stat st;
+    if ( ::fstat( fd, &st ) == 0 )
+    {
+      _size = st.st_size;
+      _good = true;
+      if ( _size > 0u )
+      {
+        auto const addr = ::mmap( nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0 );
+        if ( addr != MAP_FAILED )
+        {
+          _data = static_cast<const char*>( addr );
+          _mapped = true;
+        }
+        else
+        {
+          _good = false;
+        }
+      }
+    }
+    ::close( fd );
+#else
+    std::ifstream is( filename, std::ios::binary );
+    if ( is )
+    {
+      _contents.assign( std::istreambuf_iterator<char>( is ), std::istreambuf_iterator<char>() );
+      _data = _contents.data();
+      _size = _contents.size();
+      _good = true;
+    }
+#endif
+  }
+
+  mapped_file( mapped_file const& ) = delete;
+  mapped_file& operator=( mapped_file const& ) = delete;
+
+  ~mapped_file()
+  {
+#if defined( __unix__ ) || defined( __APPLE__ )
+    if ( _mapped )
+    {
+      ::munmap( const_cast<char*>( _data ), _size );
+    }
+#endif
+  }
+
+  bool good() const { return _good; }
+  const char* begin() const { return _data; }
+  const char* end() const { return _data + _size; }
+
+private:
+  const char* _data = nullptr;
+  uint64_t _size = 0u;
+  bool _good = false;
+  bool _mapped = false;
+#if !( defined( __unix__ ) || defined( __APPLE__ ) )
+  std::string _contents;
+#endif
+};
+
+} /* namespace detail */
+
+/*! \brief Reads constraints in DIMACS format
+ *
+ * Supports DIMACS CNF, XOR-clauses in the XCNF notation (clauses
+ * starting with `x`), and WCNF.  In WCNF, clauses with at least the
+ * top weight of the problem line are added as hard clauses, the other
+ * clauses as weighted clauses.  The problem line is optional.
+ *
+ * The text is processed in blocks of complete lines.  The numbers of
+ * a block are converted by up to num_threads threads in parallel
+ * before they are added to the constraints in order.  Files are
+ * memory-mapped; streams are read block by block.
+ */
+class cnf_reader
+{
+public:
+  explicit cnf_reader( constraints& constraints, cnf_reader_params const& ps = {} )
+    : _constraints( constraints )
+    , _ps( ps )
+    , _tokens( std::max( ps.num_threads, 1u ) )
+  {
+  }
+
+  /*! \brief Reads constraints from a stream
+   *
+   * \param is Input stream
+   * \return True if and only if the input is well-formed
+   */
+  bool read( std::istream& is )
+  {
+    uint64_t const block_size = std::max<uint64_t>( _ps.block_size, 64u ) * _tokens.size();
+
+    std::vector<char> buffer;
+    uint64_t carry = 0u;
+    for ( ;; )
+    {
+      buffer.resize( carry + block_size );
+      is.read( buffer.data() + carry, block_size );
+      auto const last = uint64_t( is.gcount() ) < block_size;
+      auto const begin = buffer.data();
+      auto const end = begin + carry + is.gcount();
+
+      /* only process complete lines */
+      auto cut = end;
+      if ( !last )
+      {
+        auto const rit = std::find( std::make_reverse_iterator( end ), std::make_reverse_iterator( begin ), '\n' );
+        if ( rit == std::make_reverse_iterator( begin ) )
+        {
+          carry = end - begin;
+          continue;
+        }
+        cut = rit.base();
+      }
+
+      if ( !process( begin, cut ) )
+      {
+        return false;
+      }
+
+      carry = end - cut;
+      std::memmove( begin, cut, carry );
+      if ( last )
+      {
+        break;
+      }
+    }
+    return finish();
+  }
+
+  /*! \brief Reads constraints from a file
+   *
+   * \param filename Name of the file
+   * \return True if and only if the file exists and is well-formed
+   */
+  bool read( std::string const& filename )
+  {
+    detail::mapped_file file( filename );
+    if ( !file.good() )
+    {
+      return false;
+    }
+
+    uint64_t const block_size = std::max<uint64_t>( _ps.block_size, 64u ) * _tokens.size();
+    auto begin = file.begin();
+    while ( begin != file.end() )
+    {
+      auto cut = file.end();
+      if ( uint64_t( file.end() - begin ) > block_size )
+      {
+        cut = std::find( begin + block_size, file.end(), '\n' );
+        if ( cut != file.end() )
+        {
+          ++cut;
+        }
+      }
+
+      if ( !process( begin, cut ) )
+      {
+        return false;
+      }
+      begin = cut;
+    }
+    return finish();
+  }
+
+  /*! \brief Returns true if and only if a WCNF problem line has been read */
+  bool is_weighted() const
+  {
+    return _weighted;
+  }
+
+  /*! \brief Returns the number of clauses of the problem line */
+  uint64_t num_declared_clauses() const
+  {
+    return _num_declared_clauses;
+  }
+
+  /*! \brief Returns the number of clauses read */
+  uint64_t num_clauses() const
+  {
+    return _num_clauses;
+  }
+
+private:
+  /* processes a range of complete lines */
+  bool process( const char* begin, const char* end )
+  {
+    if ( !_header_done )
+    {
+      begin = read_header( begin, end );
+      if ( begin == nullptr )
+      {
+        return false;
+      }
+    }
+
+    /* split into one range per thread at line boundaries */
+    auto const num_ranges = _tokens.size();
+    std::vector<const char*> bounds( num_ranges + 1u, end );
+    bounds[0] = begin;
+    for ( auto i = 1u; i < num_ranges; ++i )
+    {
+      auto const p = std::max( bounds[i - 1], begin + ( end - begin ) * i / num_ranges );
+      bounds[i] = std::find( p, end, '\n' );
+    }
+
+    utils::parallel_for( 0u, num_ranges, [&]( uint64_t i ) {
+        detail::tokenize_dimacs( bounds[i], bounds[i + 1u], _tokens[i] );
+      }, num_ranges );
+
+    for ( const auto& t : _tokens )
+    {
+      if ( t.error || !consume( t ) )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /* skips comments and reads the problem line; returns the position after it or nullptr on an error */
+  const char* read_header( const char* begin, const char* end )
+  {
+    auto p = begin;
+    while ( p != end )
+    {
+      if ( *p == ' ' || *p == '\t' || *p == '\r' || *p == '\n' )
+      {
+        ++p;
+      }
+      else if ( *p == 'c' )
+      {
+        p = std::find( p, end, '\n' );
+      }
+      else
+      {
+        break;
+      }
+    }
+
+    if ( p == end )
+    {
+      return end;
+    }
+
+    _header_done = true;
+    if ( *p != 'p' )
+    {
+      /* no problem line */
+      return p;
+    }
+
+    auto const eol = std::find( p, end, '\n' );
+    std::string format;
+    std::vector<uint64_t> values;
+    ++p;
+    while ( p != eol )
+    {
+      if ( *p == ' ' || *p == '\t' || *p == '\r' )
+      {
+        ++p;
+      }
+      else if ( std::isdigit( static_cast<unsigned char>( *p ) ) )
+      {
+        uint64_t value;
+        auto const r = std::from_chars( p, eol, value );
+        if ( r.ec != std::errc() )
+        {
+          return nullptr;
+        }
+        values.emplace_back( value );
+        p = r.ptr;
+      }
+      else
+      {
+        auto const q = std::find_if( p, eol, []( char c ){ return c == ' ' || c == '\t' || c == '\r'; } );
+        format.assign( p, q );
+        p = q;
+      }
+    }
+
+    if ( ( format == "cnf" && values.size() == 2u ) )
+    {
+      _weighted = false;
+    }
+    else if ( format == "wcnf" && ( values.size() == 2u || values.size() == 3u ) )
+    {
+      _weighted = true;
+      _top = values.size() == 3u ? values[2u] : std::numeric_limits<uint64_t>::max();
+    }
+    else
+    {
+      return nullptr;
+    }
+
+    _num_declared_variables = values[0u];
+    _num_declared_clauses = values[1u];
+    return eol;
+  }
+
+  /* adds the clauses of the numbers; a clause may continue in the next call */
+  bool consume( detail::dimacs_tokens const& tokens )
+  {
+    auto mark = std::begin( tokens.xor_marks );
+    for ( auto i = 0u; i < tokens.numbers.size(); ++i )
+    {
+      auto const n = tokens.numbers[i];
+      if ( !_in_clause )
+      {
+        _in_clause = true;
+        _is_xor = false;
+        _clause.clear();
+        if ( _weighted )
+        {
+          if ( n < 0 )
+          {
+            return false;
+          }
+          _weight = n;
+          continue;
+        }
+      }
+
+      while ( mark != std::end( tokens.xor_marks ) && *mark < i )
+      {
+        ++mark;
+      }
+      if ( mark != std::end( tokens.xor_marks ) && *mark == i && _clause.empty() )
+      {
+        _is_xor = true;
+      }
+
+      if ( n == 0 )
+      {
+        add_clause();
+        _in_clause = false;
+      }
+      else if ( n < -std::numeric_limits<int>::max() || n > std::numeric_limits<int>::max() )
+      {
+        return false;
+      }
+      else
+      {
+        _clause.emplace_back( int( n ) );
+      }
+    }
+    return true;
+  }
+
+  void add_clause()
+  {
+    ++_num_clauses;
+    if ( _is_xor )
+    {
+      _constraints.add_xor_clause( _clause );
+    }
+    else if ( !_weighted || _weight >= _top )
+    {
+      _constraints.add_clause( _clause );
+    }
+    else
+    {
+      _constraints.add_weighted_clause( _clause, uint32_t( std::min<uint64_t>( _weight, std::numeric_limits<uint32_t>::max() ) ) );
+    }
+  }
+
+  bool finish()
+  {
+    if ( _in_clause )
+    {
+      return false;
+    }
+
+    if ( _num_declared_variables > _constraints.num_variables() )
+    {
+      _constraints.set_num_variables( _num_declared_variables );
+    }
+    return true;
+  }
+
+private:
+  constraints& _constraints;
+  cnf_reader_params const _ps;
+  std::vector<detail::dimacs_tokens> _tokens;
+
+  /* problem line */
+  bool _header_done = false;
+  bool _weighted = false;
+  uint64_t _top = std::numeric_limits<uint64_t>::max();
+  uint64_t _num_declared_variables = 0u;
+  uint64_t _num_declared_clauses = 0u;
+
+  /* clause being read */
+  bool _in_clause = false;
+  bool _is_xor = false;
+  uint64_t _weight = 0u;
+  std::vector<int> _clause;
+
+  uint64_t _num_clauses = 0u;
+}; /* cnf_reader */
+
+} // namespace easy::sat
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -25,50 +25,179 @@
 
 #pragma once
 
-#include <easy/sat/sat_solver.hpp>
+#include <easy/sat/constraints.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <cstdint>
 #include <iostream>
+#include <vector>
 
 namespace easy::sat
 {
 
+/*! \brief Output formats of cnf_writer */
+enum class cnf_format
+{
+  /*! DIMACS CNF; XOR-clauses are written as `x` lines (XCNF) */
+  dimacs = 0,
+  /*! Weighted DIMACS (WCNF) for MaxSAT-solvers */
+  wcnf = 1,
+}; /* cnf_format */
+
+/*! \brief Writes constraints in DIMACS format
+ *
+ * The text is assembled in a buffer and passed to the stream in large
+ * blocks; integers are converted without going through the stream.
+ *
+ * An XOR-clause with value false is written with its last literal
+ * complemented.  In WCNF, the hard clauses are written with a top
+ * weight larger than the sum of the soft weights; XOR-clauses have to
+ * be translated into clauses before.
+ */
 class cnf_writer
 {
 public:
-  cnf_writer( std::ostream& os = std::cout )
-      : _os( os )
+  cnf_writer( std::ostream& os = std::cout, cnf_format format = cnf_format::dimacs, uint64_t buffer_size = 1u << 16u )
+      : _os( os ), _format( format ), _buffer( std::max<uint64_t>( buffer_size, 64u ) )
   {
   }
 
-  inline void apply( constraints& constraints )
+  inline void apply( const constraints& constraints )
   {
-    _os << "p cnf " << constraints.num_variables() << " " << ( constraints.num_clauses() + constraints.num_xor_clauses() ) << std::endl;
-    constraints.foreach_clause( [&]( constraints::clause_t const& cl ){
-        for ( const auto& l : cl )
+    if ( _format == cnf_format::wcnf )
+    {
+      write_wcnf( constraints );
+    }
+    else
+    {
+      write_dimacs( constraints );
+    }
+    flush();
+  }
+
+protected:
+  inline void write_dimacs( const constraints& constraints )
+  {
+    /* XOR-clauses without literals and value false are trivially satisfied */
+    auto num_xor_clauses = 0u;
+    constraints.foreach_xor_clause( [&]( xor_clause_view const& cl ){
+        num_xor_clauses += !cl.clause.empty() || cl.value;
+      });
+
+    write_string( "p cnf " );
+    write_number( constraints.num_variables() );
+    write_char( ' ' );
+    write_number( constraints.num_clauses() + num_xor_clauses );
+    write_char( '\n' );
+
+    constraints.foreach_clause( [&]( clause_view const& cl ){
+        write_literals( cl );
+      });
+
+    constraints.foreach_xor_clause( [&]( xor_clause_view const& cl ){
+        if ( cl.clause.empty() )
         {
-          _os << l << ' ';
+          if ( cl.value )
+          {
+            write_string( "0\n" );
+          }
+          return;
         }
-        _os << '0' << std::endl;
-      });
 
-    constraints.foreach_xor_clause( [&]( xor_clause_t const& cl ){
         if ( cl.clause.size() > 1 )
         {
-          _os << "x";
+          write_char( 'x' );
         }
         for ( auto i = 0u; i < cl.clause.size(); ++i )
         {
-          if ( !cl.value && i == cl.clause.size() - 1 )
-          {
-            _os << "-";
-          }
-          _os << cl.clause[i] << ' ';
+          write_number( ( !cl.value && i == cl.clause.size() - 1 ) ? -cl.clause[i] : cl.clause[i] );
+          write_char( ' ' );
+        }
+        write_string( "0\n" );
+      });
+  }
+
+  inline void write_wcnf( const constraints& constraints )
+  {
+    assert( constraints.num_xor_clauses() == 0u && "XOR-clauses cannot be written in WCNF" );
+
+    uint64_t top = 1u;
+    constraints.foreach_weighted_clause( [&]( clause_view const&, uint32_t weight ){
+        if ( weight != constraints.top_weight() )
+        {
+          top += weight;
         }
-        _os << "0" << std::endl;
       });
+
+    write_string( "p wcnf " );
+    write_number( constraints.num_variables() );
+    write_char( ' ' );
+    write_number( constraints.num_clauses() );
+    write_char( ' ' );
+    write_number( top );
+    write_char( '\n' );
+
+    constraints.foreach_weighted_clause( [&]( clause_view const& cl, uint32_t weight ){
+        write_number( weight == constraints.top_weight() ? top : weight );
+        write_char( ' ' );
+        write_literals( cl );
+      });
+  }
+
+  inline void write_literals( clause_view const& cl )
+  {
+    for ( const auto& l : cl )
+    {
+      write_number( l );
+      write_char( ' ' );
+    }
+    write_string( "0\n" );
+  }
+
+  template<typename T>
+  inline void write_number( T value )
+  {
+    /* enough for any 64-bit integer */
+    reserve( 24u );
+    auto const r = std::to_chars( _buffer.data() + _pos, _buffer.data() + _buffer.size(), value );
+    _pos = r.ptr - _buffer.data();
+  }
+
+  inline void write_char( char c )
+  {
+    reserve( 1u );
+    _buffer[_pos++] = c;
+  }
+
+  inline void write_string( char const* s )
+  {
+    while ( *s )
+    {
+      write_char( *s++ );
+    }
+  }
+
+  inline void reserve( uint64_t n )
+  {
+    if ( _pos + n > _buffer.size() )
+    {
+      flush();
+    }
+  }
+
+  inline void flush()
+  {
+    _os.write( _buffer.data(), _pos );
+    _pos = 0u;
   }
 
 protected:
   std::ostream& _os;
+  cnf_format _format;
+  std::vector<char> _buffer;
+  uint64_t _pos = 0u;
 };
 
 } // namespace easy::sat
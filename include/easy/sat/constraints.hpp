@@ -27,7 +27,10 @@
 
 #include <bill/bill.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <initializer_list>
 #include <memory>
 #include <vector>
 #include <iostream>
@@ -35,24 +38,110 @@
 namespace easy::sat
 {
 
-struct xor_clause_t
-{
-  std::vector<int> clause;
-  bool value;
-};
-
 struct wclause_t
 {
   std::vector<int> clause;
   uint32_t weight;
 };
 
-struct wxor_clause_t
+/*! \brief Read-only view of the literals of a stored clause
+ *
+ * The view is invalidated when clauses are added to or removed from
+ * the pool that stores the clause.
+ */
+class clause_view
 {
-  xor_clause_t xor_clause;
-  uint32_t weight;
-};
+public:
+  clause_view( const int* begin, const int* end )
+    : _begin( begin ), _end( end )
+  {
+  }
+
+  const int* begin() const { return _begin; }
+  const int* end() const { return _end; }
+  uint32_t size() const { return uint32_t( _end - _begin ); }
+  bool empty() const { return _begin == _end; }
+  int operator[]( uint32_t i ) const { assert( i < size() ); return _begin[i]; }
+
+  operator std::vector<int>() const { return std::vector<int>( _begin, _end ); }
+
+protected:
+  const int* _begin;
+  const int* _end;
+}; /* clause_view */
+
+/*! \brief Read-only view of a stored XOR-clause */
+struct xor_clause_view
+{
+  clause_view clause;
+  bool value;
+}; /* xor_clause_view */
+
+/*! \brief Clause pool in compressed sparse row layout
+ *
+ * The literals of all clauses are stored consecutively in one
+ * vector; the i-th clause spans the literals from offsets[i] to
+ * offsets[i + 1].
+ */
+class clause_pool
+{
+public:
+  uint32_t size() const
+  {
+    return uint32_t( _offsets.size() - 1u );
+  }
+
+  uint64_t num_literals() const
+  {
+    return _literals.size();
+  }
+
+  clause_view operator[]( uint32_t i ) const
+  {
+    assert( i < size() );
+    return clause_view( _literals.data() + _offsets[i], _literals.data() + _offsets[i + 1u] );
+  }
 
+  /*! \brief Adds a clause and returns its largest variable */
+  template<typename Iterator>
+  uint32_t add( Iterator begin, Iterator end )
+  {
+    uint32_t max_var = 0;
+    for ( auto it = begin; it != end; ++it )
+    {
+      _literals.push_back( *it );
+      max_var = std::max<uint32_t>( max_var, abs( *it ) );
+    }
+    _offsets.push_back( _literals.size() );
+    return max_var;
+  }
+
+  void reserve( uint32_t num_clauses, uint64_t num_literals )
+  {
+    _offsets.reserve( num_clauses + 1u );
+    _literals.reserve( num_literals );
+  }
+
+  /*! \brief Removes all clauses but keeps the allocated memory */
+  void clear()
+  {
+    _literals.clear();
+    _offsets.resize( 1u );
+  }
+
+protected:
+  std::vector<int> _literals;
+  std::vector<uint64_t> _offsets{0u};
+}; /* clause_pool */
+
+/*! \brief Clauses and XOR-clauses of a SAT problem
+ *
+ * Clauses with top weight (hard clauses), clauses with other weights
+ * (soft clauses), and XOR-clauses are stored in separate clause
+ * pools.  Hard clauses are visited before soft clauses.
+ *
+ * The constraints can be moved but not copied.
+ */
 class constraints
 {
 public:
@@ -65,6 +154,11 @@ public:
   {
   }
 
+  constraints( const constraints& ) = delete;
+  constraints& operator=( const constraints& ) = delete;
+  constraints( constraints&& ) = default;
+  constraints& operator=( constraints&& ) = default;
+
   weight_t top_weight() const
   {
     return _top_weight;
@@ -74,7 +168,7 @@ public:
   {
     _num_variables = nv;
   }
-  
+
   uint32_t num_variables() const
   {
     return _num_variables;
@@ -82,147 +176,153 @@ public:
 
   uint32_t num_clauses() const
   {
-    return _clauses.size();
+    return _hard_clauses.size() + _soft_clauses.size();
   }
 
   uint32_t num_xor_clauses() const
   {
     return _xor_clauses.size();
   }
-  
+
+  /*! \brief Reserves memory for hard clauses
+   *
+   * \param num_clauses Number of clauses
+   * \param num_literals Total number of literals of the clauses
+   */
+  void reserve_clauses( uint32_t num_clauses, uint64_t num_literals )
+  {
+    _hard_clauses.reserve( num_clauses, num_literals );
+  }
+
   void add_clause( const clause_t& clause )
   {
-    add_weighted_clause( wclause_t{clause, _top_weight} );
+    add_hard_clause( std::begin( clause ), std::end( clause ) );
+  }
+
+  void add_clause( std::initializer_list<int> clause )
+  {
+    add_hard_clause( std::begin( clause ), std::end( clause ) );
   }
 
   void add_xor_clause( const clause_t& clause, bool value = true )
   {
-    add_weighted_xor_clause( wclause_t{clause, _top_weight}, value );
+    add_weighted_xor_clause( clause, value, _top_weight );
   }
 
   void clear_clauses()
   {
-    _clauses.clear();
+    _hard_clauses.clear();
+    _soft_clauses.clear();
+    _soft_weights.clear();
   }
 
   void clear_xor_clauses()
   {
     _xor_clauses.clear();
+    _xor_values.clear();
+    _xor_weights.clear();
   }
 
-  void add_weighted_clause( const clause_t& cl, uint32_t weight )
+  /*! \brief Removes all clauses and variables but keeps the allocated memory */
+  void clear()
   {
-    add_weighted_clause( {cl, weight} );
+    clear_clauses();
+    clear_xor_clauses();
+    _num_variables = 0;
   }
-  
-  void add_weighted_clause( const wclause_t& cl )
+
+  void add_weighted_clause( const clause_t& cl, uint32_t weight )
   {
-    for ( const auto& c : cl.clause )
+    if ( weight == _top_weight )
+    {
+      add_hard_clause( std::begin( cl ), std::end( cl ) );
+    }
+    else
     {
-      uint32_t v = abs( c );
-      if ( v > _num_variables )
-      {
-        _num_variables = v;
-      }
+      update_num_variables( _soft_clauses.add( std::begin( cl ), std::end( cl ) ) );
+      _soft_weights.emplace_back( weight );
     }
-    _clauses.emplace_back( cl );
   }
 
-  void add_weighted_xor_clause( const clause_t& cl, bool value, uint32_t weight )
+  void add_weighted_clause( const wclause_t& cl )
   {
-    add_weighted_xor_clause( {cl, weight}, value );
+    add_weighted_clause( cl.clause, cl.weight );
   }
-  
-  void add_weighted_xor_clause( const wclause_t& cl, bool value = true )
+
+  void add_weighted_xor_clause( const clause_t& cl, bool value, uint32_t weight )
   {
-    for ( const auto& c : cl.clause )
-    {
-      uint32_t v = abs( c );
-      if ( v > _num_variables )
-      {
-        _num_variables = v;
-      }
-    }
-    xor_clause_t xor_clause{cl.clause, value};
-    _xor_clauses.emplace_back( wxor_clause_t{xor_clause, cl.weight} );
+    update_num_variables( _xor_clauses.add( std::begin( cl ), std::end( cl ) ) );
+    _xor_values.emplace_back( value );
+    _xor_weights.emplace_back( weight );
   }
 
-  template<typename Fn>
-  void foreach_clause( Fn const& fn )
+  void add_weighted_xor_clause( const wclause_t& cl, bool value = true )
   {
-    for ( const auto& c : _clauses )
-    {
-      fn( c.clause );
-    }
+    add_weighted_xor_clause( cl.clause, value, cl.weight );
   }
 
   template<typename Fn>
   void foreach_clause( Fn const& fn ) const
   {
-    for ( const auto& c : _clauses )
-    {
-      fn( c.clause );
-    }
+    foreach_weighted_clause( [&]( clause_view const& cl, uint32_t ){ fn( cl ); } );
   }
 
   template<typename Fn>
-  void foreach_xor_clause( Fn const& fn )
+  void foreach_xor_clause( Fn const& fn ) const
   {
-    for ( const auto& c : _xor_clauses )
-    {
-      fn( c.xor_clause );
-    }
+    foreach_weighted_xor_clause( [&]( xor_clause_view const& cl, uint32_t ){ fn( cl ); } );
   }
 
   template<typename Fn>
-  void foreach_xor_clause( Fn const& fn ) const
+  void foreach_weighted_clause( Fn const& fn ) const
   {
-    for ( const auto& c : _xor_clauses )
+    for ( auto i = 0u; i < _hard_clauses.size(); ++i )
     {
-      fn( c.xor_clause );
+      fn( _hard_clauses[i], _top_weight );
     }
-  }
-
-  template<typename Fn>
-  void foreach_weighted_clause( Fn const& fn )
-  {
-    for ( const auto& c : _clauses )
+    for ( auto i = 0u; i < _soft_clauses.size(); ++i )
     {
-      fn( c.clause, c.weight );
+      fn( _soft_clauses[i], _soft_weights[i] );
     }
   }
 
+  /*! \brief Visits the XOR-clauses
+   *
+   * Clauses (but no XOR-clauses) may be added while visiting.
+   */
   template<typename Fn>
-  void foreach_weighted_clause( Fn const& fn ) const
+  void foreach_weighted_xor_clause( Fn const& fn ) const
   {
-    for ( const auto& c : _clauses )
+    for ( auto i = 0u; i < _xor_clauses.size(); ++i )
     {
-      fn( c.clause, c.weight );
+      fn( xor_clause_view{_xor_clauses[i], _xor_values[i]}, _xor_weights[i] );
     }
   }
 
-  template<typename Fn>
-  void foreach_weighted_xor_clause( Fn const& fn )
+protected:
+  template<typename Iterator>
+  void add_hard_clause( Iterator begin, Iterator end )
   {
-    for ( const auto& c : _xor_clauses )
-    {
-      fn( c.xor_clause, c.weight );
-    }
+    update_num_variables( _hard_clauses.add( begin, end ) );
   }
 
-  template<typename Fn>
-  void foreach_weighted_xor_clause( Fn const& fn ) const
+  void update_num_variables( uint32_t max_var )
   {
-    for ( const auto& c : _xor_clauses )
-    {
-      fn( c.xor_clause, c.weight );
-    }
+    _num_variables = std::max( _num_variables, max_var );
   }
 
 protected:
   weight_t _top_weight;
-  std::vector<wclause_t> _clauses;
-  std::vector<wxor_clause_t> _xor_clauses;
+
+  clause_pool _hard_clauses;
+
+  clause_pool _soft_clauses;
+  std::vector<weight_t> _soft_weights;
+
+  clause_pool _xor_clauses;
+  std::vector<bool> _xor_values;
+  std::vector<weight_t> _xor_weights;
+
   uint32_t _num_variables = 0;
 }; /* constraints */
 
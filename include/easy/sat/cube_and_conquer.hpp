@@ -0,0 +1,144 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <easy/sat/sat_solver.hpp>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace easy::sat
+{
+
+struct cube_and_conquer_params
+{
+  /*! Number of threads used to solve the cubes */
+  uint32_t num_threads = std::max( 1u, std::thread::hardware_concurrency() );
+  /*! Conflict limit per thread (-1 indicates no conflict limit) */
+  int conflict_limit = -1;
+}; /* cube_and_conquer_params */
+
+/*! \brief Cube-and-conquer
+ *
+ * Solves a SAT problem by splitting it into cubes, i.e., conjunctions
+ * of literals, which are solved in parallel under assumptions.  The
+ * cubes must cover the search space.  Each thread owns a SAT-solver
+ * that incrementally solves the cubes assigned to it.
+ *
+ * The search terminates as soon as one cube is satisfiable, in which
+ * case the remaining solvers are interrupted through their atomic
+ * stop flags (see sat_solver::interrupt) and give up within a few
+ * conflicts.  The problem is unsatisfiable if all cubes are
+ * unsatisfiable.
+ *
+ * \param constraints Constraints without XOR-clauses
+ * \param cubes Cubes, each given as a vector of literals
+ * \param ps Parameters
+ * \return Satisfiability result
+ */
+inline sat_solver::result cube_and_conquer( const constraints& constraints, const std::vector<sat_solver::assumptions_t>& cubes, const cube_and_conquer_params& ps = {} )
+{
+  assert( ps.num_threads >= 1u );
+
+  std::mutex mutex;
+  std::atomic<uint64_t> next_cube{0};
+  std::atomic<bool> done{false};
+  bool unknown = false;
+  sat_solver::result sat( Glucose::l_False );
+  std::vector<sat_solver*> solvers;
+
+  const auto worker = [&]() {
+    sat_solver solver;
+    if ( ps.conflict_limit != -1 )
+    {
+      solver.set_conflict_limit( ps.conflict_limit );
+    }
+
+    {
+      std::lock_guard<std::mutex> lock( mutex );
+      if ( done )
+      {
+        return;
+      }
+      solvers.emplace_back( &solver );
+    }
+
+    solver.add_constraints( constraints );
+
+    sat::constraints empty;
+    for ( auto i = next_cube++; i < cubes.size() && !done; i = next_cube++ )
+    {
+      const auto r = solver.solve( empty, cubes[i] );
+      if ( r.is_sat() )
+      {
+        std::lock_guard<std::mutex> lock( mutex );
+        if ( !done.exchange( true ) )
+        {
+          sat = r;
+          for ( const auto& s : solvers )
+          {
+            s->interrupt();
+          }
+        }
+      }
+      else if ( r.is_undef() && !done )
+      {
+        std::lock_guard<std::mutex> lock( mutex );
+        unknown = true;
+      }
+    }
+
+    std::lock_guard<std::mutex> lock( mutex );
+    solvers.erase( std::find( solvers.begin(), solvers.end(), &solver ) );
+  };
+
+  std::vector<std::thread> threads;
+  for ( auto i = 1u; i < std::min<uint64_t>( ps.num_threads, cubes.size() ); ++i )
+  {
+    threads.emplace_back( worker );
+  }
+  worker();
+  for ( auto& t : threads )
+  {
+    t.join();
+  }
+
+  if ( !sat.is_sat() && unknown )
+  {
+    return sat_solver::result( Glucose::l_Undef );
+  }
+  return sat;
+}
+
+} // namespace easy::sat
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -26,6 +26,7 @@
 #pragma once
 
 #include <easy/sat/sat_solver.hpp>
+#include <easy/utils/trace.hpp>
 
 namespace easy::sat
 {
@@ -37,6 +38,8 @@ public:
 
   bool apply( constraints& constraints )
   {
+    utils::trace_span span( "gauss_elimination::apply", "sat" );
+
     auto A = make_matrix( constraints );
     matrix_make_upper_triangular_binary( A );
 
@@ -63,7 +66,7 @@ public:
       }
       else if ( !clause.empty() )
       {
-        constraints.add_weighted_xor_clause( sat::wclause_t{clause, 0u}, row[row.size() - 1u] );
+        constraints.add_weighted_xor_clause( clause, row[row.size() - 1u], 0u );
       }
     }
 
@@ -75,7 +78,7 @@ protected:
   {
     auto num_variables = constraints.num_variables();
     std::vector<std::vector<bool>> matrix;
-    constraints.foreach_xor_clause( [&]( xor_clause_t const& cl ){
+    constraints.foreach_xor_clause( [&]( xor_clause_view const& cl ){
         std::vector<bool> row( num_variables + 1 );
         auto sum = 0u;
         for ( const auto& l : cl.clause )
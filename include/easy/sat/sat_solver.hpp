@@ -26,13 +26,62 @@
 #pragma once
 
 #include <easy/sat/constraints.hpp>
+#include <easy/utils/trace.hpp>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
 namespace easy::sat
 {
 
+namespace detail
+{
+
+/*! \brief Glucose solver with access to the learnt clauses */
+class glucose_solver : public Glucose::Solver
+{
+public:
+  /*! \brief Iterates over the learnt clauses
+   *
+   * Calls fn for each learnt clause and each unit fixed at decision
+   * level 0.  The literals are passed in DIMACS notation.
+   *
+   * \param fn Callback taking a `std::vector<int> const&`
+   */
+  template<typename Fn>
+  void foreach_learnt_clause( Fn&& fn ) const
+  {
+    std::vector<int> clause;
+    const auto to_dimacs = []( Glucose::Lit l ) { return Glucose::sign( l ) ? -( Glucose::var( l ) + 1 ) : ( Glucose::var( l ) + 1 ); };
+
+    const auto num_units = trail_lim.size() > 0 ? trail_lim[0] : trail.size();
+    for ( auto i = 0; i < num_units; ++i )
+    {
+      clause = {to_dimacs( trail[i] )};
+      fn( clause );
+    }
+
+    for ( const auto& db : {&learnts, &permanentLearnts} )
+    {
+      for ( auto i = 0; i < db->size(); ++i )
+      {
+        const auto& c = ca[( *db )[i]];
+        clause.resize( c.size() );
+        for ( auto j = 0; j < c.size(); ++j )
+        {
+          clause[j] = to_dimacs( c[j] );
+        }
+        fn( clause );
+      }
+    }
+  }
+}; /* glucose_solver */
+
+} // namespace detail
+
 struct sat_solver
 {
   using assumptions_t = std::vector<int>;
@@ -51,6 +100,11 @@ struct sat_solver
     {
     }
 
+    result( model_t&& m )
+      : state( Glucose::l_True ), model( std::move( m ) )
+    {
+    }
+
     inline operator bool() const { return ( state == Glucose::l_True ); }
 
     inline bool is_sat() const { return ( state == Glucose::l_True ); }
@@ -61,37 +115,129 @@ struct sat_solver
     model_t model;
   }; /* result */
 
+  /*! \brief Read-only view of the model of the last satisfiable call
+   *
+   * The view reads the model of the solver in place and is invalidated
+   * by the next call to solve.
+   */
+  struct model_view
+  {
+    inline Glucose::lbool operator[]( uint32_t var ) const { return ( *values )[var]; }
+    inline uint32_t size() const { return values->size(); }
+
+    const Glucose::vec<Glucose::lbool>* values;
+  }; /* model_view */
+
   sat_solver();
   result solve( constraints& constraints, const assumptions_t& assumptions = {} );
+  void add_constraints( const constraints& constraints );
+  void reserve_variables( uint32_t num_vars );
   void reset();
 
+  void set_lazy_model( bool lazy );
+  model_view get_model() const;
+
   void set_conflict_limit( int limit );
   int get_conflicts() const;
+  uint64_t get_decisions() const;
+  uint64_t get_propagations() const;
+
+  void set_phase( int lit );
+  void interrupt();
+
+  std::vector<std::vector<int>> export_learnt_clauses( uint32_t max_size, uint32_t max_var ) const;
+  void import_learnt_clauses( const std::vector<std::vector<int>>& clauses );
+
+  template<typename Clause>
+  void add_clause_buffered( const Clause& clause );
 
   unsigned _num_vars = 0;
 
   /* -1 indicates no conflict limit */
   int _conflict_limit = -1;
 
-  std::unique_ptr<Glucose::Solver> _solver;
+  /* number of conflicts at which the conflict limit is reached (-1 indicates no conflict limit) */
+  int64_t _conflict_budget = -1;
+
+  /* number of conflicts after which the search checks for an interrupt */
+  static constexpr int64_t interrupt_poll_conflicts = 1000;
+
+  /* set by interrupt, possibly from another thread */
+  std::atomic<bool> _interrupted{false};
+
+  /* if true, solve does not copy the model into the result */
+  bool _lazy_model = false;
+
+  /* literal buffer reused for all clauses and assumptions */
+  Glucose::vec<Glucose::Lit> _lits;
+
+  std::unique_ptr<detail::glucose_solver> _solver;
 };
 
 inline sat_solver::sat_solver()
 {
-  _solver = std::make_unique<Glucose::Solver>();
+  _solver = std::make_unique<detail::glucose_solver>();
 }
 
 inline void sat_solver::reset()
 {
-  _solver = std::make_unique<Glucose::Solver>();
+  _solver = std::make_unique<detail::glucose_solver>();
   _num_vars = 0;
-  _solver->budgetOff();
+  _conflict_budget = -1;
+  _interrupted.store( false, std::memory_order_relaxed );
 }
 
 inline void sat_solver::set_conflict_limit( int limit )
 {
   _conflict_limit = limit;
-  _solver->setConfBudget( limit );
+  _conflict_budget = limit < 0 ? -1 : int64_t( _solver->conflicts ) + limit;
+}
+
+/*! \brief Ensures that the variables 1, ..., num_vars exist
+ *
+ * \param num_vars Number of variables
+ */
+inline void sat_solver::reserve_variables( uint32_t num_vars )
+{
+  while ( _num_vars < num_vars )
+  {
+    _solver->newVar();
+    ++_num_vars;
+  }
+}
+
+/*! \brief Disables copying the model into the result of solve
+ *
+ * If enabled, the result of a satisfiable call to solve has an empty
+ * model; the model is then read in place with get_model.
+ *
+ * \param lazy Flag
+ */
+inline void sat_solver::set_lazy_model( bool lazy )
+{
+  _lazy_model = lazy;
+}
+
+/*! \brief Returns a view of the model of the last satisfiable call */
+inline sat_solver::model_view sat_solver::get_model() const
+{
+  return model_view{&_solver->model};
+}
+
+/*! \brief Adds a clause through the literal buffer
+ *
+ * The variables of the clause must have been reserved.
+ */
+template<typename Clause>
+inline void sat_solver::add_clause_buffered( const Clause& clause )
+{
+  _lits.clear();
+  for ( const auto& l : clause )
+  {
+    assert( uint32_t( abs( l ) ) <= _num_vars );
+    _lits.push( Glucose::mkLit( abs( l ) - 1, l < 0 ) );
+  }
+  _solver->addClause_( _lits );
 }
 
 inline int sat_solver::get_conflicts() const
@@ -99,23 +245,104 @@ inline int sat_solver::get_conflicts() const
   return _solver->conflicts;
 }
 
-inline sat_solver::result sat_solver::solve( constraints& constraints, const assumptions_t& assumptions )
+inline uint64_t sat_solver::get_decisions() const
 {
-  /* add clauses to solver & remove them from constraints */
-  constraints.foreach_clause( [&]( constraints::clause_t const& c ){
-      Glucose::vec<Glucose::Lit> clause;
-      for ( const auto& l : c )
+  return _solver->decisions;
+}
+
+inline uint64_t sat_solver::get_propagations() const
+{
+  return _solver->propagations;
+}
+
+/*! \brief Sets the preferred polarity of a variable
+ *
+ * The decision heuristic branches first on the given literal.  This
+ * allows to seed the search with a known (partial) assignment.
+ *
+ * \param lit A literal
+ */
+inline void sat_solver::set_phase( int lit )
+{
+  assert( lit != 0 );
+  reserve_variables( abs( lit ) );
+  _solver->setPolarity( abs( lit ) - 1, lit < 0 );
+}
+
+/*! \brief Interrupts the search
+ *
+ * Can be called from another thread.  The current call to solve (or,
+ * if no search is running, the next one) returns an undefined result
+ * after at most interrupt_poll_conflicts further conflicts, as do all
+ * later calls until reset.
+ */
+inline void sat_solver::interrupt()
+{
+  _interrupted.store( true, std::memory_order_relaxed );
+}
+
+/*! \brief Adds the clauses of the constraints to the solver
+ *
+ * In contrast to solve, the constraints are not modified, such that
+ * they can be shared among several solvers.
+ *
+ * \param constraints Constraints without XOR-clauses
+ */
+inline void sat_solver::add_constraints( const constraints& constraints )
+{
+  assert( constraints.num_xor_clauses() == 0u );
+  reserve_variables( constraints.num_variables() );
+  constraints.foreach_clause( [&]( clause_view const& c ){
+      add_clause_buffered( c );
+    });
+}
+
+/*! \brief Exports learnt clauses
+ *
+ * Returns the learnt clauses with at most max_size literals that only
+ * refer to the variables 1, ..., max_var.
+ *
+ * \param max_size Maximum number of literals of a clause
+ * \param max_var Largest variable id of an exported clause
+ */
+inline std::vector<std::vector<int>> sat_solver::export_learnt_clauses( uint32_t max_size, uint32_t max_var ) const
+{
+  std::vector<std::vector<int>> clauses;
+  _solver->foreach_learnt_clause( [&]( const std::vector<int>& clause ){
+      if ( clause.size() <= max_size &&
+           std::all_of( clause.begin(), clause.end(), [&]( int l ){ return uint32_t( abs( l ) ) <= max_var; } ) )
       {
-        const unsigned var = abs( l ) - 1;
-        while ( _num_vars <= var )
-        {
-          _solver->newVar();
-          ++_num_vars;
-        }
-        clause.push( Glucose::mkLit( var, l < 0 ) );
+        clauses.emplace_back( clause );
       }
-      _solver->addClause( clause );
     });
+  return clauses;
+}
+
+/*! \brief Imports clauses learnt by another solver
+ *
+ * The caller has to ensure that the clauses are implied by the
+ * constraints of this solver.
+ *
+ * \param clauses Clauses
+ */
+inline void sat_solver::import_learnt_clauses( const std::vector<std::vector<int>>& clauses )
+{
+  for ( const auto& c : clauses )
+  {
+    for ( const auto& l : c )
+    {
+      reserve_variables( abs( l ) );
+    }
+    add_clause_buffered( c );
+  }
+}
+
+inline sat_solver::result sat_solver::solve( constraints& constraints, const assumptions_t& assumptions )
+{
+  utils::trace_span span( "sat_solver::solve", "sat" );
+
+  /* add clauses to solver & remove them from constraints */
+  add_constraints( constraints );
   constraints.clear_clauses();
 
   /* add xor clauses to solver & remove them from constraints */
@@ -123,47 +350,60 @@ inline sat_solver::result sat_solver::solve( constraints& constraints, const ass
 
   bool sat;
 
-  Glucose::vec<Glucose::Lit> assume;
-  if ( assumptions.size() > 0 )
+  for ( const auto& v : assumptions )
+  {
+    reserve_variables( abs( v ) );
+  }
+  _lits.clear();
+  for ( const auto& v : assumptions )
+  {
+    _lits.push( Glucose::mkLit( abs( v ) - 1, v < 0 ) );
+  }
+
+  /* Glucose's own interrupt flag is not synchronized, hence the search
+     runs in slices of conflicts, between which the atomic flag is checked;
+     an interrupted search is reported as undefined even without conflict limit */
+  auto solver_result = Glucose::l_Undef;
+  while ( !_interrupted.load( std::memory_order_relaxed ) )
   {
-    for ( const auto& v : assumptions )
+    auto const conflicts = int64_t( _solver->conflicts );
+    auto slice_end = conflicts + interrupt_poll_conflicts;
+    if ( _conflict_budget != -1 )
     {
-      const unsigned var = abs( v ) - 1;
-      while ( _num_vars <= var )
+      if ( conflicts >= _conflict_budget )
       {
-        _solver->newVar();
-        ++_num_vars;
+        break;
       }
-      assume.push( Glucose::mkLit( var, v < 0 ) );
+      slice_end = std::min( slice_end, _conflict_budget );
+    }
+
+    _solver->setConfBudget( slice_end - conflicts );
+    solver_result = _solver->solveLimited( _lits );
+    if ( solver_result != Glucose::l_Undef )
+    {
+      break;
     }
   }
 
-  if ( _conflict_limit == -1 )
+  if ( solver_result == Glucose::l_Undef || ( _conflict_limit != -1 && int32_t(_solver->conflicts) >= _conflict_limit ) )
   {
-    sat = _solver->solve( assume );
+    return result( Glucose::l_Undef );
   }
   else
   {
-    const auto solver_result = _solver->solveLimited( assume );
-    if ( solver_result == Glucose::l_Undef || int32_t(_solver->conflicts) >= _conflict_limit )
-    {
-      return result( Glucose::l_Undef );
-    }
-    else
-    {
-      assert( solver_result == Glucose::l_True || solver_result == Glucose::l_False );
-      sat = solver_result == Glucose::l_True;
-    }
+    assert( solver_result == Glucose::l_True || solver_result == Glucose::l_False );
+    sat = solver_result == Glucose::l_True;
   }
 
-  if ( sat )
+  if ( sat && !_lazy_model )
   {
-    std::vector<Glucose::lbool> model( _num_vars );
-    for ( auto i = 0u; i < _num_vars; ++i )
+    const auto& values = _solver->model;
+    model_t model( values.size() );
+    for ( auto i = 0; i < values.size(); ++i )
     {
-      model[i] = _solver->modelValue( i );
+      model[i] = values[i];
     }
-    return result( model );
+    return result( std::move( model ) );
   }
   else
   {
@@ -26,6 +26,7 @@
 #pragma once
 
 #include <easy/sat/sat_solver.hpp>
+#include <easy/utils/trace.hpp>
 #include <queue>
 
 namespace easy::sat
@@ -39,7 +40,7 @@ public:
   {
   }
 
-  inline void add_xor_clause( constraints& constraints, const std::vector<int>& xor_clause, bool value )
+  inline void add_xor_clause( constraints& constraints, clause_view xor_clause, bool value )
   {
     assert( !xor_clause.empty() && "clause must not be empty" );
 
@@ -78,7 +79,9 @@ public:
 
   inline void apply( constraints& constraints )
   {
-    constraints.foreach_xor_clause([&]( xor_clause_t const& cl ){
+    utils::trace_span span( "xor_clauses_to_cnf::apply", "sat" );
+
+    constraints.foreach_xor_clause([&]( xor_clause_view const& cl ){
         add_xor_clause( constraints, cl.clause, cl.value );
       });
     constraints.clear_xor_clauses();
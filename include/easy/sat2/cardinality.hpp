@@ -25,180 +25,953 @@
 
 /*!
   \file cardinality.hpp
-  \brief Iterative totalizer cardinality constraints
+  \brief Cardinality constraints
 
   \author Heinz Riener
 
-  This implementation is based on the code of Antonio Morgado and
-  Alexey S. Ignatiev in [1]. For a seminal reference, see [2].
+  The iterative totalizer is based on the code of Antonio Morgado and
+  Alexey S. Ignatiev in [1]. For a seminal reference, see [2].  The
+  other encodings follow [3] (sequential counter), [4] (cardinality
+  networks), [5] (parallel binary adders), [6] (product encoding),
+  and [7] (commander encoding).
 
   [1] https://github.com/pysathq/pysat/blob/master/cardenc/itot.hh.
 
   [2] Ruben Martins, Saurabh Joshi, Vasco M. Manquinho, Inês Lynce:
   Incremental Cardinality Constraints for MaxSAT. CP 2014: 531-548
+
+  [3] Carsten Sinz: Towards an Optimal CNF Encoding of Boolean
+  Cardinality Constraints. CP 2005: 827-831
+
+  [4] Roberto Asín, Robert Nieuwenhuis, Albert Oliveras, Enric
+  Rodríguez-Carbonell: Cardinality Networks: a theoretical and
+  empirical study. Constraints 16(2): 195-221 (2011)
+
+  [5] Joost P. Warners: A Linear-Time Transformation of Linear
+  Inequalities into Conjunctive Normal Form. Inf. Process. Lett.
+  68(2): 63-69 (1998)
+
+  [6] Jingchao Chen: A New SAT Encoding of the At-Most-One
+  Constraint. ModRef 2010
+
+  [7] Will Klieber, Gihwon Kwon: Efficient CNF Encoding for Selecting
+  1 from N Objects. CFV 2007
 */
 
 #pragma once
 
-#include <deque>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace easy::sat2
 {
 
-struct totalizer_tree
+namespace detail
 {
-  std::vector<int> vars;
-  uint32_t num_inputs;
-  std::shared_ptr<totalizer_tree> left;
-  std::shared_ptr<totalizer_tree> right; 
-}; /* totalizer_tree */
 
-namespace detail
+/* passes a clause to a SAT-solver, MAXSAT-solver, or constraints object */
+template<typename Sink>
+inline void add_clause_to_sink( Sink& sink, std::vector<int> const& clause )
 {
+  sink.add_clause( clause );
+}
 
-inline void create_totalizer_internal( std::vector<std::vector<int>>& dest, int& sid, std::vector<int> const& ov, uint32_t rhs, std::vector<int> const& av, std::vector<int> const& bv )
+/* collects a clause in a vector of clauses */
+inline void add_clause_to_sink( std::vector<std::vector<int>>& sink, std::vector<int> const& clause )
+{
+  sink.emplace_back( clause );
+}
+
+} /* namespace detail */
+
+/*! \brief Arena of iterative totalizer trees
+ *
+ * The nodes of all trees are stored in one vector and refer to their
+ * children by index.  The i-th output of a node is implied if at
+ * least i + 1 of its inputs are true; a node with n inputs created
+ * for bound rhs has min(rhs + 1, n) outputs, such that the clauses
+ * grow with the bound rather than with the number of inputs.
+ *
+ * The clauses are passed to a sink, i.e., an object with a method
+ * `add_clause( std::vector<int> const& )` such as sat_solver, or a
+ * vector of clauses.
+ */
+class totalizer_arena
 {
-  /* i = 0 */
-  uint32_t kmin = std::min( rhs, uint32_t( bv.size() ) );
-  for ( auto j = 0; j < kmin; ++j )
+public:
+  using node_id = uint32_t;
+
+  static constexpr node_id null_node = std::numeric_limits<node_id>::max();
+
+  struct node
+  {
+    std::vector<int> vars;
+    uint32_t num_inputs;
+    node_id left;
+    node_id right;
+  }; /* node */
+
+public:
+  /*! \brief Returns the node with id `t` */
+  node const& operator[]( node_id t ) const
+  {
+    assert( t < _nodes.size() );
+    return _nodes[t];
+  }
+
+  /*! \brief Returns the output literals of node `t` */
+  std::vector<int> const& vars( node_id t ) const
   {
-    dest.emplace_back( std::vector<int>{ -bv[j], ov[j] } );
+    assert( t < _nodes.size() );
+    return _nodes[t].vars;
   }
 
-  /* j = 0 */
-  kmin = std::min( rhs, uint32_t( av.size() ) );
-  for ( auto i = 0; i < kmin; ++i )
+  /*! \brief Returns the number of nodes */
+  uint32_t size() const
   {
-    dest.emplace_back( std::vector<int>{ -av[i], ov[i] } );
+    return uint32_t( _nodes.size() );
   }
-  
-  /* i, j > 0 */
-  for ( auto i = 1; i <= kmin; ++i )
+
+  /*! \brief Removes all nodes but keeps the allocated memory */
+  void clear()
   {
-    auto const min_j = std::min( rhs-i, uint32_t( bv.size() ) );
-    for ( auto j = 1; j <= min_j; ++j )
+    _nodes.clear();
+  }
+
+  /*! \brief Creates a totalizer over `lhs` for bound `rhs`
+   *
+   * \param sink Receives the clauses
+   * \param sid Next free variable id
+   * \param lhs Input literals (must not be empty)
+   * \param rhs Bound
+   *
+   * Returns the root of the totalizer.
+   */
+  template<typename Sink>
+  node_id create( Sink& sink, int& sid, std::vector<int> const& lhs, uint32_t rhs )
+  {
+    assert( !lhs.empty() );
+
+    /* queue of subtrees that remain to be merged */
+    _queue.clear();
+    for ( const auto& l : lhs )
+    {
+      _queue.emplace_back( uint32_t( _nodes.size() ) );
+      _nodes.push_back( node{{l}, 1u, null_node, null_node} );
+    }
+
+    for ( auto head = 0u; head + 1u < _queue.size(); head += 2u )
+    {
+      _queue.emplace_back( make_node( sink, sid, _queue[head], _queue[head + 1u], rhs ) );
+    }
+    return _queue.back();
+  }
+
+  /*! \brief Increases the bound of the totalizer rooted in `t` to `rhs`
+   *
+   * Only the nodes with less than min(rhs + 1, n) outputs are visited.
+   */
+  template<typename Sink>
+  void increase( Sink& sink, int& sid, node_id t, uint32_t rhs )
+  {
+    /* collect the nodes to be increased in pre-order */
+    _queue.clear();
+    _stack.clear();
+    _stack.emplace_back( t );
+    while ( !_stack.empty() )
+    {
+      auto const n = _stack.back();
+      _stack.pop_back();
+
+      auto const& nd = _nodes[n];
+      if ( nd.left == null_node || std::min( rhs + 1u, nd.num_inputs ) <= nd.vars.size() )
+      {
+        continue;
+      }
+
+      _queue.emplace_back( n );
+      _stack.emplace_back( nd.left );
+      _stack.emplace_back( nd.right );
+    }
+
+    /* children before parents */
+    for ( auto it = _queue.rbegin(); it != _queue.rend(); ++it )
+    {
+      increase_node( sink, sid, *it, std::min( rhs + 1u, _nodes[*it].num_inputs ) );
+    }
+  }
+
+  /*! \brief Merges the totalizers rooted in `a` and `b` for bound `rhs` */
+  template<typename Sink>
+  node_id merge( Sink& sink, int& sid, node_id a, node_id b, uint32_t rhs )
+  {
+    increase( sink, sid, a, rhs );
+    increase( sink, sid, b, rhs );
+    return make_node( sink, sid, a, b, rhs );
+  }
+
+  /*! \brief Extends the totalizer rooted in `a` by the inputs `lhs` */
+  template<typename Sink>
+  node_id extend( Sink& sink, int& sid, node_id a, std::vector<int> const& lhs, uint32_t rhs )
+  {
+    auto const b = create( sink, sid, lhs, rhs );
+    return merge( sink, sid, a, b, rhs );
+  }
+
+protected:
+  template<typename Sink>
+  node_id make_node( Sink& sink, int& sid, node_id a, node_id b, uint32_t rhs )
+  {
+    auto const num_inputs = _nodes[a].num_inputs + _nodes[b].num_inputs;
+    auto const t = uint32_t( _nodes.size() );
+    _nodes.push_back( node{{}, num_inputs, a, b} );
+    increase_node( sink, sid, t, std::min( rhs + 1u, num_inputs ) );
+    return t;
+  }
+
+  /* extends the outputs of node t to `size` literals, given that its children have enough outputs */
+  template<typename Sink>
+  void increase_node( Sink& sink, int& sid, node_id t, uint32_t size )
+  {
+    auto& ov = _nodes[t].vars;
+    auto const& av = _nodes[_nodes[t].left].vars;
+    auto const& bv = _nodes[_nodes[t].right].vars;
+
+    uint32_t const last = ov.size();
+    for ( auto i = last; i < size; ++i )
+    {
+      ov.emplace_back( sid++ );
+    }
+
+    /* i = 0 */
+    uint32_t const max_j = std::min( size, uint32_t( bv.size() ) );
+    for ( auto j = last; j < max_j; ++j )
+    {
+      emit( sink, { -bv[j], ov[j] } );
+    }
+
+    /* j = 0 */
+    uint32_t const max_i = std::min( size, uint32_t( av.size() ) );
+    for ( auto i = last; i < max_i; ++i )
+    {
+      emit( sink, { -av[i], ov[i] } );
+    }
+
+    /* i, j > 0 */
+    for ( auto i = 1u; i <= max_i; ++i )
     {
-      dest.emplace_back( std::vector<int>{ -av[i-1], -bv[j-1], ov[i+j-1] } );
+      auto const max_j = std::min( size - i, uint32_t( bv.size() ) );
+      auto const min_j = std::max( int( last ) - int( i ) + 1, 1 );
+      for ( auto j = uint32_t( min_j ); j <= max_j; ++j )
+      {
+        emit( sink, { -av[i - 1], -bv[j - 1], ov[i + j - 1] } );
+      }
     }
-  }  
+  }
+
+  template<typename Sink>
+  void emit( Sink& sink, std::initializer_list<int> lits )
+  {
+    _clause.assign( lits );
+    detail::add_clause_to_sink( sink, _clause );
+  }
+
+protected:
+  std::vector<node> _nodes;
+
+  /* buffers */
+  std::vector<node_id> _queue;
+  std::vector<node_id> _stack;
+  std::vector<int> _clause;
+}; /* totalizer_arena */
+
+/*! \brief Encodings of at-most-k constraints */
+enum class cardinality_encoding
+{
+  /*! \brief Chosen from the size of the constraint */
+  automatic = 0,
+  /*! \brief Iterative totalizer, O(n k) clauses */
+  totalizer = 1,
+  /*! \brief Sequential counter, O(n k) clauses */
+  sequential_counter = 2,
+  /*! \brief Cardinality network of odd-even merges, O(n log^2 k) clauses */
+  sorting_network = 3,
+  /*! \brief Parallel binary adders with comparator, O(n) clauses */
+  adder = 4,
+}; /* cardinality_encoding */
+
+/*! \brief Encodings of at-most-one constraints */
+enum class at_most_one_encoding
+{
+  /*! \brief Chosen from the number of literals */
+  automatic = 0,
+  /*! \brief All pairs of literals, O(n^2) clauses */
+  pairwise = 1,
+  /*! \brief Two-dimensional product encoding, 2n + O(sqrt(n)) clauses */
+  product = 2,
+  /*! \brief Commander encoding with groups of three literals, O(n) clauses */
+  commander = 3,
+}; /* at_most_one_encoding */
+
+/*! \brief Encoded at-most-k constraint
+ *
+ * For the unary encodings (totalizer, sequential counter, sorting
+ * network), the i-th output is implied if at least i + 1 inputs are
+ * true.  For the adder encoding, the outputs are the bits of the sum
+ * of the inputs, least significant bit first.
+ */
+struct cardinality_constraint
+{
+  /*! \brief Encoding (never automatic) */
+  cardinality_encoding encoding{cardinality_encoding::totalizer};
+
+  /*! \brief Number of inputs */
+  uint32_t num_inputs{0};
+
+  /*! \brief Output literals */
+  std::vector<int> outputs;
+}; /* cardinality_constraint */
+
+namespace detail
+{
+
+/* number of comparators of a half merger of two sorted sequences of length p */
+inline uint64_t num_hmerge_comparators( uint64_t p )
+{
+  return p == 1u ? 1u : 2u * num_hmerge_comparators( p / 2u ) + p - 1u;
 }
 
-inline void increase_totalizer_internal( std::vector<std::vector<int>>& dest, int& sid, std::vector<int>& ov, uint32_t rhs, std::vector<int>& av, std::vector<int>& bv )
+/* number of comparators of a half sorter of n inputs */
+inline uint64_t num_hsort_comparators( uint64_t n )
 {
-  uint32_t last = ov.size();
-  for ( auto i = last; i < rhs; ++i )
+  return n <= 1u ? 0u : 2u * num_hsort_comparators( n / 2u ) + num_hmerge_comparators( n / 2u );
+}
+
+/* number of comparators of a simplified merger of two sorted sequences of length p */
+inline uint64_t num_smerge_comparators( uint64_t p )
+{
+  return p == 1u ? 1u : 2u * num_smerge_comparators( p / 2u ) + p / 2u;
+}
+
+/* smallest power of 2 that is greater than or equal to n */
+inline uint32_t next_power_of_two( uint32_t n )
+{
+  uint32_t m = 1u;
+  while ( m < n )
   {
-    ov.emplace_back( sid++ );
+    m <<= 1u;
   }
+  return m;
+}
+
+} /* namespace detail */
 
-  // add the constraints
-  /* i = 0 */
-  uint32_t const max_j = std::min( rhs, uint32_t( bv.size() ) );
-  for ( auto j = last; j < max_j; ++j )
+/*! \brief Estimates the number of clauses of an at-most-k encoding
+ *
+ * \param encoding Encoding (not automatic)
+ * \param n Number of inputs
+ * \param k_max Largest bound
+ */
+inline uint64_t estimate_cardinality_clauses( cardinality_encoding encoding, uint32_t n, uint32_t k_max )
+{
+  if ( n == 0u )
   {
-    dest.emplace_back( std::vector<int>{ -bv[j], ov[j] } );
+    return 0u;
   }
 
-  /* j = 0 */
-  uint32_t const max_i = std::min( rhs, uint32_t( av.size() ) );
-  for ( auto i = last; i < max_i; ++i )
+  uint64_t const m = std::min( k_max, n - 1u ) + 1u;
+  switch ( encoding )
   {
-    dest.emplace_back( std::vector<int>{ -av[i], ov[i] } );
+  case cardinality_encoding::totalizer:
+    {
+      /* (inputs, outputs) of the nodes in the order of totalizer_arena::create */
+      std::vector<std::pair<uint64_t, uint64_t>> queue( n, {1u, 1u} );
+      uint64_t count = 0u;
+      for ( auto head = 0u; head + 1u < queue.size(); head += 2u )
+      {
+        auto const [na, a] = queue[head];
+        auto const [nb, b] = queue[head + 1u];
+        auto const size = std::min( m, na + nb );
+        count += a + b;
+        for ( auto i = 1u; i <= a && i < size; ++i )
+        {
+          count += std::min( b, size - i );
+        }
+        queue.emplace_back( na + nb, size );
+      }
+      return count;
+    }
+  case cardinality_encoding::sequential_counter:
+    return 2u * n * m;
+  case cardinality_encoding::sorting_network:
+    {
+      uint64_t const p = detail::next_power_of_two( uint32_t( m ) );
+      uint64_t const num_blocks = ( n + p - 1u ) / p;
+      return 3u * ( num_blocks * detail::num_hsort_comparators( p ) + ( num_blocks - 1u ) * detail::num_smerge_comparators( p ) );
+    }
+  case cardinality_encoding::adder:
+    {
+      /* about one full adder per input and a comparator per bound */
+      uint64_t num_bits = 0u;
+      while ( ( uint64_t( 1u ) << num_bits ) <= n )
+      {
+        ++num_bits;
+      }
+      return 14u * n + num_bits * num_bits;
+    }
+  default:
+    return 0u;
   }
+}
 
-  /* i, j > 0 */
-  for ( auto i = 1; i <= max_i; ++i )
+/*! \brief Chooses an at-most-k encoding from the size of the constraint
+ *
+ * Returns the arc-consistent encoding with the fewest estimated
+ * clauses.  Since adders do not propagate as well, they are chosen
+ * only if they are at least four times smaller.
+ *
+ * \param n Number of inputs
+ * \param k_max Largest bound
+ */
+inline cardinality_encoding choose_cardinality_encoding( uint32_t n, uint32_t k_max )
+{
+  auto best = cardinality_encoding::totalizer;
+  auto best_size = estimate_cardinality_clauses( best, n, k_max );
+  for ( auto const e : {cardinality_encoding::sequential_counter, cardinality_encoding::sorting_network} )
   {
-    auto const max_j = std::min( rhs-i, uint32_t( bv.size() ) );
-    auto const min_j = std::max( int( last ) - int( i ) + 1, 1 );
-    for ( auto j = min_j; j <= max_j; ++j )
+    auto const size = estimate_cardinality_clauses( e, n, k_max );
+    if ( size < best_size )
     {
-      dest.emplace_back( std::vector<int>{ -av[i-1], -bv[j-1], ov[i+j-1] } );
+      best = e;
+      best_size = size;
     }
   }
+
+  if ( 4u * estimate_cardinality_clauses( cardinality_encoding::adder, n, k_max ) < best_size )
+  {
+    return cardinality_encoding::adder;
+  }
+  return best;
 }
 
-} /* detail */
+/*! \brief Chooses an at-most-one encoding from the number of literals
+ *
+ * \param n Number of literals
+ */
+inline at_most_one_encoding choose_at_most_one_encoding( uint32_t n )
+{
+  return n <= 6u ? at_most_one_encoding::pairwise : at_most_one_encoding::product;
+}
+
+/*! \brief Encoder of cardinality constraints
+ *
+ * Encodes at-most-k and at-most-one constraints with a selectable
+ * encoding.  As for totalizer_arena, the clauses are passed to a
+ * sink; the encoder only keeps buffers that are reused between
+ * constraints.
+
+   \verbatim embed:rst
+
+   Example
+
+   .. code-block:: c++
+
+      sat2::cardinality_encoder encoder;
+      auto const c = encoder.encode( solver, sid, lits, k_max );
 
-inline std::shared_ptr<totalizer_tree> create_totalizer( std::vector<std::vector<int>>& dest, int& sid, std::vector<int> const& lhs, uint32_t rhs )
+      // enforce that at most k <= k_max literals are true
+      auto const l = encoder.at_most( solver, sid, c, k );
+      solver.solve( {l} );
+   \endverbatim
+ */
+class cardinality_encoder
 {
-  auto const n = lhs.size();
+public:
+  /*! \brief Encodes the number of true literals in `lhs` up to bound `k_max`
+   *
+   * \param sink Receives the clauses
+   * \param sid Next free variable id
+   * \param lhs Input literals
+   * \param k_max Largest bound that is enforced with `at_most`
+   * \param encoding Encoding
+   *
+   * Bounds of at least the number of inputs are encoded as bound n - 1.
+   */
+  template<typename Sink>
+  cardinality_constraint encode( Sink& sink, int& sid, std::vector<int> const& lhs, uint32_t k_max,
+                                 cardinality_encoding encoding = cardinality_encoding::automatic )
+  {
+    uint32_t const n = lhs.size();
+    if ( encoding == cardinality_encoding::automatic )
+    {
+      encoding = choose_cardinality_encoding( n, k_max );
+    }
+
+    cardinality_constraint c;
+    c.encoding = encoding;
+    c.num_inputs = n;
+
+    if ( n == 0u )
+    {
+      return c;
+    }
+
+    k_max = std::min( k_max, n - 1u );
+    uint32_t const m = k_max + 1u;
+    switch ( encoding )
+    {
+    case cardinality_encoding::totalizer:
+      {
+        _totalizers.clear();
+        auto const t = _totalizers.create( sink, sid, lhs, k_max );
+        c.outputs = _totalizers.vars( t );
+      }
+      break;
+    case cardinality_encoding::sequential_counter:
+      c.outputs = sequential_counter( sink, sid, lhs, m );
+      break;
+    case cardinality_encoding::sorting_network:
+      c.outputs = cardinality_network( sink, sid, lhs, m );
+      break;
+    case cardinality_encoding::adder:
+      c.outputs = adder_tree( sink, sid, lhs );
+      break;
+    default:
+      assert( false );
+      break;
+    }
 
-  std::deque<std::shared_ptr<totalizer_tree>> queue;
-  for ( auto i = 0; i < n; ++i )
+    return c;
+  }
+
+  /*! \brief Returns a literal that enforces at most `k` true inputs
+   *
+   * The literal can be used as assumption or added as unit clause.
+   * For the unary encodings, `k` must not exceed the bound for which
+   * the constraint has been encoded.  For the adder encoding, the
+   * comparator clauses are guarded by a fresh literal.
+   *
+   * Returns 0 if the bound is trivially satisfied.
+   */
+  template<typename Sink>
+  int at_most( Sink& sink, int& sid, cardinality_constraint const& c, uint32_t k )
   {
-    auto t = std::make_shared<totalizer_tree>();
-    t->vars.resize( 1 );
-    t->vars[0] = lhs[i];
-    t->num_inputs = 1;
+    if ( k >= c.num_inputs )
+    {
+      return 0;
+    }
+
+    if ( c.encoding != cardinality_encoding::adder )
+    {
+      assert( k < c.outputs.size() );
+      return -c.outputs[k];
+    }
 
-    queue.push_back( t );
+    /* sum <= k iff, for each 0-bit of k, the corresponding bit of the sum or a higher 1-bit of k is not set */
+    auto const act = sid++;
+    for ( auto i = 0u; i < c.outputs.size(); ++i )
+    {
+      if ( ( k >> i ) & 1u )
+      {
+        continue;
+      }
+
+      _clause.clear();
+      _clause.emplace_back( -act );
+      _clause.emplace_back( -c.outputs[i] );
+      for ( auto j = i + 1u; j < c.outputs.size(); ++j )
+      {
+        if ( ( k >> j ) & 1u )
+        {
+          _clause.emplace_back( -c.outputs[j] );
+        }
+      }
+      detail::add_clause_to_sink( sink, _clause );
+    }
+    return act;
   }
 
-  while ( queue.size() > 1 )
+  /*! \brief Enforces that at most one literal in `lits` is true
+   *
+   * \param sink Receives the clauses
+   * \param sid Next free variable id
+   * \param lits Literals
+   * \param encoding Encoding
+   */
+  template<typename Sink>
+  void at_most_one( Sink& sink, int& sid, std::vector<int> const& lits, at_most_one_encoding encoding = at_most_one_encoding::automatic )
   {
-    auto const le = queue.front();
-    queue.pop_front();
+    if ( encoding == at_most_one_encoding::automatic )
+    {
+      encoding = choose_at_most_one_encoding( lits.size() );
+    }
 
-    auto const ri = queue.front();
-    queue.pop_front();
+    switch ( encoding )
+    {
+    case at_most_one_encoding::pairwise:
+      pairwise( sink, lits );
+      break;
+    case at_most_one_encoding::product:
+      product( sink, sid, lits );
+      break;
+    case at_most_one_encoding::commander:
+      commander( sink, sid, lits );
+      break;
+    default:
+      assert( false );
+      break;
+    }
+  }
 
-    auto t = std::make_shared<totalizer_tree>();
-    t->num_inputs = le->num_inputs + ri->num_inputs;
-    t->left = le;
-    t->right = ri;
+protected:
+  template<typename Sink>
+  void emit( Sink& sink, std::initializer_list<int> lits )
+  {
+    _clause.assign( lits );
+    detail::add_clause_to_sink( sink, _clause );
+  }
+
+  /* at most one */
 
-    uint32_t kmin = std::min( rhs+1, t->num_inputs );
-    t->vars.resize( kmin );
-    for ( auto i = 0; i < kmin; ++i )
+  template<typename Sink>
+  void pairwise( Sink& sink, std::vector<int> const& lits )
+  {
+    for ( auto i = 0u; i < lits.size(); ++i )
     {
-      t->vars[i] = sid++;
+      for ( auto j = i + 1u; j < lits.size(); ++j )
+      {
+        emit( sink, { -lits[i], -lits[j] } );
+      }
     }
-    detail::create_totalizer_internal( dest, sid, t->vars, kmin, le->vars, ri->vars );
-    queue.push_back( t );
   }
 
-  return queue.front();
-}
+  template<typename Sink>
+  void product( Sink& sink, int& sid, std::vector<int> const& lits )
+  {
+    if ( lits.size() <= 4u )
+    {
+      pairwise( sink, lits );
+      return;
+    }
 
-inline void increase_totalizer( std::vector<std::vector<int>>& dest, int& sid, std::shared_ptr<totalizer_tree>& t, uint32_t rhs )
-{
-  uint32_t const kmin = std::min( rhs+1, t->num_inputs );
-  if ( kmin <= t->vars.size() )
-    return;
+    /* arrange the literals in a p x q grid; each literal implies its row and its column */
+    uint32_t p = 1u;
+    while ( p * p < lits.size() )
+    {
+      ++p;
+    }
+    uint32_t const q = ( lits.size() + p - 1u ) / p;
 
-  increase_totalizer( dest, sid, t->left, rhs );
-  increase_totalizer( dest, sid, t->right, rhs );
-  detail::increase_totalizer_internal( dest, sid, t->vars, kmin, t->left->vars, t->right->vars );
-}
+    std::vector<int> rows( ( lits.size() + q - 1u ) / q ), cols( q );
+    for ( auto& r : rows )
+    {
+      r = sid++;
+    }
+    for ( auto& c : cols )
+    {
+      c = sid++;
+    }
 
-inline std::shared_ptr<totalizer_tree> merge_totalizer( std::vector<std::vector<int>>& dest, int& sid, std::shared_ptr<totalizer_tree>& ta, std::shared_ptr<totalizer_tree>& tb, uint32_t rhs )
-{
-  increase_totalizer( dest, sid, ta, rhs );
-  increase_totalizer( dest, sid, tb, rhs );
+    for ( auto i = 0u; i < lits.size(); ++i )
+    {
+      emit( sink, { -lits[i], rows[i / q] } );
+      emit( sink, { -lits[i], cols[i % q] } );
+    }
 
-  uint32_t n = ta->num_inputs + tb->num_inputs;
-  uint32_t kmin = std::min( rhs, n );
+    product( sink, sid, rows );
+    product( sink, sid, cols );
+  }
 
-  auto t = std::make_shared<totalizer_tree>();
-  t->num_inputs = n;
-  t->left = ta;
-  t->right = tb;
-  t->vars.resize( kmin );
+  template<typename Sink>
+  void commander( Sink& sink, int& sid, std::vector<int> const& lits )
+  {
+    if ( lits.size() <= 6u )
+    {
+      pairwise( sink, lits );
+      return;
+    }
 
-  for ( auto i = 0; i < kmin; ++i )
+    /* at most one literal per group of three, and each literal implies the commander of its group */
+    std::vector<int> commanders;
+    for ( auto i = 0u; i < lits.size(); i += 3u )
+    {
+      auto const c = sid++;
+      commanders.emplace_back( c );
+
+      auto const end = std::min<uint32_t>( i + 3u, lits.size() );
+      for ( auto j = i; j < end; ++j )
+      {
+        emit( sink, { -lits[j], c } );
+        for ( auto l = j + 1u; l < end; ++l )
+        {
+          emit( sink, { -lits[j], -lits[l] } );
+        }
+      }
+    }
+
+    commander( sink, sid, commanders );
+  }
+
+  /* sequential counter */
+
+  /* returns the last row of counters; the j-th counter of row i is implied if at least j + 1 of lhs[0..i] are true */
+  template<typename Sink>
+  std::vector<int> sequential_counter( Sink& sink, int& sid, std::vector<int> const& lhs, uint32_t m )
   {
-    t->vars[i] = sid++;
+    std::vector<int> prev{lhs[0u]}, cur;
+    for ( auto i = 1u; i < lhs.size(); ++i )
+    {
+      auto const x = lhs[i];
+
+      cur.resize( std::min( i + 1u, m ) );
+      for ( auto j = 0u; j < cur.size(); ++j )
+      {
+        cur[j] = sid++;
+        if ( j < prev.size() )
+        {
+          emit( sink, { -prev[j], cur[j] } );
+        }
+        if ( j == 0u )
+        {
+          emit( sink, { -x, cur[j] } );
+        }
+        else
+        {
+          emit( sink, { -x, -prev[j - 1u], cur[j] } );
+        }
+      }
+      std::swap( prev, cur );
+    }
+    return prev;
   }
 
-  detail::create_totalizer_internal( dest, sid, t->vars, kmin, ta->vars, tb->vars );
-  return t;
-}
+  /* cardinality network; 0 denotes the constant false */
 
-inline std::shared_ptr<totalizer_tree> extend_totalizer( std::vector<std::vector<int>>& dest, int& sid, std::shared_ptr<totalizer_tree>& ta, std::vector<int> const& lhs, uint32_t rhs )
-{
-  auto tb = create_totalizer( dest, sid, lhs, rhs );
-  return merge_totalizer( dest, sid, ta, tb, rhs );
-}
+  /* half comparator: the first output is implied by either input, the second one by both inputs */
+  template<typename Sink>
+  std::pair<int, int> comparator( Sink& sink, int& sid, int a, int b )
+  {
+    if ( a == 0 )
+    {
+      return {b, 0};
+    }
+    if ( b == 0 )
+    {
+      return {a, 0};
+    }
+
+    auto const c1 = sid++;
+    auto const c2 = sid++;
+    emit( sink, { -a, c1 } );
+    emit( sink, { -b, c1 } );
+    emit( sink, { -a, -b, c2 } );
+    return {c1, c2};
+  }
+
+  /* splits a sequence into the elements at even and at odd positions */
+  static std::pair<std::vector<int>, std::vector<int>> split( std::vector<int> const& a )
+  {
+    std::pair<std::vector<int>, std::vector<int>> r;
+    for ( auto i = 0u; i < a.size(); ++i )
+    {
+      ( i % 2u == 0u ? r.first : r.second ).emplace_back( a[i] );
+    }
+    return r;
+  }
+
+  /* merges two sorted sequences of length p into one of length 2p */
+  template<typename Sink>
+  std::vector<int> hmerge( Sink& sink, int& sid, std::vector<int> const& a, std::vector<int> const& b )
+  {
+    auto const p = a.size();
+    if ( p == 1u )
+    {
+      auto const [c1, c2] = comparator( sink, sid, a[0u], b[0u] );
+      return {c1, c2};
+    }
+
+    auto const [a_even, a_odd] = split( a );
+    auto const [b_even, b_odd] = split( b );
+    auto const d = hmerge( sink, sid, a_even, b_even );
+    auto const e = hmerge( sink, sid, a_odd, b_odd );
+
+    std::vector<int> c( 2u * p );
+    c[0u] = d[0u];
+    for ( auto i = 1u; i < p; ++i )
+    {
+      std::tie( c[2u * i - 1u], c[2u * i] ) = comparator( sink, sid, d[i], e[i - 1u] );
+    }
+    c[2u * p - 1u] = e[p - 1u];
+    return c;
+  }
+
+  /* sorts a sequence whose length is a power of 2 */
+  template<typename Sink>
+  std::vector<int> hsort( Sink& sink, int& sid, std::vector<int> const& a )
+  {
+    if ( a.size() == 1u )
+    {
+      return a;
+    }
+
+    auto const half = a.size() / 2u;
+    auto const d = hsort( sink, sid, std::vector<int>( a.begin(), a.begin() + half ) );
+    auto const e = hsort( sink, sid, std::vector<int>( a.begin() + half, a.end() ) );
+    return hmerge( sink, sid, d, e );
+  }
+
+  /* merges two sorted sequences of length p into the first p + 1 outputs */
+  template<typename Sink>
+  std::vector<int> smerge( Sink& sink, int& sid, std::vector<int> const& a, std::vector<int> const& b )
+  {
+    auto const p = a.size();
+    if ( p == 1u )
+    {
+      auto const [c1, c2] = comparator( sink, sid, a[0u], b[0u] );
+      return {c1, c2};
+    }
+
+    auto const [a_even, a_odd] = split( a );
+    auto const [b_even, b_odd] = split( b );
+    auto const d = smerge( sink, sid, a_even, b_even );
+    auto const e = smerge( sink, sid, a_odd, b_odd );
+
+    std::vector<int> c( p + 1u );
+    c[0u] = d[0u];
+    for ( auto i = 1u; i <= p / 2u; ++i )
+    {
+      std::tie( c[2u * i - 1u], c[2u * i] ) = comparator( sink, sid, d[i], e[i - 1u] );
+    }
+    return c;
+  }
+
+  /* returns the first m outputs of a network that sorts lhs */
+  template<typename Sink>
+  std::vector<int> cardinality_network( Sink& sink, int& sid, std::vector<int> const& lhs, uint32_t m )
+  {
+    /* blocks of p inputs are sorted and merged into the first p outputs */
+    uint32_t const p = detail::next_power_of_two( m );
+
+    std::vector<int> outputs;
+    for ( auto i = 0u; i < lhs.size(); i += p )
+    {
+      std::vector<int> block( p, 0 );
+      std::copy( lhs.begin() + i, lhs.begin() + std::min<uint32_t>( i + p, lhs.size() ), block.begin() );
+
+      auto sorted = hsort( sink, sid, block );
+      if ( !outputs.empty() )
+      {
+        sorted = smerge( sink, sid, outputs, sorted );
+        sorted.resize( p );
+      }
+      outputs = std::move( sorted );
+    }
+
+    outputs.resize( m );
+    return outputs;
+  }
+
+  /* parallel binary adders */
+
+  /* adds two binary numbers, least significant bit first */
+  template<typename Sink>
+  std::vector<int> add_binary( Sink& sink, int& sid, std::vector<int> const& a, std::vector<int> const& b )
+  {
+    std::vector<int> sum;
+    int carry = 0;
+    for ( auto i = 0u; i < std::max( a.size(), b.size() ); ++i )
+    {
+      /* collect the present bits */
+      int bits[3] = {0, 0, 0};
+      auto num_bits = 0u;
+      if ( i < a.size() )
+        bits[num_bits++] = a[i];
+      if ( i < b.size() )
+        bits[num_bits++] = b[i];
+      if ( carry != 0 )
+        bits[num_bits++] = carry;
+
+      if ( num_bits == 1u )
+      {
+        sum.emplace_back( bits[0u] );
+        carry = 0;
+      }
+      else if ( num_bits == 2u )
+      {
+        auto const x = bits[0u], y = bits[1u];
+        auto const s = sid++;
+        auto const c = sid++;
+        emit( sink, { -x, -y, -s } );
+        emit( sink, { x, y, -s } );
+        emit( sink, { -x, y, s } );
+        emit( sink, { x, -y, s } );
+        emit( sink, { -x, -y, c } );
+        emit( sink, { x, -c } );
+        emit( sink, { y, -c } );
+        sum.emplace_back( s );
+        carry = c;
+      }
+      else
+      {
+        auto const x = bits[0u], y = bits[1u], z = bits[2u];
+        auto const s = sid++;
+        auto const c = sid++;
+        emit( sink, { -x, -y, -z, s } );
+        emit( sink, { -x, -y, z, -s } );
+        emit( sink, { -x, y, -z, -s } );
+        emit( sink, { -x, y, z, s } );
+        emit( sink, { x, -y, -z, -s } );
+        emit( sink, { x, -y, z, s } );
+        emit( sink, { x, y, -z, s } );
+        emit( sink, { x, y, z, -s } );
+        emit( sink, { -x, -y, c } );
+        emit( sink, { -x, -z, c } );
+        emit( sink, { -y, -z, c } );
+        emit( sink, { x, y, -c } );
+        emit( sink, { x, z, -c } );
+        emit( sink, { y, z, -c } );
+        sum.emplace_back( s );
+        carry = c;
+      }
+    }
+
+    if ( carry != 0 )
+    {
+      sum.emplace_back( carry );
+    }
+    return sum;
+  }
+
+  /* returns the binary sum of lhs */
+  template<typename Sink>
+  std::vector<int> adder_tree( Sink& sink, int& sid, std::vector<int> const& lhs )
+  {
+    std::vector<std::vector<int>> queue;
+    queue.reserve( 2u * lhs.size() );
+    for ( const auto& l : lhs )
+    {
+      queue.push_back( {l} );
+    }
+
+    for ( auto head = 0u; head + 1u < queue.size(); head += 2u )
+    {
+      auto sum = add_binary( sink, sid, queue[head], queue[head + 1u] );
+      queue.emplace_back( std::move( sum ) );
+    }
+    return queue.back();
+  }
+
+protected:
+  totalizer_arena _totalizers;
+
+  /* buffers */
+  std::vector<int> _clause;
+}; /* cardinality_encoder */
 
 } /* namespace easy::sat2 */
@@ -75,69 +75,39 @@ public:
   void simplify_matrix( std::vector<utils::dynamic_bitset<>>& matrix )
   {
     auto const num_rows = matrix.size();
+    if ( num_rows == 0u )
+      return;
 
-    auto index = 0u;
-    for ( auto i = 0u; i < num_rows; ++i )
+    /* forward elimination, the last column holds the parity */
+    auto const num_cols = matrix[0u].num_bits() - 1u;
+    auto row = 0u;
+    for ( auto col = 0u; col < num_cols && row < num_rows; ++col )
     {
       /* find next row */
-      auto next_row = i;
-      if ( !matrix[i][index] )
+      auto next_row = row;
+      while ( next_row < num_rows && !matrix[next_row][col] )
       {
-        for ( auto k = i + 1; k < num_rows; ++k )
-        {
-          if ( matrix[k][index] )
-          {
-            ++index;
-            continue;
-          }
-        }
-
-        if ( !matrix[next_row][i] )
-        {
-          ++index;
-          continue;
-        }
+        ++next_row;
       }
+      if ( next_row == num_rows )
+        continue;
 
-      /* swap current i and next_row */
-      if ( next_row != i )
+      /* swap current row and next_row */
+      if ( next_row != row )
       {
-        // std::cout << "swap " << i << " and " << next_row << std::endl;
-        for ( auto j = 0u; j < matrix[i].num_bits(); ++j )
-        {
-          bool const temp = matrix[i][j];
-          if ( matrix[next_row][j] )
-            matrix[i].set_bit( j );
-          else
-            matrix[i].reset_bit( j );
-
-          if ( temp )
-            matrix[next_row].set_bit( j );
-          else
-            matrix[next_row].reset_bit( j );
-        }
+        matrix[row].swap( matrix[next_row] );
       }
 
-      /* add current row to all other rows */
-      for ( auto k = i + 1; k < num_rows; ++k )
+      /* add current row to all rows below */
+      for ( auto k = row + 1; k < num_rows; ++k )
       {
-        if ( !matrix[k][index] ) continue;
-
-        // std::cout << "add " << i << " to " << k << std::endl;
-        for ( auto j = 0u; j < matrix[k].num_bits(); ++j )
+        if ( matrix[k][col] )
         {
-          if ( matrix[k][j] ^ matrix[i][j] )
-          {
-            matrix[k].set_bit( j );
-          }
-          else
-          {
-            matrix[k].reset_bit( j );
-          }
+          matrix[k] ^= matrix[row];
         }
       }
 
-      ++index;
+      ++row;
     }
   }
 
@@ -204,6 +174,7 @@ public:
         }
 
         add_xor_clause( _clauses, clause );
+        ++_num_translated_xor_clauses;
       }
     }
   }
@@ -221,6 +192,18 @@ public:
     return _clauses;
   }
 
+  /*! \brief Returns the number of XOR-clauses before the elimination */
+  uint64_t num_xor_clauses() const
+  {
+    return _xor_clauses.size();
+  }
+
+  /*! \brief Returns the number of XOR-clauses translated into clauses */
+  uint64_t num_translated_xor_clauses() const
+  {
+    return _num_translated_xor_clauses;
+  }
+
 protected:
   int& _sid;
 
@@ -228,6 +211,7 @@ protected:
   uint32_t _num_vars;
 
   std::vector<std::vector<int>> _clauses;
+  uint64_t _num_translated_xor_clauses{0};
 }; /* cnf_from_xcnf */
 
 } // namespace easy::sat
@@ -39,55 +39,199 @@
 
 #include <easy/sat2/sat_solver.hpp>
 
+#include <algorithm>
+#include <vector>
+
 namespace easy::sat2
 {
 
+struct core_reduction_params
+{
+  /*! \brief Maximal number of rounds in which the core is trimmed (0 disables trimming) */
+  uint32_t trim_rounds{0u};
+
+  /*! \brief Enables deletion-based minimization */
+  bool minimize{false};
+
+  /*! \brief Conflict budget of a single SAT-call during minimization */
+  int64_t minimize_budget{1000};
+
+  /*! \brief Maximal number of SAT-calls spent on minimizing one core (0 means no limit) */
+  uint32_t minimize_max_calls{0u};
+
+  /*! \brief Drops all literals outside the core of an UNSAT call at once */
+  bool refine{true};
+}; /* core_reduction_params */
+
 namespace detail
 {
 
-template<typename T>
-inline std::vector<T> copy_vector_without_index( std::vector<T> const& vs, uint64_t index )
+/* restores the conflict budget of a SAT-solver when leaving the scope */
+class budget_guard
 {
-  assert( index < vs.size() );
-  std::vector<T> copy( vs );
-  copy.erase( std::begin( copy ) + index );
-  return copy;
-}
+public:
+  explicit budget_guard( sat_solver& solver )
+    : _solver( solver )
+    , _budget( solver.get_budget() )
+  {}
+
+  ~budget_guard()
+  {
+    if ( _budget < 0 )
+    {
+      _solver.reset_budget();
+    }
+    else
+    {
+      _solver.set_budget( _budget );
+    }
+  }
+
+private:
+  sat_solver& _solver;
+  int64_t const _budget;
+}; /* budget_guard */
 
 } /* namespace detail */
 
-/* \brief Trim unsatisfiable core
+/* \brief Trim unsatisfiable core in place
  *
- * Given a SAT-solver `solver` with an unsatisfiable core `cs`, such
- * that the solver is in state UNSAT under the given assumptions.  The algorithm
- * heuristically tries to trim `cs`.  The core is trimmed at
- * most `num_tries`-times.
+ * Given a SAT-solver `solver` and an unsatisfiable core `lits`, such
+ * that the solver is in state UNSAT under the given assumptions, the
+ * algorithm repeatedly solves under the core and replaces it with the
+ * returned core until the core does not shrink anymore or `num_tries`
+ * rounds have been made.
  *
  * \param solver SAT-solver
- * \param cs An unsatisfiable core
+ * \param lits An unsatisfiable core
  * \param num_tries Maximal number of tries to trim core
- *
- * Returns the trimmed core.
  */
-inline core<> trim_core_copy( sat_solver& solver, core<> const& cs, uint32_t num_tries = 8u )
+inline void trim_core_in_place( sat_solver& solver, std::vector<int>& lits, uint32_t num_tries = 8u )
 {
-  auto current = cs;
-
   uint32_t counter = 0;
-  while ( counter++ < num_tries && solver.solve( current ) == sat_solver::state::unsat )
+  while ( counter++ < num_tries && solver.solve( lits ) == sat_solver::state::unsat )
   {
     auto const new_core = solver.get_core();
-    if ( new_core.size() == current.size() )
+    if ( new_core.size() == lits.size() )
     {
       break;
     }
+
+    lits.resize( new_core.size() );
+    for ( auto i = 0u; i < new_core.size(); ++i )
+    {
+      lits[i] = new_core[i];
+    }
+  }
+}
+
+/* \brief Deletion-based unsatisfiable core minimization in place
+ *
+ * Given a SAT-solver `solver` and an unsatisfiable core `lits`, such
+ * that the solver is in state UNSAT under the given assumptions, the
+ * algorithm tries to remove one literal after the other.  A literal
+ * is kept if the remaining literals are satisfiable or the SAT-call
+ * exceeds the conflict `budget` (a value < 0 denotes an unconstrained
+ * budget).  If `refine` is set, the literals
+ * outside the core of an UNSAT call are removed at once.
+ *
+ * The literals `lits[0..pos)` are known to be necessary, and the
+ * literal under test is temporarily moved to the back of `lits`, so
+ * that `lits` itself serves as assumptions of each SAT-call.
+ *
+ * \param solver SAT-solver
+ * \param lits An unsatisfiable core
+ * \param budget A budget limit for SAT-solving
+ * \param max_calls Maximal number of SAT-calls (0 means no limit)
+ * \param refine Enables clause-set refinement
+ *
+ * Returns the number of SAT-calls.
+ */
+inline uint32_t minimize_core_in_place( sat_solver& solver, std::vector<int>& lits, int64_t budget = 1000, uint32_t max_calls = 0u, bool refine = true )
+{
+  detail::budget_guard guard( solver );
+  if ( budget >= 0 )
+  {
+    solver.set_budget( budget );
+  }
+
+  uint32_t num_calls = 0u;
+  auto pos = 0u;
+  while ( pos < lits.size() && ( max_calls == 0u || num_calls < max_calls ) )
+  {
+    std::swap( lits[pos], lits.back() );
+    auto const lit = lits.back();
+    lits.pop_back();
+
+    ++num_calls;
+    auto const state = budget < 0 ? solver.solve_unlimited( lits ) : solver.solve_limited( lits );
+    if ( state == sat_solver::state::unsat )
+    {
+      if ( refine )
+      {
+        /* the necessary literals are part of every core of the remaining literals */
+        std::vector<int> const new_core = solver.get_core();
+        auto const it = std::remove_if( std::begin( lits ) + pos, std::end( lits ), [&]( int l ){
+            return !std::binary_search( std::begin( new_core ), std::end( new_core ), l );
+          } );
+        lits.erase( it, std::end( lits ) );
+      }
+    }
     else
     {
-      current = new_core;
+      lits.push_back( lit );
+      std::swap( lits[pos], lits.back() );
+      ++pos;
     }
   }
 
-  return current;
+  return num_calls;
+}
+
+/* \brief Reduces an unsatisfiable core
+ *
+ * Trims and minimizes the core `lits` as configured by `ps`.
+ *
+ * \param solver SAT-solver
+ * \param lits An unsatisfiable core
+ * \param ps Parameters
+ */
+inline void reduce_core( sat_solver& solver, std::vector<int>& lits, core_reduction_params const& ps )
+{
+  if ( lits.size() <= 1u )
+  {
+    return;
+  }
+
+  if ( ps.trim_rounds > 0u )
+  {
+    trim_core_in_place( solver, lits, ps.trim_rounds );
+  }
+
+  if ( ps.minimize )
+  {
+    minimize_core_in_place( solver, lits, ps.minimize_budget, ps.minimize_max_calls, ps.refine );
+  }
+}
+
+/* \brief Trim unsatisfiable core
+ *
+ * Given a SAT-solver `solver` with an unsatisfiable core `cs`, such
+ * that the solver is in state UNSAT under the given assumptions.  The algorithm
+ * heuristically tries to trim `cs`.  The core is trimmed at
+ * most `num_tries`-times.
+ *
+ * \param solver SAT-solver
+ * \param cs An unsatisfiable core
+ * \param num_tries Maximal number of tries to trim core
+ *
+ * Returns the trimmed core.
+ */
+inline core<> trim_core_copy( sat_solver& solver, core<> const& cs, uint32_t num_tries = 8u )
+{
+  std::vector<int> lits( cs );
+  trim_core_in_place( solver, lits, num_tries );
+  return core<>( lits );
 }
 
 /* \brief Trim unsatisfiable core
@@ -121,36 +265,9 @@ inline void trim_core( sat_solver& solver, core<>& cs, uint32_t num_tries = 8u )
  */
 inline core<> minimize_core_copy( sat_solver& solver, core<> const& cs, int64_t budget = 1000 )
 {
-  solver.set_budget( budget );
-
-  auto pos = 0u;
-  auto current = cs;
-
-  while ( pos < current.size() )
-  {
-    auto temp = core<>( detail::copy_vector_without_index( std::vector<int>( current ), pos ) );
-    solver.solve_limited( temp );
-
-    if ( solver.is_unsat() )
-    {
-      current = temp;
-    }
-    else
-    {
-      ++pos;
-    }
-  }
-
-  solver.reset_budget();
-
-  if ( current.size() < cs.size() )
-  {
-    return current;
-  }
-  else
-  {
-    return cs;
-  }
+  std::vector<int> lits( cs );
+  minimize_core_in_place( solver, lits, budget );
+  return core<>( lits );
 }
 
 /* \brief Deletion-based unsatisfiable core minimization
@@ -35,6 +35,7 @@
 #include <easy/sat2/sat_solver.hpp>
 #include <easy/sat2/core_utils.hpp>
 #include <easy/sat2/cardinality.hpp>
+#include <algorithm>
 #include <map>
 
 namespace easy::sat2
@@ -82,12 +83,142 @@ protected:
 
 struct maxsat_solver_statistics
 {
+  /*! \brief Number of iterations of the MAXSAT procedure */
+  uint64_t num_iterations{0};
+
+  /*! \brief Number of soft clauses */
+  uint64_t num_soft_clauses{0};
+
+  /*! \brief Number of extracted UNSAT cores */
+  uint64_t num_cores{0};
+
+  /*! \brief Accumulated size of the extracted UNSAT cores */
+  uint64_t total_core_size{0};
+
+  /*! \brief Size of the largest UNSAT core */
+  uint64_t max_core_size{0};
+
+  /*! \brief Number of literals removed from the UNSAT cores by core reduction */
+  uint64_t num_core_literals_removed{0};
+
+  /*! \brief Time spent on core reduction */
+  utils::stopwatch<>::duration time_core_reduction{0};
+
+  /*! \brief Total time */
+  utils::stopwatch<>::duration time_total{0};
+
+  /*! \brief Statistics of the underlying SAT-solver */
+  sat_solver_statistics sat;
+
+  /*! \brief Records an extracted UNSAT core */
+  void add_core( uint64_t size )
+  {
+    ++num_cores;
+    total_core_size += size;
+    max_core_size = std::max( max_core_size, size );
+  }
+
+  /*! \brief Exports the statistics as JSON */
+  nlohmann::json to_json() const
+  {
+    return nlohmann::json{
+      {"num_iterations", num_iterations},
+      {"num_soft_clauses", num_soft_clauses},
+      {"num_cores", num_cores},
+      {"total_core_size", total_core_size},
+      {"max_core_size", max_core_size},
+      {"num_core_literals_removed", num_core_literals_removed},
+      {"time_core_reduction", utils::to_seconds( time_core_reduction )},
+      {"time_total", utils::to_seconds( time_total )},
+      {"sat", sat.to_json()},
+    };
+  }
 }; /* maxsat_solver_statistics */
 
 struct maxsat_solver_params
 {
+  /*! \brief Reduction of the UNSAT cores (disabled by default) */
+  core_reduction_params core_reduction;
+
+  /*! \brief Encoding of the at-most-k constraint of the linear search */
+  cardinality_encoding cardinality{cardinality_encoding::automatic};
+
+  /*! \brief Encoding of the at-most-one constraints of one-hot clauses */
+  at_most_one_encoding at_most_one{at_most_one_encoding::automatic};
 }; /* maxsat_solver_params */
 
+namespace detail
+{
+
+/*! \brief Extracts and reduces an UNSAT core
+ *
+ * \param solver SAT-solver in state UNSAT
+ * \param ps Parameters of the core reduction
+ * \param stats Statistics
+ *
+ * Returns the assumption literals of the (reduced) core.
+ */
+inline std::vector<int> extract_core( sat_solver& solver, core_reduction_params const& ps, maxsat_solver_statistics& stats )
+{
+  std::vector<int> core = solver.get_core();
+
+  if ( ps.trim_rounds > 0u || ps.minimize )
+  {
+    utils::trace_span span( "maxsat::core_reduction", "maxsat" );
+    utils::stopwatch t( stats.time_core_reduction );
+
+    auto const size = core.size();
+    reduce_core( solver, core, ps );
+    stats.num_core_literals_removed += size - core.size();
+  }
+
+  stats.add_core( core.size() );
+  return core;
+}
+
+/*! \brief Evaluates an incumbent solution
+ *
+ * Checks if the hard clauses are satisfiable under the hint and, if
+ * so, partitions the soft clauses into enabled (satisfied) and
+ * disabled (falsified) clauses with respect to the obtained model.
+ *
+ * \param solver SAT-solver with the hard clauses
+ * \param hint A (partial) assignment given as vector of literals
+ * \param soft_clauses Soft clauses
+ * \param enabled Indices of the satisfied soft clauses
+ * \param disabled Indices of the falsified soft clauses
+ *
+ * Returns true if and only if the hint is consistent with the hard clauses.
+ */
+inline bool evaluate_incumbent( sat_solver& solver, std::vector<int> const& hint, std::vector<std::vector<int>> const& soft_clauses,
+                                std::vector<int>& enabled, std::vector<int>& disabled )
+{
+  if ( hint.empty() || solver.solve( hint ) != sat_solver::state::sat )
+  {
+    return false;
+  }
+
+  auto const m = solver.get_model_view();
+
+  enabled.clear();
+  disabled.clear();
+  for ( auto i = 0u; i < soft_clauses.size(); ++i )
+  {
+    auto const& cl = soft_clauses[i];
+    if ( std::any_of( std::begin( cl ), std::end( cl ), [&m]( int l ){ return m[l]; } ) )
+    {
+      enabled.push_back( i );
+    }
+    else
+    {
+      disabled.push_back( i );
+    }
+  }
+  return true;
+}
+
+} /* namespace detail */
+
 template<>
 class maxsat_solver<maxsat_linear>
 {
@@ -111,7 +242,7 @@ public:
     : _stats( stats )
     , _ps( ps )
     , _sid( sid )
-    , _solver( _sat_stats, _sat_params )
+    , _solver( _stats.sat, _sat_params )
   {}
 
   /* \brief Adds a hard clause to the solver
@@ -137,6 +268,24 @@ public:
     return id;
   }
 
+  /* \brief Warm-starts the solver from a known solution
+   *
+   * The literals are used as preferred phases of the SAT-solver.  If
+   * the hard clauses are satisfiable under the literals, the
+   * corresponding model serves as incumbent solution and bounds the
+   * search.
+   *
+   * \param lits A (partial) assignment given as vector of literals
+   */
+  void warm_start( std::vector<int> const& lits )
+  {
+    _hint = lits;
+    for ( const auto& l : lits )
+    {
+      _solver.set_phase( l );
+    }
+  }
+
   /*
    * \brief Naive maxsat procedure based on linear search and
    *        at-most-k cardinality constraint.
@@ -150,6 +299,9 @@ public:
    */
   state solve()
   {
+    utils::stopwatch t( _stats.time_total );
+    _stats.num_soft_clauses += _soft_clauses.size();
+
     if ( _solver.solve() == sat2::sat_solver::state::unsat )
     {
       /* it's not possible to satisfy the clauses even when ignoring all soft clauses */
@@ -167,6 +319,9 @@ public:
       return _state;
     }
 
+    /* evaluate the incumbent solution */
+    auto const has_incumbent = detail::evaluate_incumbent( _solver, _hint, _soft_clauses, _enabled_clauses, _disabled_clauses );
+
     /* add the soft clauses */
     std::map<int,int> selector_to_clause_id;
     for ( auto i = 0; i < _soft_clauses.size(); ++i )
@@ -178,29 +333,49 @@ public:
       auto& cl = _soft_clauses[i];
       cl.emplace_back( -selector );
       _solver.add_clause( cl );
-      _disabled_clauses.push_back( i );
+      if ( !has_incumbent )
+      {
+        _disabled_clauses.push_back( i );
+      }
     }
 
-    std::vector<std::vector<int>> clauses;
-    auto at_most_k = create_totalizer( clauses, _sid, _selectors, _selectors.size() );
-    for ( const auto& c : clauses )
+    /* enforce that at most k soft clauses are disabled; k = #selectors means unconstrained */
+    uint32_t k = _selectors.size();
+    if ( has_incumbent )
     {
-      add_clause( c );
+      /* the incumbent solution is optimal if it satisfies all soft clauses */
+      if ( _disabled_clauses.size() == 0u )
+      {
+        _state = state::success;
+        return _state;
+      }
+      k = _disabled_clauses.size() - 1u;
     }
 
-    /* enforce that at most k soft clauses are satisfied */
-    uint32_t k = _selectors.size() - 1u;
-
     /* perform linear search */
+    cardinality_constraint at_most_k;
+    bool has_bound = false;
     for ( ;; )
     {
+      ++_stats.num_iterations;
+
       // std::cout << "[i] try with k = " << k << std::endl;
 
+      /* k only decreases, hence the constraint is encoded once for the first bound */
+      if ( !has_bound && k < _selectors.size() )
+      {
+        at_most_k = _cardinality.encode( _solver, _sid, _selectors, k, _ps.cardinality );
+        has_bound = true;
+      }
+
       /* disable at-most k selectors */
       std::vector<int> assumptions;
-      for ( auto i = 0; i < at_most_k->vars.size(); ++i )
+      if ( has_bound )
       {
-        assumptions.emplace_back( i < k ? at_most_k->vars[i] : -at_most_k->vars[i] );
+        if ( auto const l = _cardinality.at_most( _solver, _sid, at_most_k, k ); l != 0 )
+        {
+          assumptions.emplace_back( l );
+        }
       }
 
       if ( _solver.solve( assumptions ) == sat2::sat_solver::state::unsat )
@@ -210,7 +385,7 @@ public:
         return _state;
       }
 
-      auto const m = _solver.get_model();
+      auto const m = _solver.get_model_view();
 
       _enabled_clauses.clear();
       _disabled_clauses.clear();
@@ -254,7 +429,6 @@ protected:
   maxsat_solver_params const& _ps;
   int& _sid;
 
-  sat_solver_statistics _sat_stats;
   sat_solver_params _sat_params;
   sat_solver _solver;
 
@@ -265,6 +439,10 @@ protected:
 
   std::vector<std::vector<int>> _soft_clauses;
   std::vector<int> _weights;
+
+  std::vector<int> _hint;
+
+  cardinality_encoder _cardinality;
 }; /* maxsat_solver<maxsat_linear> */
 
 template<>
@@ -290,7 +468,7 @@ public:
     : _stats( stats )
     , _ps( ps )
     , _sid( sid )
-    , _solver( _sat_stats, _sat_params )
+    , _solver( _stats.sat, _sat_params )
   {}
 
   /* \brief Adds a hard clause to the solver
@@ -324,21 +502,27 @@ public:
       return;
     }
 
-    std::vector<std::vector<int>> clauses;
-    auto at_most_1 = create_totalizer( clauses, _sid, lits, 2u );
-    for ( const auto& c : clauses )
-    {
-      add_clause( c );
-    }
+    /* enable exactly one of the lits */
+    _cardinality.at_most_one( _solver, _sid, lits, _ps.at_most_one );
+    add_clause( lits );
+  }
 
-    /* enable at-most 1 lits */
-    add_clause( { at_most_1->vars[0u] } );
-    for ( auto i = 1; i < at_most_1->vars.size(); ++i )
+  /* \brief Warm-starts the solver from a known solution
+   *
+   * The literals are used as preferred phases of the SAT-solver.  If
+   * the hard clauses are satisfiable under the literals, the
+   * corresponding model serves as incumbent solution and bounds the
+   * search.
+   *
+   * \param lits A (partial) assignment given as vector of literals
+   */
+  void warm_start( std::vector<int> const& lits )
+  {
+    _hint = lits;
+    for ( const auto& l : lits )
     {
-      add_clause( { -at_most_1->vars[i] } );
+      _solver.set_phase( l );
     }
-
-    add_clause( lits );
   }
 
   /*
@@ -354,6 +538,9 @@ public:
    */
   state solve()
   {
+    utils::stopwatch t( _stats.time_total );
+    _stats.num_soft_clauses += _soft_clauses.size();
+
     if ( _solver.solve() == sat2::sat_solver::state::unsat )
     {
       /* it's not possible to satisfy the clauses even when ignoring all soft clauses */
@@ -371,6 +558,9 @@ public:
       return _state;
     }
 
+    /* evaluate the incumbent solution */
+    auto const has_incumbent = detail::evaluate_incumbent( _solver, _hint, _soft_clauses, _enabled_clauses, _disabled_clauses );
+
     /* add the soft clauses */
     std::map<int,int> selector_to_clause_id;
     for ( auto i = 0; i < _soft_clauses.size(); ++i )
@@ -386,9 +576,18 @@ public:
 
     clause_to_block_vars block_variables;
 
-    auto iteration = 0;
+    auto iteration = 0u;
     for ( ;; )
     {
+      ++_stats.num_iterations;
+
+      /* each core increases the lower bound by one, stop as soon as the incumbent solution is reached */
+      if ( has_incumbent && iteration >= _disabled_clauses.size() )
+      {
+        _state = state::success;
+        return _state;
+      }
+
       /* assume all soft-clauses are enabled, which causes the problem to UNSAT */
       std::vector<int> assumptions;
       for ( const auto& s : _selectors )
@@ -399,7 +598,7 @@ public:
       auto const state = _solver.solve( assumptions );
       if ( state == sat2::sat_solver::state::sat )
       {
-        auto m = _solver.get_model();
+        auto const m = _solver.get_model_view();
 
         _disabled_clauses.clear();
         _enabled_clauses.clear();
@@ -435,7 +634,8 @@ public:
       }
       else
       {
-        auto const core = _solver.get_core();
+        utils::trace_span span( "maxsat::core", "maxsat" );
+        auto const core = detail::extract_core( _solver, _ps.core_reduction, _stats );
 
         std::vector<int> block_vars( core.size() );
         for ( auto i = 0; i < core.size(); ++i )
@@ -483,7 +683,6 @@ protected:
   maxsat_solver_params const& _ps;
   int& _sid;
 
-  sat_solver_statistics _sat_stats;
   sat_solver_params _sat_params;
   sat_solver _solver;
 
@@ -494,6 +693,10 @@ protected:
 
   std::vector<std::vector<int>> _soft_clauses;
   std::vector<int> _weights;
+
+  std::vector<int> _hint;
+
+  cardinality_encoder _cardinality;
 }; /* maxsat_solver<maxsat_uc> */
 
 template<>
@@ -519,7 +722,7 @@ public:
     : _stats( stats )
     , _ps( ps )
     , _sid( sid )
-    , _solver( _sat_stats, _sat_params )
+    , _solver( _stats.sat, _sat_params )
   {}
 
   /* \brief Adds a hard clause to the solver
@@ -545,6 +748,24 @@ public:
     return id;
   }
 
+  /* \brief Warm-starts the solver from a known solution
+   *
+   * The literals are used as preferred phases of the SAT-solver.  If
+   * the hard clauses are satisfiable under the literals, the
+   * corresponding model serves as incumbent solution and bounds the
+   * search.
+   *
+   * \param lits A (partial) assignment given as vector of literals
+   */
+  void warm_start( std::vector<int> const& lits )
+  {
+    _hint = lits;
+    for ( const auto& l : lits )
+    {
+      _solver.set_phase( l );
+    }
+  }
+
   /*
    * \brief RC2 MAXSAT procedure
    *
@@ -554,6 +775,9 @@ public:
    */
   state solve()
   {
+    utils::stopwatch t( _stats.time_total );
+    _stats.num_soft_clauses += _soft_clauses.size();
+
     if ( _solver.solve() == sat2::sat_solver::state::unsat )
     {
       /* it's not possible to satisfy the clauses even when ignoring all soft clauses */
@@ -573,11 +797,19 @@ public:
 
     std::vector<int> sels;
     std::vector<int> sums;
-    std::map<int,std::shared_ptr<totalizer_tree>> t_objects;
+    std::map<int,totalizer_arena::node_id> t_objects;
     std::map<int,int> bounds;
     std::map<int, int> selector_to_clause;
     int costs = 0;
 
+    /* evaluate the incumbent solution */
+    auto const has_incumbent = detail::evaluate_incumbent( _solver, _hint, _soft_clauses, _enabled_clauses, _disabled_clauses );
+    int upper_bound = 0;
+    for ( const auto& i : _disabled_clauses )
+    {
+      upper_bound += _weights[i];
+    }
+
     /* add the soft clauses */
     for ( auto i = 0; i < _soft_clauses.size(); ++i )
     {
@@ -603,6 +835,15 @@ public:
     auto iteration = 0;
     for ( ;; )
     {
+      ++_stats.num_iterations;
+
+      /* the costs are a lower bound, stop as soon as the incumbent solution is reached */
+      if ( has_incumbent && costs >= upper_bound )
+      {
+        _state = state::success;
+        return _state;
+      }
+
       /* assume all soft-clauses are enabled, which causes the problem to be UNSAT */
       std::vector<int> assumptions;
       for ( const auto& s : sels )
@@ -617,7 +858,9 @@ public:
       auto const state = _solver.solve( assumptions );
       if ( state == sat2::sat_solver::state::sat )
       {
-        auto const model = _solver.get_model();
+        auto const model = _solver.get_model_view();
+        _enabled_clauses.clear();
+        _disabled_clauses.clear();
         for ( auto i = 0; i < _soft_clauses.size(); ++i )
         {
           if ( model[_selectors[i]] )
@@ -633,7 +876,8 @@ public:
         return state::success;
       }
 
-      auto const core = _solver.get_core();
+      utils::trace_span span( "maxsat::core", "maxsat" );
+      auto const core = detail::extract_core( _solver, _ps.core_reduction, _stats );
       // std::cout << "[i] core: "; core.print(); std::cout << std::endl;
 
       /* divide core into sels and sums */
@@ -719,20 +963,16 @@ public:
           }
 
           /* increase bound for the sum */
-          auto& t = t_objects[l];
-          auto b = bounds[l]+1;
+          auto const t = t_objects.at( l );
+          uint32_t const b = bounds[l] + 1;
 
-          std::vector<std::vector<int>> clauses;
-          increase_totalizer( clauses, _sid, t, b );
-          for ( const auto& c : clauses )
-          {
-            add_clause( c );
-          }
+          _totalizers.increase( _solver, _sid, t, b );
 
           /* updating bounds and weights */
-          if ( b < t->vars.size() )
+          auto const& t_vars = _totalizers.vars( t );
+          if ( b < t_vars.size() )
           {
-            auto lnew = -t->vars[b];
+            auto lnew = -t_vars[b];
             if ( std::find( std::begin( garbage ), std::end( garbage ), lnew ) != std::end( garbage ) )
             {
               garbage.erase( std::remove( std::begin( garbage ), std::end( garbage ), lnew ) );
@@ -742,12 +982,12 @@ public:
             if ( selector_to_clause.find( lnew ) == selector_to_clause.end() )
             {
               /* invoke set bounds */
-              t_objects.emplace( -t->vars[b], t );
-              bounds.emplace( -t->vars[b], b );
-              selector_to_clause.emplace( -t->vars[b], _weights.size() );
+              t_objects.emplace( lnew, t );
+              bounds.emplace( lnew, b );
+              selector_to_clause.emplace( lnew, _weights.size() );
               _weights.push_back( w_min );
 
-              sums.push_back( -t->vars[b] );
+              sums.push_back( lnew );
             }
             else
             {
@@ -761,24 +1001,20 @@ public:
         if ( rels.size() > 1 )
         {
           /* create a new cardiality constraint */
-          std::vector<std::vector<int>> clauses;
-          auto totalizer_tree = create_totalizer( clauses, _sid, rels, 1u );
-          for ( const auto& c : clauses )
-          {
-            add_clause( c );
-          }
+          auto const t = _totalizers.create( _solver, _sid, rels, 1u );
 
           /* TODO: exhaust core */
           auto b = 1;
           /* invoke set bound */
 
           /* save the info about this sum and add its assumption literal */
-          t_objects.emplace( -totalizer_tree->vars[b], totalizer_tree );
-          bounds.emplace( -totalizer_tree->vars[b], b );
-          selector_to_clause.emplace( -totalizer_tree->vars[b], _weights.size() );
+          auto const lnew = -_totalizers.vars( t )[b];
+          t_objects.emplace( lnew, t );
+          bounds.emplace( lnew, b );
+          selector_to_clause.emplace( lnew, _weights.size() );
           _weights.push_back( w_min );
 
-          sums.push_back( -totalizer_tree->vars[b] );
+          sums.push_back( lnew );
         }
       }
       else
@@ -829,7 +1065,6 @@ protected:
   maxsat_solver_params const& _ps;
   int& _sid;
 
-  sat_solver_statistics _sat_stats;
   sat_solver_params _sat_params;
   sat_solver _solver;
 
@@ -840,6 +1075,10 @@ protected:
 
   std::vector<std::vector<int>> _soft_clauses;
   std::vector<int> _weights;
+
+  std::vector<int> _hint;
+
+  totalizer_arena _totalizers;
 }; /* maxsat_solver<maxsat_rc2> */
 
 } /* easy::sat2 */
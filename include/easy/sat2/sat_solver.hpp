@@ -32,9 +32,13 @@
 
 #pragma once
 
+#include <easy/sat/sat_solver.hpp>
 #include <easy/utils/dynamic_bitset.hpp>
+#include <easy/utils/stopwatch.hpp>
+#include <easy/utils/trace.hpp>
 
 #include <bill/bill.hpp>
+#include <json/json.hpp>
 
 #include <algorithm>
 #include <iostream>
@@ -109,6 +113,50 @@ protected:
   utils::dynamic_bitset<> _assignment;
 }; /* model */
 
+/*! \brief Read-only view of the model of a SAT-solver
+ *
+ * Provides the same access as model, but reads the values in place
+ * instead of copying them.  The view is invalidated by the next call
+ * to the SAT-solver.
+ */
+class model_view
+{
+public:
+  /*! \brief Constructor
+   *
+   * \param values Model of the SAT-solver
+   */
+  explicit model_view( Glucose::vec<Glucose::lbool> const& values )
+    : _values( &values )
+  {}
+
+  /*! \brief Size of model
+   *
+   * Returns the size of the model.
+   */
+  uint64_t size() const
+  {
+    return _values->size();
+  }
+
+  /*! \brief Get value of a literal
+   *
+   * \param lit A literal
+   *
+   * Returns the value of a literal in the model.
+   */
+  bool operator[]( int lit ) const
+  {
+    assert( lit != 0 );
+    uint32_t const var = abs( lit ) - 1;
+    assert( var < uint32_t( _values->size() ) && "Index out-of-bounds access" );
+    return ( ( *_values )[var] == Glucose::l_True ) == ( lit > 0 );
+  }
+
+protected:
+  Glucose::vec<Glucose::lbool> const* _values;
+}; /* model_view */
+
 /*! \brief Unsatisfiable core
  *
  * A sorted vector of assumption literals that together with the hard
@@ -198,6 +246,64 @@ protected:
 
 struct sat_solver_statistics
 {
+  /*! \brief Number of calls to the SAT-solver */
+  uint64_t num_calls{0};
+
+  /*! \brief Number of calls that returned SAT */
+  uint64_t num_sat{0};
+
+  /*! \brief Number of calls that returned UNSAT */
+  uint64_t num_unsat{0};
+
+  /*! \brief Number of calls that exceeded the conflict budget */
+  uint64_t num_undef{0};
+
+  /*! \brief Largest number of variables */
+  uint64_t num_variables{0};
+
+  /*! \brief Number of added clauses */
+  uint64_t num_clauses{0};
+
+  /*! \brief Number of literals in the added clauses */
+  uint64_t num_literals{0};
+
+  /*! \brief Number of conflicts */
+  uint64_t conflicts{0};
+
+  /*! \brief Number of decisions */
+  uint64_t decisions{0};
+
+  /*! \brief Number of propagations */
+  uint64_t propagations{0};
+
+  /*! \brief Total solving time */
+  utils::stopwatch<>::duration time_solve{0};
+
+  /*! \brief Solving time of the last call */
+  utils::stopwatch<>::duration time_last_solve{0};
+
+  /*! \brief Longest solving time of a single call */
+  utils::stopwatch<>::duration time_max_solve{0};
+
+  /*! \brief Exports the statistics as JSON */
+  nlohmann::json to_json() const
+  {
+    return nlohmann::json{
+      {"num_calls", num_calls},
+      {"num_sat", num_sat},
+      {"num_unsat", num_unsat},
+      {"num_undef", num_undef},
+      {"num_variables", num_variables},
+      {"num_clauses", num_clauses},
+      {"num_literals", num_literals},
+      {"conflicts", conflicts},
+      {"decisions", decisions},
+      {"propagations", propagations},
+      {"time_solve", utils::to_seconds( time_solve )},
+      {"time_last_solve", utils::to_seconds( time_last_solve )},
+      {"time_max_solve", utils::to_seconds( time_max_solve )},
+    };
+  }
 };
 
 struct sat_solver_params
@@ -225,7 +331,7 @@ public:
    * \param ps Parameters
    */
   explicit sat_solver( sat_solver_statistics& stats, sat_solver_params& ps )
-    : _glucose( std::make_unique<Glucose::Solver>() )
+    : _glucose( std::make_unique<sat::detail::glucose_solver>() )
     , _stats( stats )
     , _ps( ps )
   {}
@@ -237,6 +343,12 @@ public:
     _glucose->setConfBudget( budget );
   }
 
+  /* \brief Returns the conflict budget (a value < 0 denotes an unconstrained budget) */
+  int64_t get_budget() const
+  {
+    return _ps.budget;
+  }
+
   /* \brief Reset conflict budget */
   void reset_budget()
   {
@@ -256,6 +368,20 @@ public:
     return _num_variables;
   }
 
+  /*! \brief Ensures that the variables 1, ..., num_variables exist
+   *
+   * \param num_variables Number of variables
+   */
+  void reserve_variables( uint32_t num_variables )
+  {
+    while ( _num_variables < num_variables )
+    {
+      _glucose->newVar();
+      ++_num_variables;
+    }
+    _stats.num_variables = std::max<uint64_t>( _stats.num_variables, _num_variables );
+  }
+
   /*! \brief Check satisfiability under assumptions with respect to the conflict budget
    *
    * \param assumption A vector of assumption literals assumed to be true
@@ -284,23 +410,10 @@ public:
   {
     _glucose->budgetOff();
 
-    Glucose::vec<Glucose::Lit> ass;
-    if ( assumptions.size() > 0 )
-    {
-      for ( const auto& l : assumptions )
-      {
-        const uint32_t v = abs( l ) - 1;
-        while ( _num_variables <= v )
-        {
-          _glucose->newVar();
-          ++_num_variables;
-        }
-        ass.push( Glucose::mkLit( v, l < 0 ) );
-      }
-    }
+    load_literals( std::begin( assumptions ), std::end( assumptions ) );
 
-    auto const result = _glucose->solve( ass );
-    if ( result )
+    auto const result = record_solve( [&]() { return _glucose->solve( _lits ) ? Glucose::l_True : Glucose::l_False; } );
+    if ( result == Glucose::l_True )
     {
       return ( _state = state::sat );
     }
@@ -318,23 +431,13 @@ public:
    */
   state solve_limited( std::vector<int> const& assumptions = {} )
   {
-    Glucose::vec<Glucose::Lit> ass;
-    if ( assumptions.size() > 0 )
-    {
-      for ( const auto& l : assumptions )
-      {
-        const uint32_t v = abs( l ) - 1;
-        while ( _num_variables <= v )
-        {
-          _glucose->newVar();
-          ++_num_variables;
-        }
-        ass.push( Glucose::mkLit( v, l < 0 ) );
-      }
-    }
+    load_literals( std::begin( assumptions ), std::end( assumptions ) );
+
+    /* the budget applies to each call */
+    _glucose->setConfBudget( _ps.budget );
 
-    auto const result = _glucose->solveLimited( ass );
-    if ( result == Glucose::l_Undef || int32_t(_glucose->conflicts) >= _ps.budget )
+    auto const result = record_solve( [&]() { return _glucose->solveLimited( _lits ); } );
+    if ( result == Glucose::l_Undef )
     {
       return ( _state = state::dirty );
     }
@@ -355,18 +458,103 @@ public:
     /* update state */
     _state = state::dirty;
 
-    Glucose::vec<Glucose::Lit> cl;
-    for ( const auto& l : clause )
+    load_literals( std::begin( clause ), std::end( clause ) );
+    _glucose->addClause_( _lits );
+
+    ++_stats.num_clauses;
+    _stats.num_literals += clause.size();
+  }
+
+  /*! \brief Add many clauses to the SAT-solver at once
+   *
+   * The clauses are given as one flat vector of literals in which
+   * each clause is terminated by 0, e.g., {1, -2, 0, 2, 3, 0}.  The
+   * last clause must be terminated as well.
+   *
+   * \param literals Zero-terminated clauses
+   */
+  void add_clauses( std::vector<int> const& literals )
+  {
+    assert( literals.empty() || literals.back() == 0 );
+
+    /* update state */
+    _state = state::dirty;
+
+    int32_t max_var = 0;
+    for ( const auto& l : literals )
+    {
+      max_var = std::max( max_var, abs( l ) );
+    }
+    reserve_variables( max_var );
+
+    auto begin = std::begin( literals );
+    while ( begin != std::end( literals ) )
     {
-      const uint32_t v = abs( l ) - 1;
-      while ( _num_variables <= v )
+      auto const end = std::find( begin, std::end( literals ), 0 );
+
+      _lits.clear();
+      for ( auto it = begin; it != end; ++it )
       {
-        _glucose->newVar();
-        ++_num_variables;
+        _lits.push( Glucose::mkLit( abs( *it ) - 1, *it < 0 ) );
       }
-      cl.push( Glucose::mkLit( v, l < 0 ) );
+      _glucose->addClause_( _lits );
+
+      ++_stats.num_clauses;
+      _stats.num_literals += std::distance( begin, end );
+      begin = std::next( end );
+    }
+  }
+
+  /*! \brief Sets the preferred polarity of a variable
+   *
+   * The decision heuristic branches first on the given literal.
+   *
+   * \param lit A literal
+   */
+  void set_phase( int lit )
+  {
+    assert( lit != 0 );
+    reserve_variables( abs( lit ) );
+    _glucose->setPolarity( abs( lit ) - 1, lit < 0 );
+  }
+
+  /*! \brief Exports learnt clauses
+   *
+   * Returns the learnt clauses (including the units derived at
+   * decision level 0) with at most max_size literals that only refer
+   * to variables with ids less or equal to max_var.  The clauses can
+   * be imported into another solver whose clauses imply the clauses
+   * of this solver when projected onto these variables.
+   *
+   * \param max_size Maximum number of literals of a clause
+   * \param max_var Largest variable id of an exported clause
+   */
+  std::vector<std::vector<int>> export_learnt_clauses( uint32_t max_size, uint32_t max_var ) const
+  {
+    std::vector<std::vector<int>> clauses;
+    _glucose->foreach_learnt_clause( [&]( std::vector<int> const& clause ){
+        if ( clause.size() <= max_size &&
+             std::all_of( std::begin( clause ), std::end( clause ), [&]( int l ){ return uint32_t( abs( l ) ) <= max_var; } ) )
+        {
+          clauses.emplace_back( clause );
+        }
+      });
+    return clauses;
+  }
+
+  /*! \brief Imports clauses learnt by another solver
+   *
+   * The caller has to ensure that the clauses are implied by the
+   * clauses of this solver.
+   *
+   * \param clauses Clauses
+   */
+  void import_learnt_clauses( std::vector<std::vector<int>> const& clauses )
+  {
+    for ( const auto& c : clauses )
+    {
+      add_clause( c );
     }
-    _glucose->addClause( cl );
   }
 
   /*! \brief Returns model if solver is in state SAT */
@@ -375,14 +563,28 @@ public:
     assert( is_sat() );
 
     const uint32_t size = _glucose->model.size();
-    utils::dynamic_bitset<> m;
+    utils::dynamic_bitset<> m( size );
     for ( auto i = 0u; i < size; ++i )
     {
-      m.push_back( _glucose->model[i] == Glucose::l_True );
+      if ( _glucose->model[i] == Glucose::l_True )
+      {
+        m.set_bit( i );
+      }
     }
     return model( m );
   }
 
+  /*! \brief Returns a view of the model if solver is in state SAT
+   *
+   * Unlike get_model, the values are not copied; the view is
+   * invalidated by the next call to the SAT-solver.
+   */
+  model_view get_model_view() const
+  {
+    assert( is_sat() );
+    return model_view( _glucose->model );
+  }
+
   /*! \brief Return core if solver is in UNSAT state */
   core<> get_core() const
   {
@@ -416,11 +618,68 @@ public:
   }
 
 protected:
-  std::unique_ptr<Glucose::Solver> _glucose;
+  /*! \brief Translates literals into the literal buffer
+   *
+   * Creates the variables of the literals if necessary.
+   */
+  template<typename Iterator>
+  void load_literals( Iterator begin, Iterator end )
+  {
+    _lits.clear();
+    for ( auto it = begin; it != end; ++it )
+    {
+      reserve_variables( abs( *it ) );
+      _lits.push( Glucose::mkLit( abs( *it ) - 1, *it < 0 ) );
+    }
+  }
+
+  /*! \brief Calls the SAT-solver and records time and search effort */
+  template<typename Fn>
+  Glucose::lbool record_solve( Fn&& fn )
+  {
+    auto const conflicts = _glucose->conflicts;
+    auto const decisions = _glucose->decisions;
+    auto const propagations = _glucose->propagations;
+
+    utils::stopwatch<>::duration time{0};
+    auto const result = [&]() {
+      utils::trace_span span( "sat_solver::solve", "sat2" );
+      utils::stopwatch t( time );
+      return fn();
+    }();
+
+    ++_stats.num_calls;
+    if ( result == Glucose::l_True )
+    {
+      ++_stats.num_sat;
+    }
+    else if ( result == Glucose::l_False )
+    {
+      ++_stats.num_unsat;
+    }
+    else
+    {
+      ++_stats.num_undef;
+    }
+    _stats.num_variables = std::max<uint64_t>( _stats.num_variables, _num_variables );
+    _stats.conflicts += _glucose->conflicts - conflicts;
+    _stats.decisions += _glucose->decisions - decisions;
+    _stats.propagations += _glucose->propagations - propagations;
+    _stats.time_solve += time;
+    _stats.time_last_solve = time;
+    _stats.time_max_solve = std::max( _stats.time_max_solve, time );
+    return result;
+  }
+
+protected:
+  std::unique_ptr<sat::detail::glucose_solver> _glucose;
   sat_solver_statistics& _stats;
   sat_solver_params const& _ps;
   state _state{state::fresh};
   uint32_t _num_variables{0};
+
+  /* literal buffer reused for all clauses and assumptions */
+  Glucose::vec<Glucose::Lit> _lits;
 }; /* sat_solver */
 
 } /* namespace easy::sat2 */
@@ -0,0 +1,97 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file bit_operations.hpp
+  \brief Portable bit operations on 64-bit words
+
+  The operations use compiler intrinsics where available and portable
+  fallbacks otherwise.
+*/
+
+#pragma once
+
+#include <bitset>
+#include <cassert>
+#include <cstdint>
+
+#if defined( _MSC_VER ) && !defined( __clang__ )
+#include <intrin.h>
+#endif
+
+namespace easy::utils
+{
+
+namespace detail
+{
+
+/* index of the lowest set bit by de Bruijn multiplication */
+inline uint32_t count_trailing_zeros_de_bruijn( uint64_t x )
+{
+  static constexpr uint8_t table[64] = {
+       0,  1, 48,  2, 57, 49, 28,  3, 61, 58, 50, 42, 38, 29, 17,  4,
+      62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12,  5,
+      63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+      46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19,  9, 13,  8,  7,  6};
+  return table[( ( x & ( ~x + 1u ) ) * 0x03f79d71b4cb0a89ull ) >> 58u];
+}
+
+} /* namespace detail */
+
+/*! \brief Returns the number of set bits of a word */
+inline uint32_t popcount( uint64_t x )
+{
+#if defined( __GNUC__ ) || defined( __clang__ )
+  return __builtin_popcountll( x );
+#else
+  return uint32_t( std::bitset<64>( x ).count() );
+#endif
+}
+
+/*! \brief Returns the index of the lowest set bit of a word
+ *
+ * \param x Word (must not be 0)
+ */
+inline uint32_t count_trailing_zeros( uint64_t x )
+{
+  assert( x != 0u );
+#if defined( __GNUC__ ) || defined( __clang__ )
+  return __builtin_ctzll( x );
+#elif defined( _MSC_VER ) && ( defined( _M_X64 ) || defined( _M_ARM64 ) )
+  unsigned long index;
+  _BitScanForward64( &index, x );
+  return uint32_t( index );
+#else
+  return detail::count_trailing_zeros_de_bruijn( x );
+#endif
+}
+
+} /* namespace easy::utils */
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
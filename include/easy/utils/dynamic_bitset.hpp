@@ -32,18 +32,29 @@
 
 #pragma once
 
+#include <easy/utils/bit_operations.hpp>
+
+#include <algorithm>
 #include <vector>
 #include <cassert>
+#include <cstdint>
+#include <limits>
 
 namespace easy::utils
 {
 
-template<typename Block = uint32_t, typename Allocator = std::allocator<Block>>
+template<typename Block = uint64_t, typename Allocator = std::allocator<Block>>
 class dynamic_bitset;
 
 /*! \brief dynamic_bitset
  *
  * An implementation of a bitset with non-predefined size.
+ *
+ * Besides single-bit access, the bitset provides word-wide bulk
+ * operations (AND, OR, XOR, popcount, search for set bits), which
+ * process one block per iteration.  The loops are kept free of
+ * dependencies between blocks, such that the compiler can vectorize
+ * them.
  */
 template<typename Block, typename Allocator>
 class dynamic_bitset
@@ -71,10 +82,26 @@ public:
    *
    * \param other Another dynamic_bitset.
    */
-  explicit dynamic_bitset( const dynamic_bitset<>& other )
-    : _bits( other._bits )
-    , _num_bits( other._num_bits )
-  {}
+  dynamic_bitset( const dynamic_bitset& other ) = default;
+
+  /*! \brief Move constructor of dynamic_bitset
+   *
+   * \param other Another dynamic_bitset.
+   */
+  dynamic_bitset( dynamic_bitset&& other ) noexcept = default;
+
+  /*! \brief Constructor of dynamic_bitset with num_bits bits
+   *
+   * \param num_bits Number of bits
+   * \param value Initial value of the bits
+   */
+  explicit dynamic_bitset( size_type num_bits, bool value = false )
+  {
+    resize( num_bits, value );
+  }
+
+  dynamic_bitset& operator=( const dynamic_bitset& other ) = default;
+  dynamic_bitset& operator=( dynamic_bitset&& other ) noexcept = default;
 
   /*! \brief Destructor of dynamic_bitset */
   ~dynamic_bitset() {}
@@ -156,9 +183,18 @@ public:
    */
   void push_back( bool value )
   {
-    const size_type sz = num_bits();
-    resize( sz + 1 );
-    set_bit( sz, value );
+    /* a new block is only needed if all blocks are filled, growth of the
+       block storage is amortized by std::vector */
+    if ( count_extra_bits() == 0 )
+    {
+      _bits.push_back( Block( 0 ) );
+    }
+
+    if ( value )
+    {
+      _bits.back() |= bit_mask( _num_bits );
+    }
+    ++_num_bits;
   }
 
   /* \brief Append a block to the dynamic_bitset
@@ -295,6 +331,151 @@ public:
     return ( _bits[block_index( pos )] & bit_mask( pos ) ) != 0;
   }
 
+  /*! \brief Number of set bits */
+  size_type count() const noexcept
+  {
+    size_type n = 0;
+    for ( const auto& b : _bits )
+    {
+      n += popcount( b );
+    }
+    return n;
+  }
+
+  /*! \brief Checks if any bit is set */
+  bool any() const noexcept
+  {
+    return std::any_of( _bits.begin(), _bits.end(), []( Block b ) { return b != 0; } );
+  }
+
+  /*! \brief Checks if no bit is set */
+  bool none() const noexcept
+  {
+    return !any();
+  }
+
+  /*! \brief Position of the first set bit
+   *
+   * Returns npos if no bit is set.
+   */
+  size_type find_first() const noexcept
+  {
+    return find_from_block( 0 );
+  }
+
+  /*! \brief Position of the first set bit after pos
+   *
+   * Returns npos if no bit after pos is set.
+   *
+   * \param pos A position in the dynamic_bitset
+   */
+  size_type find_next( size_type pos ) const noexcept
+  {
+    if ( pos == npos || pos + 1 >= _num_bits )
+    {
+      return npos;
+    }
+
+    ++pos;
+    const size_type blk = block_index( pos );
+    const Block rest = _bits[blk] >> bit_index( pos );
+    return rest ? pos + ctz( rest ) : find_from_block( blk + 1 );
+  }
+
+  /*! \brief Flips all bits
+   *
+   * Returns a reference to the current dynamic_bitset
+   */
+  dynamic_bitset& flip() noexcept
+  {
+    for ( auto& b : _bits )
+    {
+      b = ~b;
+    }
+    _zero_unused_bits();
+    return *this;
+  }
+
+  /*! \brief Bitwise AND with a dynamic_bitset of the same size */
+  dynamic_bitset& operator&=( const dynamic_bitset& other )
+  {
+    assert( _num_bits == other._num_bits );
+    Block* __restrict dst = _bits.data();
+    const Block* __restrict src = other._bits.data();
+    for ( size_type i = 0; i < _bits.size(); ++i )
+    {
+      dst[i] &= src[i];
+    }
+    return *this;
+  }
+
+  /*! \brief Bitwise OR with a dynamic_bitset of the same size */
+  dynamic_bitset& operator|=( const dynamic_bitset& other )
+  {
+    assert( _num_bits == other._num_bits );
+    Block* __restrict dst = _bits.data();
+    const Block* __restrict src = other._bits.data();
+    for ( size_type i = 0; i < _bits.size(); ++i )
+    {
+      dst[i] |= src[i];
+    }
+    return *this;
+  }
+
+  /*! \brief Bitwise XOR with a dynamic_bitset of the same size
+   *
+   * This is the row addition of Gaussian elimination over GF(2).
+   */
+  dynamic_bitset& operator^=( const dynamic_bitset& other )
+  {
+    assert( _num_bits == other._num_bits );
+    Block* __restrict dst = _bits.data();
+    const Block* __restrict src = other._bits.data();
+    for ( size_type i = 0; i < _bits.size(); ++i )
+    {
+      dst[i] ^= src[i];
+    }
+    return *this;
+  }
+
+  /*! \brief Exchanges the contents with another dynamic_bitset in constant time */
+  void swap( dynamic_bitset& other ) noexcept
+  {
+    _bits.swap( other._bits );
+    std::swap( _num_bits, other._num_bits );
+  }
+
+  bool operator==( const dynamic_bitset& other ) const
+  {
+    return _num_bits == other._num_bits && _bits == other._bits;
+  }
+
+  bool operator!=( const dynamic_bitset& other ) const
+  {
+    return !( *this == other );
+  }
+
+  /*! \brief Block at a block index */
+  Block get_block( size_type index ) const
+  {
+    assert( index < num_blocks() );
+    return _bits[index];
+  }
+
+  /*! \brief Overwrites the block at a block index
+   *
+   * Bits beyond num_bits() in the last block are cleared.
+   */
+  void set_block( size_type index, Block value )
+  {
+    assert( index < num_blocks() );
+    _bits[index] = value;
+    if ( index + 1 == num_blocks() )
+    {
+      _zero_unused_bits();
+    }
+  }
+
 public:
   /*! \brief Compute the block of a position
    *
@@ -317,6 +498,28 @@ public:
   }
 
 protected:
+  static size_type popcount( Block b ) noexcept
+  {
+    return utils::popcount( uint64_t( b ) );
+  }
+
+  static size_type ctz( Block b ) noexcept
+  {
+    return utils::count_trailing_zeros( uint64_t( b ) );
+  }
+
+  size_type find_from_block( size_type first ) const noexcept
+  {
+    for ( auto i = first; i < _bits.size(); ++i )
+    {
+      if ( _bits[i] )
+      {
+        return i * bits_per_block + ctz( _bits[i] );
+      }
+    }
+    return npos;
+  }
+
   static Block bit_mask( size_type pos )
   {
     return Block( 1 ) << bit_index( pos );
@@ -0,0 +1,103 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file parallel.hpp
+  \brief Simple data-parallel loops
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace easy::utils
+{
+
+/*! \brief Parallel for loop
+ *
+ * Calls `fn( i )` for every `i` in `[begin, end)`.  The range is split
+ * into `num_threads` contiguous chunks of (almost) equal size, each of
+ * which is processed by its own thread.  The loop runs sequentially in
+ * the calling thread if `num_threads` is at most 1 or if the range is
+ * shorter than `num_threads`.
+ *
+ * The calls to `fn` must be independent of each other.
+ *
+ * \param begin First index
+ * \param end One past the last index
+ * \param fn Loop body, called with the index
+ * \param num_threads Maximum number of threads
+ */
+template<typename Fn>
+inline void parallel_for( uint64_t begin, uint64_t end, Fn&& fn, uint32_t num_threads = std::thread::hardware_concurrency() )
+{
+  if ( begin >= end )
+    return;
+
+  uint64_t const size = end - begin;
+  if ( num_threads <= 1u || size < num_threads )
+  {
+    for ( auto i = begin; i < end; ++i )
+    {
+      fn( i );
+    }
+    return;
+  }
+
+  uint64_t const chunk = ( size + num_threads - 1u ) / num_threads;
+
+  std::vector<std::thread> threads;
+  threads.reserve( num_threads );
+  for ( auto t = 0u; t < num_threads; ++t )
+  {
+    uint64_t const first = begin + t * chunk;
+    uint64_t const last = std::min( end, first + chunk );
+    if ( first >= last )
+      break;
+
+    threads.emplace_back( [&fn, first, last]() {
+        for ( auto i = first; i < last; ++i )
+        {
+          fn( i );
+        }
+      } );
+  }
+
+  for ( auto& t : threads )
+  {
+    t.join();
+  }
+}
+
+} /* namespace easy::utils */
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,469 @@
+/* easy: C++ ESOP library
+ * Copyright (C) 2018  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*!
+  \file trace.hpp
+  \brief Scoped trace spans with Chrome trace-event output
+*/
+
+#pragma once
+
+#include <json/json.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace easy::utils
+{
+
+/*! \brief A completed trace span
+ *
+ * Times are given in nanoseconds since the tracer was created.  The
+ * name and the category must be string literals.
+ */
+struct trace_event
+{
+  char const* name;
+  char const* category;
+  uint64_t begin;
+  uint64_t duration;
+};
+
+/*! \brief Ring buffer of the trace events of one thread
+ *
+ * Only the owning thread pushes events, which never blocks: once the
+ * buffer is full, the oldest events are overwritten.  Readers may run
+ * concurrently.  Each slot carries a sequence number that is made odd
+ * while the slot is written, as in a seqlock, such that events that are
+ * overwritten while being read are recognized and dropped.
+ *
+ * The slots are allocated in chunks when they are written for the first
+ * time, such that a buffer of a thread that records few events stays
+ * small.  The slots never move, hence readers need no lock.
+ */
+class trace_buffer
+{
+public:
+  /*! \brief Number of slots that are allocated at once */
+  static constexpr uint64_t chunk_size = 256u;
+
+  /*! \brief Constructor
+   *
+   * \param thread_id Id of the owning thread in the trace
+   * \param capacity Number of events, rounded up to a power of 2
+   */
+  explicit trace_buffer( uint32_t thread_id, uint64_t capacity )
+    : _thread_id( thread_id )
+  {
+    uint64_t size = 1u;
+    while ( size < capacity )
+    {
+      size <<= 1u;
+    }
+    _mask = size - 1u;
+    _chunk_size = std::min( size, chunk_size );
+
+    auto const num_chunks = size / _chunk_size;
+    _chunks = std::make_unique<std::atomic<slot*>[]>( num_chunks );
+    for ( auto c = 0u; c < num_chunks; ++c )
+    {
+      _chunks[c].store( nullptr, std::memory_order_relaxed );
+    }
+  }
+
+  ~trace_buffer()
+  {
+    for ( auto c = 0u; c < capacity() / _chunk_size; ++c )
+    {
+      delete[] _chunks[c].load( std::memory_order_relaxed );
+    }
+  }
+
+  trace_buffer( trace_buffer const& ) = delete;
+  trace_buffer& operator=( trace_buffer const& ) = delete;
+
+  /*! \brief Returns the id of the owning thread */
+  uint32_t thread_id() const
+  {
+    return _thread_id;
+  }
+
+  /*! \brief Returns the number of events that fit into the buffer */
+  uint64_t capacity() const
+  {
+    return _mask + 1u;
+  }
+
+  /*! \brief Returns the number of slots that have been allocated */
+  uint64_t num_allocated() const
+  {
+    return _num_allocated.load( std::memory_order_relaxed );
+  }
+
+  /*! \brief Returns the number of events pushed since the last clear */
+  uint64_t num_pushed() const
+  {
+    return _head.load( std::memory_order_acquire );
+  }
+
+  /*! \brief Records an event (only called by the owning thread) */
+  void push( trace_event const& e )
+  {
+    auto const head = _head.load( std::memory_order_relaxed );
+    auto& chunk = _chunks[( head & _mask ) / _chunk_size];
+    if ( chunk.load( std::memory_order_relaxed ) == nullptr )
+    {
+      chunk.store( new slot[_chunk_size], std::memory_order_release );
+      _num_allocated.fetch_add( _chunk_size, std::memory_order_relaxed );
+    }
+    auto& s = chunk.load( std::memory_order_relaxed )[head & ( _chunk_size - 1u )];
+
+    /* mark the slot as being written before the data is changed */
+    s.sequence.store( 2u * head + 1u, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+
+    s.name.store( e.name, std::memory_order_relaxed );
+    s.category.store( e.category, std::memory_order_relaxed );
+    s.begin.store( e.begin, std::memory_order_relaxed );
+    s.duration.store( e.duration, std::memory_order_relaxed );
+
+    s.sequence.store( 2u * head + 2u, std::memory_order_release );
+    _head.store( head + 1u, std::memory_order_release );
+  }
+
+  /*! \brief Returns the buffered events from the oldest to the newest */
+  std::vector<trace_event> events() const
+  {
+    auto const head = _head.load( std::memory_order_acquire );
+    auto const first = head > capacity() ? head - capacity() : 0u;
+
+    std::vector<trace_event> result;
+    result.reserve( head - first );
+    for ( auto i = first; i < head; ++i )
+    {
+      auto const* chunk = _chunks[( i & _mask ) / _chunk_size].load( std::memory_order_acquire );
+      if ( chunk == nullptr )
+      {
+        continue;
+      }
+      auto const& s = chunk[i & ( _chunk_size - 1u )];
+      auto const sequence = s.sequence.load( std::memory_order_acquire );
+      trace_event const e{s.name.load( std::memory_order_relaxed ), s.category.load( std::memory_order_relaxed ),
+                          s.begin.load( std::memory_order_relaxed ), s.duration.load( std::memory_order_relaxed )};
+      std::atomic_thread_fence( std::memory_order_acquire );
+
+      /* drop the event if the owning thread has started to overwrite it */
+      if ( sequence == 2u * i + 2u && s.sequence.load( std::memory_order_relaxed ) == sequence )
+      {
+        result.push_back( e );
+      }
+    }
+    return result;
+  }
+
+  /*! \brief Removes all events
+   *
+   * Must not be called while the owning thread pushes events.
+   */
+  void clear()
+  {
+    _head.store( 0u, std::memory_order_release );
+  }
+
+  /*! \brief Marks the buffer as free for another thread
+   *
+   * Called when the owning thread exits.  The recorded events are kept.
+   */
+  void retire()
+  {
+    _retired.store( true, std::memory_order_release );
+  }
+
+  /*! \brief Takes over a retired buffer, returns false if it is in use */
+  bool reclaim()
+  {
+    auto expected = true;
+    return _retired.compare_exchange_strong( expected, false, std::memory_order_acquire );
+  }
+
+private:
+  struct slot
+  {
+    /* 2i + 1 while event i is written, 2i + 2 once it is complete */
+    std::atomic<uint64_t> sequence{0u};
+    std::atomic<char const*> name{nullptr};
+    std::atomic<char const*> category{nullptr};
+    std::atomic<uint64_t> begin{0u};
+    std::atomic<uint64_t> duration{0u};
+  };
+
+  uint32_t _thread_id;
+  uint64_t _mask;
+  uint64_t _chunk_size;
+  std::unique_ptr<std::atomic<slot*>[]> _chunks;
+  std::atomic<uint64_t> _num_allocated{0u};
+  std::atomic<uint64_t> _head{0u};
+  std::atomic<bool> _retired{false};
+}; /* trace_buffer */
+
+/*! \brief Process-wide collector of trace spans
+ *
+ * Tracing is disabled by default, in which case a span costs a single
+ * atomic load.  Each thread records into a ring buffer of its own,
+ * which is registered with the tracer on the first recorded span.  When
+ * the thread exits, its buffer is retired, but kept with its events, and
+ * handed to the next thread that records its first span.  Hence, the
+ * number of buffers is bounded by the largest number of threads that
+ * trace at the same time, regardless of how many threads are spawned
+ * over time.  The collected spans can be written as Chrome
+ * trace-event JSON, which can be opened in `chrome://tracing` or
+ * Perfetto.
+ */
+class tracer
+{
+public:
+  using clock = std::chrono::steady_clock;
+
+  /*! \brief Returns the tracer */
+  static tracer& instance()
+  {
+    static tracer t;
+    return t;
+  }
+
+  /*! \brief Enables tracing
+   *
+   * \param capacity Maximum number of events per thread; applies to
+   *                 buffers that are created afterwards
+   */
+  void enable( uint64_t capacity = 1u << 16u )
+  {
+    _capacity.store( capacity, std::memory_order_relaxed );
+    _enabled.store( true, std::memory_order_release );
+  }
+
+  /*! \brief Disables tracing (recorded events are kept) */
+  void disable()
+  {
+    _enabled.store( false, std::memory_order_release );
+  }
+
+  /*! \brief Returns true if and only if tracing is enabled */
+  bool is_enabled() const
+  {
+    return _enabled.load( std::memory_order_relaxed );
+  }
+
+  /*! \brief Returns the nanoseconds passed since the tracer was created */
+  uint64_t now() const
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>( clock::now() - _epoch ).count();
+  }
+
+  /*! \brief Returns the ring buffer of the calling thread
+   *
+   * Takes over a retired buffer if there is one, otherwise creates a
+   * new one.  The buffer is retired when the calling thread exits.
+   */
+  trace_buffer& local_buffer()
+  {
+    thread_local buffer_holder holder;
+    if ( !holder.buffer )
+    {
+      std::lock_guard<std::mutex> lock( _mutex );
+      auto it = std::find_if( _buffers.begin(), _buffers.end(), []( auto const& b ) { return b->reclaim(); } );
+      if ( it != _buffers.end() )
+      {
+        holder.buffer = *it;
+      }
+      else
+      {
+        holder.buffer = std::make_shared<trace_buffer>( uint32_t( _buffers.size() + 1u ), _capacity.load( std::memory_order_relaxed ) );
+        _buffers.push_back( holder.buffer );
+      }
+    }
+    return *holder.buffer;
+  }
+
+  /*! \brief Returns the number of ring buffers, including retired ones */
+  uint64_t num_buffers() const
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    return _buffers.size();
+  }
+
+  /*! \brief Returns the number of buffered events of all threads */
+  uint64_t num_events() const
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    uint64_t count = 0u;
+    for ( const auto& b : _buffers )
+    {
+      count += std::min( b->num_pushed(), b->capacity() );
+    }
+    return count;
+  }
+
+  /*! \brief Removes all events
+   *
+   * Must not be called while traced code runs.
+   */
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    for ( auto& b : _buffers )
+    {
+      b->clear();
+    }
+  }
+
+  /*! \brief Returns the events in Chrome trace-event format */
+  nlohmann::json chrome_trace() const
+  {
+    nlohmann::json events = nlohmann::json::array();
+
+    std::lock_guard<std::mutex> lock( _mutex );
+    for ( const auto& b : _buffers )
+    {
+      events.push_back( {{"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", b->thread_id()},
+                         {"args", {{"name", "thread " + std::to_string( b->thread_id() )}}}} );
+      for ( const auto& e : b->events() )
+      {
+        events.push_back( {{"name", e.name}, {"cat", e.category}, {"ph", "X"}, {"pid", 1}, {"tid", b->thread_id()},
+                           {"ts", e.begin / 1000.0}, {"dur", e.duration / 1000.0}} );
+      }
+    }
+
+    return {{"traceEvents", events}, {"displayTimeUnit", "ms"}};
+  }
+
+  /*! \brief Writes the events in Chrome trace-event format
+   *
+   * \param os Output stream
+   */
+  void write_chrome_trace( std::ostream& os ) const
+  {
+    os << chrome_trace().dump() << std::endl;
+  }
+
+private:
+  tracer()
+    : _epoch( clock::now() )
+  {}
+
+  /* retires the buffer of a thread when the thread exits */
+  struct buffer_holder
+  {
+    ~buffer_holder()
+    {
+      if ( buffer )
+      {
+        buffer->retire();
+      }
+    }
+
+    std::shared_ptr<trace_buffer> buffer;
+  };
+
+private:
+  std::atomic<bool> _enabled{false};
+  std::atomic<uint64_t> _capacity{1u << 16u};
+  clock::time_point _epoch;
+
+  mutable std::mutex _mutex;
+  std::vector<std::shared_ptr<trace_buffer>> _buffers;
+}; /* tracer */
+
+/*! \brief Scoped trace span
+ *
+ * Records the time between construction and destruction as event of
+ * the calling thread if tracing is enabled at construction.
+
+   \verbatim embed:rst
+
+   Example
+
+   .. code-block:: c++
+
+      utils::tracer::instance().enable();
+
+      { // some block
+        utils::trace_span span( "solve", "sat" );
+
+        // do some work
+      } // span is recorded here
+
+      std::ofstream os( "trace.json" );
+      utils::tracer::instance().write_chrome_trace( os );
+   \endverbatim
+ */
+class trace_span
+{
+public:
+  /*! \brief Constructor
+   *
+   * \param name Name of the span (string literal)
+   * \param category Category of the span (string literal)
+   */
+  explicit trace_span( char const* name, char const* category = "easy" )
+    : _name( name )
+    , _category( category )
+    , _active( tracer::instance().is_enabled() )
+    , _begin( _active ? tracer::instance().now() : 0u )
+  {}
+
+  trace_span( trace_span const& ) = delete;
+  trace_span& operator=( trace_span const& ) = delete;
+
+  ~trace_span()
+  {
+    if ( _active )
+    {
+      auto& t = tracer::instance();
+      t.local_buffer().push( {_name, _category, _begin, t.now() - _begin} );
+    }
+  }
+
+private:
+  char const* _name;
+  char const* _category;
+  bool _active;
+  uint64_t _begin;
+}; /* trace_span */
+
+} /* namespace easy::utils */
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,78 @@
+#include <catch.hpp>
+
+#include <easy/algorithms/kronecker_decomposition.hpp>
+#include <kitty/kitty.hpp>
+
+#include <random>
+
+namespace
+{
+
+/* number of Kronecker terms by plain recursion, without merging */
+uint32_t count_kronecker_terms( kitty::dynamic_truth_table const& tt, std::vector<decomposition_type> const& decomps, uint32_t var_index )
+{
+  if ( kitty::is_const0( tt ) )
+    return 0u;
+  if ( var_index == uint32_t( tt.num_vars() ) )
+    return 1u;
+
+  auto const tt0 = kitty::cofactor0( tt, var_index );
+  auto const tt1 = kitty::cofactor1( tt, var_index );
+  switch ( decomps[var_index] )
+  {
+  case decomposition_type::positive_davio:
+    return count_kronecker_terms( tt0, decomps, var_index + 1 ) + count_kronecker_terms( tt0 ^ tt1, decomps, var_index + 1 );
+  case decomposition_type::negative_davio:
+    return count_kronecker_terms( tt1, decomps, var_index + 1 ) + count_kronecker_terms( tt0 ^ tt1, decomps, var_index + 1 );
+  default:
+    return count_kronecker_terms( tt0, decomps, var_index + 1 ) + count_kronecker_terms( tt1, decomps, var_index + 1 );
+  }
+}
+
+} // namespace
+
+TEST_CASE( "Kronecker costs agree with plain recursion", "[kronecker]" )
+{
+  std::mt19937 rng( 0x3 );
+  for ( auto i = 0; i < 5; ++i )
+  {
+    kitty::dynamic_truth_table tt( 4u );
+    kitty::create_random( tt, rng() );
+
+    auto const costs = kronecker_costs( tt );
+    REQUIRE( costs.size() == 81u );
+    for ( auto index = 0u; index < costs.size(); ++index )
+    {
+      CHECK( costs[index] == count_kronecker_terms( tt, decomposition_vector( index, 4u ), 0u ) );
+    }
+
+    auto const result = optimum_kronecker_decomposition( tt );
+    CHECK( result.num_terms == *std::min_element( costs.begin(), costs.end() ) );
+    CHECK( result.cubes.size() <= result.num_terms );
+    CHECK( !result.is_pseudo_kronecker );
+
+    kitty::dynamic_truth_table tt_esop( 4u );
+    kitty::create_from_cubes( tt_esop, result.cubes, true );
+    CHECK( tt_esop == tt );
+  }
+}
+
+TEST_CASE( "Optimum Kronecker and pseudo-Kronecker forms", "[kronecker]" )
+{
+  kitty::dynamic_truth_table tt( 8u );
+  kitty::create_random( tt, 0xbeef );
+
+  auto const kro = optimum_kronecker_decomposition( tt );
+
+  kronecker_params ps;
+  ps.num_threads = 3u;
+  ps.pseudo_kronecker = true;
+  auto const psdkro = optimum_kronecker_decomposition( tt, ps );
+
+  CHECK( psdkro.num_terms == kro.num_terms );
+  CHECK( psdkro.cubes.size() <= kro.cubes.size() );
+
+  kitty::dynamic_truth_table tt_esop( 8u );
+  kitty::create_from_cubes( tt_esop, psdkro.cubes, true );
+  CHECK( tt_esop == tt );
+}
@@ -0,0 +1,175 @@
+#include <catch.hpp>
+
+#include <easy/algorithms/lp.hpp>
+#include <easy/algorithms/lp_index.hpp>
+#include <kitty/kitty.hpp>
+
+#include <mutex>
+#include <random>
+#include <set>
+#include <thread>
+
+TEST_CASE( "LP characteristic vectors of small functions", "[lp]" )
+{
+  kitty::static_truth_table<2> and2;
+  kitty::create_from_hex_string( and2, "8" );
+  CHECK( lp_characteristic_vector( and2 ) == std::vector<uint32_t>{ 1, 1, 1, 1, 2, 2, 2, 2, 4 } );
+
+  kitty::static_truth_table<3> maj;
+  kitty::create_from_hex_string( maj, "e8" );
+  CHECK( lp_characteristic_vector( maj ) == std::vector<uint32_t>{ 3, 3, 3, 3, 4, 4, 4, 4, 4, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 6, 6, 6, 6, 6, 6 } );
+
+  kitty::static_truth_table<4> tt;
+  kitty::create_from_hex_string( tt, "cafe" );
+  CHECK( lp_characteristic_vector( tt ) == std::vector<uint32_t>{
+      6, 6, 6, 6, 6, 6, 6, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+      7, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 9, 9, 9, 9, 9, 9,
+      9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 10, 10, 10, 10, 10, 10, 10, 10, 10, 11, 11, 11, 11, 11, 11, 12, 12 } );
+}
+
+TEST_CASE( "LP characteristic vector is invariant under input permutation and negation", "[lp]" )
+{
+  std::mt19937 rng( 0x1b );
+  for ( auto num_vars = 5u; num_vars <= 10u; ++num_vars )
+  {
+    kitty::dynamic_truth_table tt( num_vars );
+    kitty::create_random( tt, rng() );
+    auto const lp = lp_characteristic_vector( tt );
+    CHECK( lp.size() == detail::pow3[num_vars] );
+
+    auto npn = tt;
+    for ( auto i = 0; i < 5; ++i )
+    {
+      auto const a = rng() % num_vars;
+      auto const b = rng() % num_vars;
+      if ( a != b )
+      {
+        kitty::swap_inplace( npn, a, b );
+      }
+      kitty::flip_inplace( npn, rng() % num_vars );
+    }
+    CHECK( lp_characteristic_vector( npn ) == lp );
+  }
+}
+
+TEST_CASE( "LP characteristic vector does not depend on blocking and threads", "[lp]" )
+{
+  kitty::dynamic_truth_table tt( 11u );
+  kitty::create_random( tt, 0x5eed );
+
+  auto const expected = lp_characteristic_vector( tt, lp_params{1u, 11u} );
+
+  for ( auto block_vars : { 0u, 1u, 4u, 8u } )
+  {
+    for ( auto num_threads : { 1u, 3u, 8u } )
+    {
+      CHECK( lp_characteristic_vector( tt, lp_params{num_threads, block_vars} ) == expected );
+    }
+  }
+
+  /* bit-packed interface */
+  auto const ett = detail::create_extended_truth_table( tt );
+  auto ewt = detail::create_extended_weight_table( ett );
+  std::sort( ewt.begin(), ewt.end() );
+  CHECK( ewt == expected );
+}
+
+TEST_CASE( "Top level of the ternary butterfly runs on several threads", "[lp]" )
+{
+  auto const num_vars = 10u;
+  std::vector<uint32_t> a( detail::pow3[num_vars], 0u );
+
+  /* the top level has a single outer triple */
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  uint64_t num_top_triples = 0u;
+  detail::ternary_butterfly( a, num_vars, [&]( uint32_t& a0, uint32_t& a1, uint32_t& ) {
+      if ( uint64_t( &a1 - &a0 ) == detail::pow3[num_vars - 1u] )
+      {
+        std::lock_guard<std::mutex> lock( mutex );
+        threads.insert( std::this_thread::get_id() );
+        ++num_top_triples;
+      }
+    }, lp_params{4u, 8u} );
+
+  CHECK( num_top_triples == detail::pow3[num_vars - 1u] );
+  CHECK( threads.size() > 1u );
+}
+
+TEST_CASE( "LP index buckets equivalent functions together", "[lp]" )
+{
+  std::mt19937 rng( 0x1d );
+
+  std::vector<kitty::dynamic_truth_table> functions;
+  for ( auto i = 0u; i < 8u; ++i )
+  {
+    kitty::dynamic_truth_table tt( 5u );
+    kitty::create_random( tt, rng() );
+
+    /* a few variants of each function under input negation and permutation */
+    for ( auto j = 0u; j < 4u; ++j )
+    {
+      functions.emplace_back( tt );
+      kitty::swap_inplace( tt, rng() % 4u, 4u );
+      kitty::flip_inplace( tt, rng() % 5u );
+    }
+  }
+
+  lp_index index;
+  for ( auto const& tt : functions )
+  {
+    index.insert( tt );
+  }
+
+  CHECK( index.num_functions() == functions.size() );
+  CHECK( index.num_buckets() <= 8u );
+  for ( auto i = 0u; i < functions.size(); ++i )
+  {
+    CHECK( index.bucket_of( i ) == index.bucket_of( i - i % 4u ) );
+    CHECK( index.find( functions[i] ) == int64_t( index.bucket_of( i ) ) );
+  }
+
+  auto const reprs = index.representatives();
+  CHECK( reprs.size() == index.num_buckets() );
+  for ( auto b = 0u; b < reprs.size(); ++b )
+  {
+    CHECK( index.bucket( b ).front() == reprs[b] );
+  }
+
+  kitty::dynamic_truth_table const0( 5u );
+  CHECK( index.find( const0 ) == -1 );
+}
+
+TEST_CASE( "Exact NP representatives within LP buckets", "[lp]" )
+{
+  /* there are 22 NP classes of 3-input functions */
+  std::set<std::pair<kitty::dynamic_truth_table, kitty::dynamic_truth_table>> classes;
+  kitty::dynamic_truth_table tt( 3u ), care( 3u );
+  kitty::create_from_hex_string( care, "ff" );
+  do
+  {
+    classes.insert( exact_np_representative( tt, care ) );
+    kitty::next_inplace( tt );
+  } while ( !kitty::is_const0( tt ) );
+  CHECK( classes.size() == 22u );
+
+  /* NP transformations of function and care set preserve the representative */
+  std::mt19937 rng( 42u );
+  for ( auto i = 0u; i < 20u; ++i )
+  {
+    kitty::dynamic_truth_table bits( 5u ), dc( 5u );
+    kitty::create_random( bits, rng() );
+    kitty::create_random( dc, rng() );
+
+    auto const repr = exact_np_representative( bits, dc );
+    auto const i0 = rng() % 5u, i1 = rng() % 5u, f = rng() % 5u;
+    kitty::swap_inplace( bits, i0, i1 );
+    kitty::swap_inplace( dc, i0, i1 );
+    kitty::flip_inplace( bits, f );
+    kitty::flip_inplace( dc, f );
+    CHECK( exact_np_representative( bits, dc ) == repr );
+
+    /* the don't cares are part of the function */
+    CHECK( exact_np_representative( bits, ~dc.construct() ) != repr );
+  }
+}
@@ -0,0 +1,169 @@
+#include <catch.hpp>
+
+#include <easy/esop/combine.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/operators.hpp>
+#include <kitty/static_truth_table.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+
+using namespace easy;
+
+/* counts the live allocations to bound the memory of the top-k combination */
+namespace
+{
+std::atomic<int64_t> num_live_allocations{0};
+std::atomic<int64_t> peak_live_allocations{0};
+} // namespace
+
+/* GCC does not see that the replaced operator new allocates with malloc */
+#if defined( __GNUC__ ) && !defined( __clang__ ) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new( std::size_t size )
+{
+  if ( auto* p = std::malloc( size == 0u ? 1u : size ) )
+  {
+    auto const live = ++num_live_allocations;
+    auto peak = peak_live_allocations.load();
+    while ( live > peak && !peak_live_allocations.compare_exchange_weak( peak, live ) )
+    {
+    }
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete( void* p ) noexcept
+{
+  if ( p )
+  {
+    --num_live_allocations;
+    std::free( p );
+  }
+}
+
+void operator delete( void* p, std::size_t ) noexcept
+{
+  ::operator delete( p );
+}
+
+namespace
+{
+
+esop::esop_t random_esop( std::mt19937& rng, uint32_t num_cubes )
+{
+  esop::esop_t e;
+  for ( auto k = 0u; k < num_cubes; ++k )
+  {
+    uint32_t const mask = rng() & 0x7;
+    e.emplace_back( rng() & mask, mask );
+  }
+  return e;
+}
+
+kitty::static_truth_table<4> literal_value( uint8_t i )
+{
+  kitty::static_truth_table<4> x;
+  kitty::create_nth_var( x, 3 );
+  return i == 0 ? ~x : ( i == 1 ? x : ~x.construct() );
+}
+
+kitty::static_truth_table<4> from_cubes( esop::esop_t const& cubes )
+{
+  kitty::static_truth_table<4> tt;
+  kitty::create_from_cubes( tt, cubes, true );
+  return tt;
+}
+
+} // namespace
+
+TEST_CASE( "Combine two ESOPs", "[combine]" )
+{
+  std::mt19937 rng( 0x38 );
+  for ( auto k = 0; k < 20; ++k )
+  {
+    auto const a = random_esop( rng, 4u );
+    auto const b = random_esop( rng, 4u );
+
+    for ( uint8_t i = 0; i <= 2; ++i )
+    {
+      for ( uint8_t j = 0; j <= 2; ++j )
+      {
+        if ( i == j )
+          continue;
+
+        auto const e = esop::complex_combine( a, b, 3, i, j );
+        CHECK( std::is_sorted( e.begin(), e.end() ) );
+        CHECK( e.size() <= a.size() + b.size() );
+        CHECK( from_cubes( e ) == ( ( from_cubes( a ) & literal_value( i ) ) ^ ( from_cubes( b ) & literal_value( j ) ) ) );
+      }
+    }
+  }
+
+  /* common cubes with literal values 0 and 1 lose the literal */
+  CHECK( esop::complex_combine( esop::esop_t{kitty::cube( "1-" )}, esop::esop_t{kitty::cube( "1-" )}, 1, 0, 1 ) == esop::esop_t{kitty::cube( "1-" )} );
+}
+
+TEST_CASE( "Combine sets of ESOPs", "[combine]" )
+{
+  std::mt19937 rng( 0x138 );
+  esop::esops_t as, bs;
+  for ( auto k = 0; k < 6; ++k )
+  {
+    as.emplace_back( random_esop( rng, 3u ) );
+    bs.emplace_back( random_esop( rng, 3u ) );
+  }
+  as.emplace_back( as.front() );
+
+  /* reference: full cross product */
+  esop::esops_t expected;
+  for ( const auto& a : as )
+  {
+    for ( const auto& b : bs )
+    {
+      expected.emplace_back( esop::complex_combine( a, b, 3, 2, 1 ) );
+    }
+  }
+  std::sort( expected.begin(), expected.end() );
+  expected.erase( std::unique( expected.begin(), expected.end() ), expected.end() );
+
+  CHECK( esop::complex_combine( as, bs, 3, 2, 1 ) == expected );
+
+  /* top-k keeps the cheapest combinations */
+  std::stable_sort( expected.begin(), expected.end(), []( auto const& e1, auto const& e2 ) { return e1.size() < e2.size(); } );
+  auto const best = esop::complex_combine( as, bs, 3, 2, 1, 5u );
+  REQUIRE( best.size() == 5u );
+  CHECK( esop::esops_t( expected.begin(), expected.begin() + 5 ) == best );
+
+  CHECK( esop::complex_combine( as, bs, 3, 2, 1, 0u ).empty() );
+  CHECK( esop::complex_combine( as, bs, 3, 2, 1, 1000u ).size() == expected.size() );
+}
+
+TEST_CASE( "Top-k combination keeps only k combinations", "[combine]" )
+{
+  std::mt19937 rng( 0x238 );
+  esop::esops_t as, bs;
+  for ( auto k = 0; k < 40; ++k )
+  {
+    as.emplace_back( random_esop( rng, 5u ) );
+    bs.emplace_back( random_esop( rng, 5u ) );
+  }
+
+  auto const num_distinct = esop::complex_combine( as, bs, 3, 2, 1 ).size();
+  REQUIRE( num_distinct > 1000u );
+
+  auto const live_before = num_live_allocations.load();
+  peak_live_allocations.store( live_before );
+  auto const best = esop::complex_combine( as, bs, 3, 2, 1, 5u );
+  auto const peak = peak_live_allocations.load() - live_before;
+
+  CHECK( best.size() == 5u );
+
+  /* sorted copies of bs, k kept entries, and a few temporaries */
+  CHECK( peak < int64_t( bs.size() ) + 50 );
+}
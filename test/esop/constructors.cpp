@@ -6,6 +6,7 @@
 #include <kitty/print.hpp>
 
 #include <iostream>
+#include <limits>
 #include <numeric>
 
 using namespace easy;
@@ -65,6 +66,53 @@ TEST_CASE( "Create PKRM from random truth table", "[constructors]" )
   }
 }
 
+TEST_CASE( "Create PKRM in parallel from random truth table", "[constructors]" )
+{
+  kitty::dynamic_truth_table tt( 10u );
+
+  for ( auto num_threads : {1u, 2u, 4u, 9u} )
+  {
+    kitty::create_random( tt, num_threads );
+
+    esop::pkrm_params ps;
+    ps.num_threads = num_threads;
+    esop::pkrm_statistics st;
+    auto const cubes = esop::esop_from_optimum_pkrm( tt, ps, st );
+
+    auto tt_copy = tt.construct();
+    create_from_cubes( tt_copy, cubes, true );
+    CHECK( tt == tt_copy );
+    CHECK( st.cache_misses > 0u );
+    CHECK( ( num_threads == 1u ) == ( st.num_tasks == 0u ) );
+  }
+}
+
+TEST_CASE( "Create PKRM with bounded expansion cache", "[constructors]" )
+{
+  kitty::dynamic_truth_table tt( 12u );
+  kitty::create_random( tt, 0x37 );
+
+  esop::pkrm_statistics st_unbounded;
+  auto const unbounded = esop::esop_from_optimum_pkrm( tt, esop::pkrm_params{}, st_unbounded );
+  CHECK( st_unbounded.cache_evictions == 0u );
+
+  for ( auto num_threads : {1u, 4u} )
+  {
+    esop::pkrm_params ps;
+    ps.num_threads = num_threads;
+    ps.cache_capacity = 64u;
+    esop::pkrm_statistics st;
+    auto const cubes = esop::esop_from_optimum_pkrm( tt, ps, st );
+
+    CHECK( st.cache_evictions > 0u );
+    CHECK( st.cache_misses > st_unbounded.cache_misses );
+
+    auto tt_copy = tt.construct();
+    create_from_cubes( tt_copy, cubes, true );
+    CHECK( tt == tt_copy );
+  }
+}
+
 TEST_CASE( "Create ESOP using Boolean learning from random truth table", "[constructors]" )
 {
   kitty::static_truth_table<4> tt;
@@ -116,6 +164,12 @@ TEST_CASE( "Create ESOP using Helliwell-MAXSAT from random truth table", "[const
     auto tt_copy = tt.construct();
     create_from_cubes( tt_copy, cubes, true );
     CHECK( tt == tt_copy );
+
+    CHECK( stats.num_xor_clauses == 16u );
+    CHECK( stats.num_xor_clauses_gauss <= stats.num_xor_clauses );
+    CHECK( stats.num_variables >= 81u );
+    CHECK( stats.maxsat.sat.num_calls > 0u );
+    CHECK( stats.maxsat.sat.num_clauses >= stats.num_clauses );
   }
 }
 
@@ -180,6 +234,52 @@ TEST_CASE( "Create PPRM from dynamic truth table", "[constructors]" )
   }
 }
 
+TEST_CASE( "Create FPRM from random truth table", "[constructors]" )
+{
+  kitty::dynamic_truth_table tt( 9u );
+
+  for ( auto i = 0; i < 20; ++i )
+  {
+    create_random( tt );
+    auto const polarity = uint32_t( i * 37 ) % 512u;
+    auto const cubes = esop::esop_from_fprm( tt, polarity );
+
+    /* literals have the requested polarity */
+    for ( const auto& c : cubes )
+    {
+      CHECK( ( c._bits & polarity ) == 0u );
+      CHECK( ( c._bits | polarity ) == ( c._mask | polarity ) );
+    }
+
+    auto tt_copy = tt.construct();
+    create_from_cubes( tt_copy, cubes, true );
+    CHECK( tt == tt_copy );
+  }
+}
+
+TEST_CASE( "Create optimum FPRM from random truth table", "[constructors]" )
+{
+  kitty::static_truth_table<5> tt;
+
+  for ( auto i = 0; i < 10; ++i )
+  {
+    kitty::create_random( tt );
+
+    auto min_size = std::numeric_limits<std::size_t>::max();
+    for ( auto polarity = 0u; polarity < 32u; ++polarity )
+    {
+      min_size = std::min( min_size, esop::esop_from_fprm( tt, polarity ).size() );
+    }
+
+    auto const cubes = esop::esop_from_optimum_fprm( tt );
+    CHECK( cubes.size() == min_size );
+    CHECK( from_cubes<5>( cubes ) == tt );
+  }
+
+  CHECK( esop::esop_from_optimum_fprm( from_hex<3>( "01" ) ).size() == 1u );
+  CHECK( esop::esop_from_optimum_fprm( from_hex<3>( "00" ) ).empty() );
+}
+
 TEST_CASE( "Create optimum ESOP from random truth table", "[constructors]" )
 {
   static const int size = 4;
@@ -267,3 +367,34 @@ TEST_CASE( "Create optimum ESOP from random truth table", "[constructors]" )
     counter++;
   }
 }
+
+TEST_CASE( "Create optimum ESOP using Helliwell-MAXSAT with warm start", "[constructors]" )
+{
+  using tt_t = kitty::static_truth_table<4>;
+  using rc2_synthesizer_t = esop::esop_from_tt<tt_t, sat2::maxsat_rc2, esop::helliwell_maxsat>;
+  using linear_synthesizer_t = esop::esop_from_tt<tt_t, sat2::maxsat_linear, esop::helliwell_maxsat>;
+
+  esop::helliwell_maxsat_statistics stats;
+  esop::helliwell_maxsat_params ps;
+
+  tt_t tt;
+  for ( auto i = 0; i < 20; ++i )
+  {
+    kitty::create_random( tt );
+
+    auto const initial = esop::esop_from_optimum_pkrm( tt );
+    auto const optimum = rc2_synthesizer_t( stats, ps ).synthesize( tt );
+
+    rc2_synthesizer_t rc2_synth( stats, ps );
+    rc2_synth.warm_start( initial );
+    auto const rc2_cubes = rc2_synth.synthesize( tt );
+    CHECK( from_cubes<4>( rc2_cubes ) == tt );
+    CHECK( rc2_cubes.size() == optimum.size() );
+
+    linear_synthesizer_t linear_synth( stats, ps );
+    linear_synth.warm_start( initial );
+    auto const linear_cubes = linear_synth.synthesize( tt );
+    CHECK( from_cubes<4>( linear_cubes ) == tt );
+    CHECK( linear_cubes.size() == optimum.size() );
+  }
+}
@@ -0,0 +1,74 @@
+#include <catch.hpp>
+
+#include <easy/esop/cube_manipulators.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/dynamic_truth_table.hpp>
+
+#include <random>
+
+using namespace easy;
+
+TEST_CASE( "Add cubes with distance-1 merging", "[cube_manipulators]" )
+{
+  std::mt19937 rng( 0x35 );
+  std::unordered_set<kitty::cube, kitty::hash<kitty::cube>> cubes;
+  std::vector<kitty::cube> inserted;
+
+  for ( auto i = 0; i < 300; ++i )
+  {
+    uint32_t const mask = rng() & 0x7f;
+    uint32_t const bits = rng() & mask;
+    inserted.emplace_back( bits, mask );
+    esop::detail::add_to_cubes( cubes, inserted.back() );
+  }
+
+  /* the cubes implement the XOR of all inserted cubes */
+  kitty::dynamic_truth_table tt( 7u ), tt_merged( 7u );
+  kitty::create_from_cubes( tt, inserted, true );
+  kitty::create_from_cubes( tt_merged, std::vector<kitty::cube>( cubes.begin(), cubes.end() ), true );
+  CHECK( tt == tt_merged );
+
+  /* no pair of cubes can be merged anymore */
+  for ( const auto& c : cubes )
+  {
+    for ( const auto& d : cubes )
+    {
+      CHECK( ( c == d || c.distance( d ) > 1 ) );
+    }
+  }
+}
+
+TEST_CASE( "Find distance-1 cubes by lookup and by scan", "[cube_manipulators]" )
+{
+  std::mt19937 rng( 0x135 );
+  for ( auto k = 0; k < 200; ++k )
+  {
+    std::unordered_set<kitty::cube, kitty::hash<kitty::cube>> cubes;
+    auto const num_cubes = rng() % 30u;
+    for ( auto i = 0u; i < num_cubes; ++i )
+    {
+      uint32_t const mask = rng() & 0x3f;
+      cubes.emplace( rng() & mask, mask );
+    }
+
+    uint32_t const mask = rng() & 0x3f;
+    kitty::cube const c( rng() & mask, mask );
+
+    auto has_neighbour = false;
+    for ( const auto& d : cubes )
+    {
+      has_neighbour = has_neighbour || c.distance( d ) == 1;
+    }
+
+    /* with 6 variables, sets of at least 12 cubes are probed, smaller ones are scanned */
+    for ( auto num_vars : {6u, 32u} )
+    {
+      auto const it = esop::detail::find_distance_one_cube( cubes, c, num_vars );
+      CHECK( ( it != cubes.end() ) == has_neighbour );
+      if ( it != cubes.end() )
+      {
+        CHECK( c.distance( *it ) == 1 );
+      }
+    }
+  }
+}
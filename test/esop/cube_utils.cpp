@@ -0,0 +1,127 @@
+#include <catch.hpp>
+
+#include <easy/esop/cube_utils.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <set>
+#include <utility>
+
+using namespace easy;
+
+TEST_CASE( "Enumerate combinations lazily in colex order", "[cube_utils]" )
+{
+  esop::combination_range const range( 7u, 3u );
+  CHECK( range.size() == 35u );
+
+  std::vector<std::vector<uint32_t>> subsets;
+  for ( const auto& c : range )
+  {
+    CHECK( std::is_sorted( c.begin(), c.end() ) );
+    CHECK( range.unrank( range.rank( c ) ) == c );
+    CHECK( range.rank( c ) == subsets.size() );
+    subsets.emplace_back( c );
+  }
+  REQUIRE( subsets.size() == 35u );
+  CHECK( subsets.front() == std::vector<uint32_t>{0, 1, 2} );
+  CHECK( subsets[1] == std::vector<uint32_t>{0, 1, 3} );
+  CHECK( subsets[2] == std::vector<uint32_t>{0, 2, 3} );
+  CHECK( subsets.back() == std::vector<uint32_t>{4, 5, 6} );
+
+  /* colex order: compare from the largest index */
+  for ( auto i = 1u; i < subsets.size(); ++i )
+  {
+    CHECK( std::lexicographical_compare( subsets[i - 1].rbegin(), subsets[i - 1].rend(), subsets[i].rbegin(), subsets[i].rend() ) );
+  }
+
+  /* sub-ranges by rank */
+  uint64_t count = 0u;
+  for ( const auto& c : esop::combination_range( 7u, 3u, 10u, 20u ) )
+  {
+    CHECK( c == subsets[10u + count] );
+    ++count;
+  }
+  CHECK( count == 10u );
+
+  /* corner cases */
+  CHECK( esop::combination_range( 5u, 0u ).size() == 1u );
+  CHECK( esop::combination_range( 5u, 5u ).size() == 1u );
+  CHECK( esop::combination_range( 40u, 5u ).size() == 658008u );
+  CHECK( esop::combination_range( 40u, 5u ).unrank( 658007u ) == std::vector<uint32_t>{35, 36, 37, 38, 39} );
+}
+
+TEST_CASE( "Enumerate combinations in parallel", "[cube_utils]" )
+{
+  std::atomic<uint64_t> count{0u};
+  std::atomic<uint64_t> sum{0u};
+  esop::parallel_foreach_combination( 12u, 4u, [&]( const auto& c ) {
+    ++count;
+    sum += c[0] + c[1] + c[2] + c[3];
+  }, 3u );
+
+  CHECK( count == 495u );
+  /* every index appears in C(11, 3) subsets */
+  CHECK( sum == 165u * ( 0 + 1 + 2 + 3 + 4 + 5 + 6 + 7 + 8 + 9 + 10 + 11 ) );
+}
+
+TEST_CASE( "Enumerate every combination once for any number of threads", "[cube_utils]" )
+{
+  for ( const auto& [n, t] : {std::pair{7u, 3u}, std::pair{5u, 2u}, std::pair{6u, 0u}} )
+  {
+    esop::combination_range const all( n, t );
+    for ( auto num_threads : {1u, 4u, 7u, 16u} )
+    {
+      std::mutex mutex;
+      std::multiset<std::vector<uint32_t>> seen;
+      esop::parallel_foreach_combination( n, t, [&]( const auto& c ) {
+        std::lock_guard<std::mutex> lock( mutex );
+        seen.insert( c );
+      }, num_threads );
+
+      CHECK( seen.size() == all.size() );
+      CHECK( std::set<std::vector<uint32_t>>( seen.begin(), seen.end() ).size() == all.size() );
+    }
+  }
+}
+
+TEST_CASE( "Materialize combinations of cubes", "[cube_utils]" )
+{
+  std::vector<kitty::cube> const cubes{kitty::cube( "1-" ), kitty::cube( "01" ), kitty::cube( "--" ), kitty::cube( "11" )};
+  auto const subsets = esop::combinations( cubes, 2u );
+  CHECK( subsets.size() == 6u );
+  CHECK( subsets.front() == std::vector<kitty::cube>{cubes[0], cubes[1]} );
+  CHECK( esop::combinations( cubes, 4u ) == std::vector<std::vector<kitty::cube>>{cubes} );
+}
+
+TEST_CASE( "Ternary cube weights and sorting by weight", "[cube_utils]" )
+{
+  auto const reference_weight = []( const kitty::cube& c, unsigned num_vars ) {
+    uint64_t value = 0, p = 1;
+    for ( auto i = 0u; i < num_vars; ++i, p *= 3 )
+    {
+      value += c.get_mask( i ) ? ( c.get_bit( i ) ? p : 0 ) : 2 * p;
+    }
+    return value;
+  };
+
+  std::mt19937 rng( 0x40 );
+  for ( auto num_vars : {1u, 5u, 8u, 17u, 32u} )
+  {
+    std::vector<kitty::cube> cubes;
+    for ( auto i = 0; i < 300; ++i )
+    {
+      uint32_t const mask = rng();
+      cubes.emplace_back( rng() & mask, mask );
+      CHECK( esop::cube_weight( cubes.back(), num_vars ) == reference_weight( cubes.back(), num_vars ) );
+    }
+
+    for ( auto size : {10u, 300u} )
+    {
+      std::vector<kitty::cube> sorted( cubes.begin(), cubes.begin() + size );
+      esop::sort_by_cube_weight( sorted, num_vars );
+      CHECK( std::is_sorted( sorted.begin(), sorted.end(), esop::cube_weight_compare( num_vars ) ) );
+      CHECK( std::is_permutation( sorted.begin(), sorted.end(), cubes.begin() ) );
+    }
+  }
+}
@@ -0,0 +1,76 @@
+#include <catch.hpp>
+
+#include <easy/esop/incremental_synthesis.hpp>
+#include <easy/esop/synthesis.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/print.hpp>
+
+#include <random>
+
+using namespace easy;
+
+TEST_CASE( "Incremental synthesis of a small function", "[synthesis]" )
+{
+  esop::incremental_synthesizer synthesizer( 2u, 1u );
+
+  /* all minterms are don't cares */
+  CHECK( synthesizer.synthesize().is_realizable() );
+
+  /* x0 AND x1 */
+  synthesizer.set_spec( esop::spec{"0001", "1111"} );
+  auto const r1 = synthesizer.synthesize();
+  REQUIRE( r1.is_realizable() );
+  CHECK( esop::verify_esop( r1.esop, "0001", "1111" ) );
+
+  /* x0 XOR x1 requires two terms */
+  synthesizer.set_minterm( 1u, '1' );
+  synthesizer.set_minterm( 2u, '1' );
+  synthesizer.set_minterm( 3u, '0' );
+  CHECK( synthesizer.synthesize().is_unrealizable() );
+
+  /* remove minterms 2 and 3 from the care set */
+  synthesizer.set_minterm( 2u, '-' );
+  synthesizer.set_minterm( 3u, '-' );
+  auto const r2 = synthesizer.synthesize();
+  REQUIRE( r2.is_realizable() );
+  CHECK( esop::verify_esop( r2.esop, "0110", "1100" ) );
+  CHECK( synthesizer.get_spec().care == "1100" );
+}
+
+TEST_CASE( "Incremental synthesis agrees with simple synthesis", "[synthesis]" )
+{
+  std::mt19937 rng( 0xcafe );
+  kitty::static_truth_table<4> tt;
+  kitty::create_random( tt, 0xcafe );
+
+  auto bits = kitty::to_binary( tt );
+  std::reverse( bits.begin(), bits.end() );
+  std::string care( bits.size(), '1' );
+
+  esop::incremental_synthesizer synthesizer( 4u, 3u );
+  synthesizer.set_spec( esop::spec{bits, care} );
+
+  for ( auto i = 0; i < 30; ++i )
+  {
+    /* flip a few minterms between care and don't care */
+    for ( auto j = 0; j < 3; ++j )
+    {
+      auto const index = rng() % bits.size();
+      bits[index] = ( rng() & 1 ) ? '1' : '0';
+      care[index] = care[index] == '1' ? '0' : '1';
+      synthesizer.set_minterm( index, care[index] == '1' ? bits[index] : '-' );
+    }
+
+    esop::spec const spec{bits, care};
+    esop::simple_synthesizer_params ps;
+    ps.number_of_terms = 3u;
+    auto const expected = esop::simple_synthesizer( spec ).synthesize( ps );
+    auto const result = synthesizer.synthesize();
+
+    CHECK( result.state == expected.state );
+    if ( result.is_realizable() )
+    {
+      CHECK( esop::verify_esop( result.esop, bits, care ) );
+    }
+  }
+}
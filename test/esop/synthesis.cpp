@@ -0,0 +1,220 @@
+#include <catch.hpp>
+
+#include <easy/esop/constructors.hpp>
+#include <easy/esop/synthesis.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/print.hpp>
+
+using namespace easy;
+
+TEST_CASE( "Synthesize minimum ESOP with warm start", "[synthesis]" )
+{
+  kitty::static_truth_table<4> tt;
+
+  for ( auto i = 0; i < 20; ++i )
+  {
+    kitty::create_random( tt );
+    if ( kitty::is_const0( tt ) )
+      continue;
+
+    auto bits = kitty::to_binary( tt );
+    std::reverse( bits.begin(), bits.end() );
+    esop::spec const spec{bits, std::string( bits.size(), '1' )};
+
+    /* upwards search without warm start */
+    esop::minimum_synthesizer_params up;
+    up.begin = 1;
+    up.next = [&]( uint32_t& k, sat::sat_solver::result sat ) { if ( k >= 16 || sat.is_sat() ) return false; ++k; return true; };
+    auto const expected = esop::minimum_synthesizer( spec ).synthesize( up );
+    REQUIRE( expected.is_realizable() );
+
+    /* downwards search with warm start */
+    esop::minimum_synthesizer_params down;
+    down.begin = 16;
+    down.next = [&]( uint32_t& k, sat::sat_solver::result sat ) { if ( k <= 1 || sat.is_unsat() ) return false; --k; return true; };
+
+    esop::minimum_synthesizer synthesizer( spec );
+    CHECK( synthesizer.warm_start( esop::esop_from_optimum_pkrm( tt ) ) );
+    auto const result = synthesizer.synthesize( down );
+    REQUIRE( result.is_realizable() );
+    CHECK( esop::verify_esop( result.esop, spec.bits, spec.care ) );
+    CHECK( result.esop.size() == expected.esop.size() );
+  }
+}
+
+TEST_CASE( "Reject invalid warm start", "[synthesis]" )
+{
+  esop::spec const spec{"0110", "1111"};
+  esop::minimum_synthesizer synthesizer( spec );
+
+  /* x0 does not implement x0 XOR x1 */
+  CHECK( !synthesizer.warm_start( esop::esop_t{kitty::cube( 1, 1 )} ) );
+  CHECK( synthesizer.warm_start( esop::esop_t{kitty::cube( 1, 1 ), kitty::cube( 2, 2 )} ) );
+}
+
+TEST_CASE( "Synthesize minimum ESOP with parallel search", "[synthesis]" )
+{
+  kitty::static_truth_table<4> tt;
+
+  for ( auto i = 0; i < 20; ++i )
+  {
+    kitty::create_random( tt );
+    if ( kitty::is_const0( tt ) )
+      continue;
+
+    auto bits = kitty::to_binary( tt );
+    std::reverse( bits.begin(), bits.end() );
+    esop::spec const spec{bits, std::string( bits.size(), '1' )};
+
+    esop::minimum_synthesizer_params up;
+    up.begin = 1;
+    up.next = [&]( uint32_t& k, sat::sat_solver::result sat ) { if ( k >= 16 || sat.is_sat() ) return false; ++k; return true; };
+    auto const expected = esop::minimum_synthesizer( spec ).synthesize( up );
+    REQUIRE( expected.is_realizable() );
+
+    for ( const auto num_threads : {1u, 4u} )
+    {
+      esop::parallel_minimum_synthesizer_params ps;
+      ps.lower_bound = 1;
+      ps.upper_bound = 16;
+      ps.num_threads = num_threads;
+
+      auto const result = esop::minimum_synthesizer( spec ).synthesize( ps );
+      REQUIRE( result.is_realizable() );
+      CHECK( esop::verify_esop( result.esop, spec.bits, spec.care ) );
+      CHECK( result.esop.size() == expected.esop.size() );
+    }
+  }
+
+  /* x0 XOR x1 needs two terms */
+  esop::parallel_minimum_synthesizer_params ps;
+  ps.lower_bound = 1;
+  ps.upper_bound = 1;
+  ps.num_threads = 2;
+  CHECK( esop::minimum_synthesizer( esop::spec{"0110", "1111"} ).synthesize( ps ).is_unrealizable() );
+}
+
+TEST_CASE( "Synthesize ESOP with cube-and-conquer", "[synthesis]" )
+{
+  /* 4 states per term, ordered: multisets of size 3 over 4 codes */
+  CHECK( esop::detail::esop_split_cubes( 4, 3, 3, 1 ).size() == 20u );
+  CHECK( esop::detail::esop_split_cubes( 4, 3, 0, 1 ).size() == 1u );
+
+  kitty::static_truth_table<4> tt;
+
+  for ( auto i = 0; i < 10; ++i )
+  {
+    kitty::create_random( tt );
+    if ( kitty::is_const0( tt ) )
+      continue;
+
+    auto bits = kitty::to_binary( tt );
+    std::reverse( bits.begin(), bits.end() );
+    esop::spec const spec{bits, std::string( bits.size(), '1' )};
+
+    esop::minimum_synthesizer_params up;
+    up.begin = 1;
+    up.next = [&]( uint32_t& k, sat::sat_solver::result sat ) { if ( k >= 16 || sat.is_sat() ) return false; ++k; return true; };
+    up.split_terms = 2;
+    up.split_vars = 2;
+    up.num_threads = 2;
+    auto const result = esop::minimum_synthesizer( spec ).synthesize( up );
+    REQUIRE( result.is_realizable() );
+    CHECK( esop::verify_esop( result.esop, spec.bits, spec.care ) );
+
+    /* compare with the optimum obtained without splitting */
+    const auto k = uint32_t( result.esop.size() );
+    esop::simple_synthesizer_params ps;
+    ps.number_of_terms = k;
+    CHECK( esop::simple_synthesizer( spec ).synthesize( ps ).is_realizable() );
+    if ( k > 1 )
+    {
+      ps.number_of_terms = k - 1;
+      CHECK( esop::simple_synthesizer( spec ).synthesize( ps ).is_unrealizable() );
+      ps.split_terms = k - 1;
+      ps.num_threads = 3;
+      CHECK( esop::simple_synthesizer( spec ).synthesize( ps ).is_unrealizable() );
+    }
+  }
+}
+
+TEST_CASE( "Reuse learnt clauses for a refined specification", "[synthesis]" )
+{
+  CHECK( esop::refines( esop::spec{"0110", "1111"}, esop::spec{"0100", "1100"} ) );
+  CHECK( !esop::refines( esop::spec{"0110", "1111"}, esop::spec{"0000", "1100"} ) );
+  CHECK( !esop::refines( esop::spec{"0110", "0111"}, esop::spec{"0110", "1100"} ) );
+
+  kitty::static_truth_table<4> tt, care;
+
+  for ( auto i = 0; i < 10; ++i )
+  {
+    kitty::create_random( tt );
+    kitty::create_random( care );
+    if ( kitty::is_const0( tt ) )
+      continue;
+
+    auto bits = kitty::to_binary( tt );
+    auto care_bits = kitty::to_binary( care );
+    std::reverse( bits.begin(), bits.end() );
+    std::reverse( care_bits.begin(), care_bits.end() );
+    esop::spec const partial{bits, care_bits};
+    esop::spec const full{bits, std::string( bits.size(), '1' )};
+
+    esop::minimum_synthesizer_params up;
+    up.begin = 1;
+    up.next = [&]( uint32_t& k, sat::sat_solver::result sat ) { if ( k >= 16 || sat.is_sat() ) return false; ++k; return true; };
+    auto const expected = esop::minimum_synthesizer( full ).synthesize( up );
+    REQUIRE( expected.is_realizable() );
+
+    for ( auto k = std::max<uint32_t>( 1u, expected.esop.size() - 1u ); k <= expected.esop.size(); ++k )
+    {
+      esop::simple_synthesizer_params ps;
+      ps.number_of_terms = k;
+      ps.max_learnt_clause_size = 8u;
+
+      esop::simple_synthesizer source( partial );
+      source.synthesize( ps );
+      auto const db = source.export_learnt_clauses();
+      CHECK( db.num_terms == k );
+
+      esop::simple_synthesizer target( full );
+      CHECK( target.import_learnt_clauses( db ) );
+      auto const result = target.synthesize( ps );
+      CHECK( result.is_realizable() == ( k == expected.esop.size() ) );
+      if ( result.is_realizable() )
+      {
+        CHECK( esop::verify_esop( result.esop, full.bits, full.care ) );
+      }
+
+      /* the partial specification does not refine the full one */
+      CHECK( !source.import_learnt_clauses( target.export_learnt_clauses() ) );
+    }
+  }
+}
+
+TEST_CASE( "Log statistics of ESOP synthesis", "[synthesis]" )
+{
+  /* majority-of-three requires 3 terms */
+  esop::spec const spec{"00010111", "11111111"};
+
+  esop::minimum_synthesizer_params params;
+  params.begin = 1;
+  params.next = [&]( uint32_t& k, sat::sat_solver::result sat ) { if ( k >= 8 || sat.is_sat() ) return false; ++k; return true; };
+
+  esop::minimum_synthesizer synthesizer( spec );
+  auto const result = synthesizer.synthesize( params );
+  REQUIRE( result.is_realizable() );
+  CHECK( result.esop.size() == 3u );
+
+  auto const stats = synthesizer.stats();
+  REQUIRE( stats["runs"].size() == 3u );
+  for ( auto k = 1u; k <= 3u; ++k )
+  {
+    auto const& run = stats["runs"][k - 1u];
+    CHECK( run["num_terms"] == k );
+    CHECK( run["encoding"]["num_clauses"] > 0u );
+    CHECK( run["encoding"]["num_xor_clauses_gauss"] <= run["encoding"]["num_xor_clauses"] );
+    CHECK( run["solving"]["result"] == ( k < 3u ? "unsat" : "sat" ) );
+    CHECK( run["solving"].count( "conflicts" ) == 1u );
+  }
+}
@@ -0,0 +1,183 @@
+#include <catch.hpp>
+#include <easy/sat/cnf_reader.hpp>
+#include <easy/sat/cnf_writer.hpp>
+#include <easy/sat/sat_solver.hpp>
+#include <easy/sat/xor_clauses_to_cnf.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace easy;
+
+namespace
+{
+
+std::vector<std::vector<int>> clauses_of( sat::constraints const& constraints )
+{
+  std::vector<std::vector<int>> clauses;
+  constraints.foreach_clause( [&]( sat::clause_view const& cl ){
+      clauses.emplace_back( cl );
+    });
+  return clauses;
+}
+
+} /* namespace */
+
+TEST_CASE( "Write constraints in DIMACS format", "[sat]" )
+{
+  sat::constraints constraints;
+  constraints.add_clause( { 1, -2 } );
+  constraints.add_clause( { -3 } );
+  constraints.add_xor_clause( { 1, 2, 3 } );
+  constraints.add_xor_clause( { 2, -3 }, false );
+  constraints.add_xor_clause( { 4 }, false );
+
+  std::stringstream ss;
+  sat::cnf_writer( ss ).apply( constraints );
+  CHECK( ss.str() == "p cnf 4 5\n"
+                     "1 -2 0\n"
+                     "-3 0\n"
+                     "x1 2 3 0\n"
+                     "x2 3 0\n"
+                     "-4 0\n" );
+}
+
+TEST_CASE( "Write constraints in WCNF format", "[sat]" )
+{
+  sat::constraints constraints( 0u );
+  constraints.add_clause( { 1, 2 } );
+  constraints.add_weighted_clause( { -1 }, 3u );
+  constraints.add_weighted_clause( { -2 }, 4u );
+
+  std::stringstream ss;
+  sat::cnf_writer( ss, sat::cnf_format::wcnf ).apply( constraints );
+  CHECK( ss.str() == "p wcnf 2 3 8\n"
+                     "8 1 2 0\n"
+                     "3 -1 0\n"
+                     "4 -2 0\n" );
+}
+
+TEST_CASE( "Read constraints in DIMACS format", "[sat]" )
+{
+  std::stringstream ss;
+  ss << "c example\n"
+        "p cnf 5 4\n"
+        "1 -2 0\n"
+        "c comment between clauses\n"
+        "-3\n 4 0 x1 2 0\n"
+        "x2 -5 0\n";
+
+  sat::constraints constraints;
+  sat::cnf_reader reader( constraints );
+  CHECK( reader.read( ss ) );
+  CHECK( !reader.is_weighted() );
+  CHECK( reader.num_clauses() == 4u );
+  CHECK( reader.num_declared_clauses() == 4u );
+  CHECK( constraints.num_variables() == 5u );
+  CHECK( clauses_of( constraints ) == std::vector<std::vector<int>>{ { 1, -2 }, { -3, 4 } } );
+
+  std::vector<std::vector<int>> xor_clauses;
+  constraints.foreach_xor_clause( [&]( sat::xor_clause_view const& cl ){
+      CHECK( cl.value );
+      xor_clauses.emplace_back( cl.clause );
+    });
+  CHECK( xor_clauses == std::vector<std::vector<int>>{ { 1, 2 }, { 2, -5 } } );
+
+  /* unterminated clause */
+  std::stringstream bad( "p cnf 2 1\n1 2\n" );
+  sat::constraints c2;
+  CHECK( !sat::cnf_reader( c2 ).read( bad ) );
+}
+
+TEST_CASE( "Read constraints in WCNF format", "[sat]" )
+{
+  std::stringstream ss( "p wcnf 2 3 10\n10 1 2 0\n3 -1 0\n4 -2 0\n" );
+
+  sat::constraints constraints;
+  sat::cnf_reader reader( constraints );
+  CHECK( reader.read( ss ) );
+  CHECK( reader.is_weighted() );
+
+  std::vector<std::pair<std::vector<int>, uint32_t>> clauses;
+  constraints.foreach_weighted_clause( [&]( sat::clause_view const& cl, uint32_t weight ){
+      clauses.emplace_back( std::vector<int>( cl ), weight );
+    });
+  CHECK( clauses.size() == 3u );
+  CHECK( clauses[0].first == std::vector<int>{ 1, 2 } );
+  CHECK( clauses[0].second == constraints.top_weight() );
+  CHECK( clauses[1] == std::make_pair( std::vector<int>{ -1 }, 3u ) );
+  CHECK( clauses[2] == std::make_pair( std::vector<int>{ -2 }, 4u ) );
+}
+
+TEST_CASE( "Round-trip DIMACS in blocks and threads", "[sat]" )
+{
+  /* x1 ^ ... ^ x40 = 0 and x1 ^ x2 = 1, encoded with many clauses */
+  sat::constraints constraints;
+  for ( auto i = 1; i < 40; ++i )
+  {
+    constraints.add_clause( { -i, i + 1, -( i + 100 ) } );
+    constraints.add_clause( { i, -( i + 1 ), i + 100 } );
+  }
+  std::vector<int> lits;
+  for ( auto i = 1; i <= 40; ++i )
+  {
+    lits.emplace_back( i );
+  }
+  constraints.add_xor_clause( lits, false );
+  constraints.add_xor_clause( { 1, 2 } );
+
+  std::stringstream ss;
+  sat::cnf_writer( ss, sat::cnf_format::dimacs, 100u ).apply( constraints );
+  auto const text = ss.str();
+
+  auto const filename = std::string( "easy_test_round_trip.cnf" );
+  {
+    std::ofstream os( filename );
+    os << text;
+  }
+
+  for ( auto num_threads : { 1u, 3u } )
+  {
+    sat::cnf_reader_params ps;
+    ps.num_threads = num_threads;
+    ps.block_size = 64u;
+
+    sat::constraints from_stream;
+    std::stringstream is( text );
+    CHECK( sat::cnf_reader( from_stream, ps ).read( is ) );
+
+    sat::constraints from_file;
+    CHECK( sat::cnf_reader( from_file, ps ).read( filename ) );
+
+    for ( auto const* c : { &from_stream, &from_file } )
+    {
+      CHECK( c->num_variables() == constraints.num_variables() );
+      CHECK( clauses_of( *c ) == clauses_of( constraints ) );
+
+      std::stringstream os;
+      sat::cnf_writer( os ).apply( *c );
+      CHECK( os.str() == text );
+    }
+  }
+  std::remove( filename.c_str() );
+
+  /* negated literal is preserved: x1 ^ ... ^ x40 = 0 together with x1 ^ x2 = 1 is satisfiable */
+  sat::constraints c;
+  std::stringstream is( text );
+  CHECK( sat::cnf_reader( c ).read( is ) );
+  int sid = 141;
+  sat::xor_clauses_to_cnf( sid ).apply( c );
+  sat::sat_solver solver;
+  auto const result = solver.solve( c );
+  CHECK( result.is_sat() );
+  auto parity = false;
+  for ( auto i = 0; i < 40; ++i )
+  {
+    parity ^= result.model[i] == Glucose::l_True;
+  }
+  CHECK( !parity );
+  CHECK( result.model[0] != result.model[1] );
+
+  CHECK( !sat::cnf_reader( c ).read( std::string( "does_not_exist.cnf" ) ) );
+}
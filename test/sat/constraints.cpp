@@ -0,0 +1,79 @@
+#include <catch.hpp>
+#include <easy/sat/constraints.hpp>
+#include <easy/sat/gauss.hpp>
+#include <easy/sat/sat_solver.hpp>
+#include <easy/sat/xor_clauses_to_cnf.hpp>
+
+using namespace easy;
+
+TEST_CASE( "Store clauses in clause pools", "[sat]" )
+{
+  sat::constraints constraints( 2u );
+  constraints.add_clause( { 1, -2 } );
+  constraints.add_weighted_clause( { 3 }, 1u );
+  constraints.add_clause( std::vector<int>{ -1, 2, -4 } );
+  constraints.add_xor_clause( { 1, 5 }, false );
+
+  CHECK( constraints.num_clauses() == 3u );
+  CHECK( constraints.num_xor_clauses() == 1u );
+  CHECK( constraints.num_variables() == 5u );
+
+  /* hard clauses are visited before soft clauses */
+  std::vector<std::pair<std::vector<int>, uint32_t>> clauses;
+  constraints.foreach_weighted_clause( [&]( sat::clause_view const& cl, uint32_t weight ){
+      clauses.emplace_back( std::vector<int>( cl ), weight );
+    });
+  CHECK( clauses.size() == 3u );
+  CHECK( clauses[0] == std::make_pair( std::vector<int>{ 1, -2 }, 2u ) );
+  CHECK( clauses[1] == std::make_pair( std::vector<int>{ -1, 2, -4 }, 2u ) );
+  CHECK( clauses[2] == std::make_pair( std::vector<int>{ 3 }, 1u ) );
+
+  constraints.foreach_xor_clause( [&]( sat::xor_clause_view const& cl ){
+      CHECK( std::vector<int>( cl.clause ) == std::vector<int>{ 1, 5 } );
+      CHECK( !cl.value );
+    });
+
+  /* moving transfers the clauses */
+  sat::constraints moved( std::move( constraints ) );
+  CHECK( moved.num_clauses() == 3u );
+  CHECK( moved.num_xor_clauses() == 1u );
+
+  moved.clear();
+  CHECK( moved.num_clauses() == 0u );
+  CHECK( moved.num_xor_clauses() == 0u );
+  CHECK( moved.num_variables() == 0u );
+
+  moved.add_clause( { 2 } );
+  moved.foreach_clause( [&]( sat::clause_view const& cl ){
+      CHECK( cl.size() == 1u );
+      CHECK( cl[0] == 2 );
+    });
+}
+
+TEST_CASE( "Solve XOR-constraints from clause pools", "[sat]" )
+{
+  /* x1 ^ x2 = 1, x2 ^ x3 = 1, x1 ^ x3 = 1 is unsatisfiable */
+  sat::constraints constraints;
+  constraints.add_xor_clause( { 1, 2 } );
+  constraints.add_xor_clause( { 2, 3 } );
+  constraints.add_xor_clause( { 1, 3 } );
+
+  int sid = 4;
+  sat::xor_clauses_to_cnf( sid ).apply( constraints );
+  CHECK( constraints.num_xor_clauses() == 0u );
+
+  sat::sat_solver solver;
+  CHECK( solver.solve( constraints ).is_unsat() );
+
+  /* x1 ^ x2 = 1, x2 ^ x3 = 0 */
+  constraints.add_xor_clause( { 1, 2 } );
+  constraints.add_xor_clause( { 2, 3 }, false );
+  sat::gauss_elimination().apply( constraints );
+  sat::xor_clauses_to_cnf( sid ).apply( constraints );
+
+  sat::sat_solver solver2;
+  auto const result = solver2.solve( constraints );
+  CHECK( result.is_sat() );
+  CHECK( result.model[0] != result.model[1] );
+  CHECK( result.model[1] == result.model[2] );
+}
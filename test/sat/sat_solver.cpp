@@ -0,0 +1,57 @@
+#include <catch.hpp>
+#include <easy/sat/constraints.hpp>
+#include <easy/sat/sat_solver.hpp>
+
+#include <chrono>
+#include <thread>
+
+using namespace easy;
+
+/* pigeonhole principle: n + 1 pigeons do not fit into n holes */
+sat::constraints make_pigeonhole( int n )
+{
+  sat::constraints constraints;
+  const auto var = [n]( int p, int h ) { return 1 + p * n + h; };
+  for ( auto p = 0; p <= n; ++p )
+  {
+    sat::constraints::clause_t clause;
+    for ( auto h = 0; h < n; ++h )
+    {
+      clause.emplace_back( var( p, h ) );
+    }
+    constraints.add_clause( clause );
+  }
+  for ( auto h = 0; h < n; ++h )
+  {
+    for ( auto p = 0; p <= n; ++p )
+    {
+      for ( auto q = p + 1; q <= n; ++q )
+      {
+        constraints.add_clause( { -var( p, h ), -var( q, h ) } );
+      }
+    }
+  }
+  return constraints;
+}
+
+TEST_CASE( "Interrupt search from another thread", "[sat]" )
+{
+  sat::sat_solver solver;
+  auto constraints = make_pigeonhole( 12 );
+
+  std::thread interrupter( [&solver]() {
+      std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+      solver.interrupt();
+    } );
+  auto const result = solver.solve( constraints );
+  interrupter.join();
+  CHECK( result.is_undef() );
+
+  /* the solver stays interrupted until it is reset */
+  sat::constraints empty;
+  CHECK( solver.solve( empty ).is_undef() );
+
+  solver.reset();
+  auto small = make_pigeonhole( 3 );
+  CHECK( solver.solve( small ).is_unsat() );
+}
@@ -1,6 +1,7 @@
 #include <catch.hpp>
 #include <easy/sat2/sat_solver.hpp>
 #include <easy/sat2/cardinality.hpp>
+#include <easy/utils/bit_operations.hpp>
 
 using namespace easy;
 
@@ -21,12 +22,9 @@ TEST_CASE( "Enumerate cardinality-5 solutions", "[cardinality]" )
     lits.emplace_back( sid++ );
   }
 
-  std::vector<std::vector<int>> cls;
-  auto tree = sat2::create_totalizer( cls, sid, lits, k_max );
-  for ( const auto& c : cls )
-  {
-    solver.add_clause( c );
-  }
+  sat2::totalizer_arena totalizers;
+  auto const tree = totalizers.create( solver, sid, lits, k_max );
+  auto const& vars = totalizers.vars( tree );
 
   std::vector<int> blocked;
   for ( auto k = 0; k <= k_max; ++k )
@@ -37,11 +35,11 @@ TEST_CASE( "Enumerate cardinality-5 solutions", "[cardinality]" )
     {
       if ( i < k )
       {
-        assumptions.push_back( tree->vars[i] );
+        assumptions.push_back( vars[i] );
       }
       else
       {
-        assumptions.push_back( -tree->vars[i] );
+        assumptions.push_back( -vars[i] );
       }
     }
 
@@ -88,17 +86,19 @@ TEST_CASE( "Increase cardinality n=7, k=3 to cardinality k=6", "[cardinality]" )
 
   /* create cardinality constraint */
   std::vector<std::vector<int>> cls;
-  auto tree = sat2::create_totalizer( cls, sid, lits, k_max );
+  sat2::totalizer_arena totalizers;
+  auto const tree = totalizers.create( cls, sid, lits, k_max );
   for ( const auto& c : cls )
   {
     solver.add_clause( c );
   }
+  CHECK( totalizers.vars( tree ).size() == 4u );
 
   /* prepare assumptions */
   std::vector<int> assumptions;
   for ( auto i = 0; i < k_max; ++i )
   {
-    assumptions.push_back( ( i < k ) ? tree->vars[i] : -tree->vars[i] );
+    assumptions.push_back( ( i < k ) ? totalizers.vars( tree )[i] : -totalizers.vars( tree )[i] );
   }
 
   /* enumerate all solutions and block them */
@@ -132,19 +132,15 @@ TEST_CASE( "Increase cardinality n=7, k=3 to cardinality k=6", "[cardinality]" )
 
   /* increase the cardinality constraint to k_max = 6 */
   k_max = 6;
-  std::vector<std::vector<int>> cls2;
-  increase_totalizer( cls2, sid, tree, k_max );
-  for ( const auto& c : cls2 )
-  {
-    solver.add_clause( c );
-  }
+  totalizers.increase( solver, sid, tree, k_max );
+  CHECK( totalizers.vars( tree ).size() == 7u );
 
   /* now we increase k = 5 and prepare new assumptions */
   k = 5;
   assumptions.clear();
   for ( auto i = 0; i < k_max; ++i )
   {
-    assumptions.push_back( ( i < k ) ? tree->vars[i] : -tree->vars[i] );
+    assumptions.push_back( ( i < k ) ? totalizers.vars( tree )[i] : -totalizers.vars( tree )[i] );
   }
 
   /* ... and enumerate again */
@@ -178,3 +174,142 @@ TEST_CASE( "Increase cardinality n=7, k=3 to cardinality k=6", "[cardinality]" )
   CHECK( num_k2_solutions == 29 );
   CHECK( num_k5_solutions == 91 );
 }
+
+TEST_CASE( "Merge totalizers", "[cardinality]" )
+{
+  sat2::sat_solver_statistics stats;
+  sat2::sat_solver_params ps;
+  sat2::sat_solver solver( stats, ps );
+
+  int sid = 1;
+
+  std::vector<int> lits_a, lits_b;
+  for ( auto i = 0; i < 3; ++i )
+  {
+    lits_a.emplace_back( sid++ );
+    lits_b.emplace_back( sid++ );
+  }
+
+  sat2::totalizer_arena totalizers;
+  auto const a = totalizers.create( solver, sid, lits_a, 1u );
+  auto const b = totalizers.create( solver, sid, lits_b, 1u );
+  auto const t = totalizers.merge( solver, sid, a, b, 3u );
+  CHECK( totalizers.vars( t ).size() == 4u );
+
+  /* at most k of the 6 literals are true for each k <= 3 */
+  for ( auto k = 0u; k <= 3u; ++k )
+  {
+    for ( auto m = 0u; m <= 6u; ++m )
+    {
+      std::vector<int> assumptions{-totalizers.vars( t )[k]};
+      for ( auto i = 0u; i < m; ++i )
+      {
+        assumptions.push_back( ( i % 2u == 0u ) ? lits_a[i / 2u] : lits_b[i / 2u] );
+      }
+      auto const expected = ( m <= k ) ? sat2::sat_solver::state::sat : sat2::sat_solver::state::unsat;
+      CHECK( solver.solve( assumptions ) == expected );
+    }
+  }
+}
+
+TEST_CASE( "Compare cardinality encodings with all assignments", "[cardinality]" )
+{
+  auto const n = 6u;
+
+  for ( auto const e : {sat2::cardinality_encoding::totalizer, sat2::cardinality_encoding::sequential_counter,
+                        sat2::cardinality_encoding::sorting_network, sat2::cardinality_encoding::adder} )
+  {
+    for ( auto k_max = 0u; k_max <= n; ++k_max )
+    {
+      sat2::sat_solver_statistics stats;
+      sat2::sat_solver_params ps;
+      sat2::sat_solver solver( stats, ps );
+
+      int sid = 1;
+      std::vector<int> lits;
+      for ( auto i = 0u; i < n; ++i )
+      {
+        lits.emplace_back( sid++ );
+      }
+
+      sat2::cardinality_encoder encoder;
+      auto const c = encoder.encode( solver, sid, lits, k_max, e );
+      CHECK( c.encoding == e );
+
+      for ( auto k = 0u; k <= k_max; ++k )
+      {
+        auto const l = encoder.at_most( solver, sid, c, k );
+        CHECK( ( l == 0 ) == ( k >= n ) );
+
+        for ( auto a = 0u; a < ( 1u << n ); ++a )
+        {
+          std::vector<int> assumptions;
+          for ( auto i = 0u; i < n; ++i )
+          {
+            assumptions.emplace_back( ( ( a >> i ) & 1u ) ? lits[i] : -lits[i] );
+          }
+          if ( l != 0 )
+          {
+            assumptions.emplace_back( l );
+          }
+
+          auto const expected = utils::popcount( a ) <= k ? sat2::sat_solver::state::sat : sat2::sat_solver::state::unsat;
+          CHECK( solver.solve( assumptions ) == expected );
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE( "Compare at-most-one encodings with all assignments", "[cardinality]" )
+{
+  auto const n = 10u;
+
+  for ( auto const e : {sat2::at_most_one_encoding::automatic, sat2::at_most_one_encoding::pairwise,
+                        sat2::at_most_one_encoding::product, sat2::at_most_one_encoding::commander} )
+  {
+    sat2::sat_solver_statistics stats;
+    sat2::sat_solver_params ps;
+    sat2::sat_solver solver( stats, ps );
+
+    int sid = 1;
+    std::vector<int> lits;
+    for ( auto i = 0u; i < n; ++i )
+    {
+      lits.emplace_back( sid++ );
+    }
+
+    sat2::cardinality_encoder encoder;
+    encoder.at_most_one( solver, sid, lits, e );
+
+    for ( auto a = 0u; a < ( 1u << n ); ++a )
+    {
+      std::vector<int> assumptions;
+      for ( auto i = 0u; i < n; ++i )
+      {
+        assumptions.emplace_back( ( ( a >> i ) & 1u ) ? lits[i] : -lits[i] );
+      }
+
+      auto const expected = utils::popcount( a ) <= 1u ? sat2::sat_solver::state::sat : sat2::sat_solver::state::unsat;
+      CHECK( solver.solve( assumptions ) == expected );
+    }
+  }
+}
+
+TEST_CASE( "Choose cardinality encoding by size", "[cardinality]" )
+{
+  /* small bounds favor the totalizer or the sequential counter */
+  auto const e1 = sat2::choose_cardinality_encoding( 729u, 2u );
+  CHECK( ( e1 == sat2::cardinality_encoding::totalizer || e1 == sat2::cardinality_encoding::sequential_counter ) );
+
+  /* large bounds favor the logarithmic encodings */
+  auto const e2 = sat2::choose_cardinality_encoding( 729u, 500u );
+  CHECK( ( e2 == sat2::cardinality_encoding::sorting_network || e2 == sat2::cardinality_encoding::adder ) );
+
+  for ( auto const e : {sat2::cardinality_encoding::totalizer, sat2::cardinality_encoding::sequential_counter,
+                        sat2::cardinality_encoding::sorting_network, sat2::cardinality_encoding::adder} )
+  {
+    CHECK( sat2::estimate_cardinality_clauses( e, 0u, 3u ) == 0u );
+    CHECK( sat2::estimate_cardinality_clauses( e, 10u, 20u ) == sat2::estimate_cardinality_clauses( e, 10u, 9u ) );
+  }
+}
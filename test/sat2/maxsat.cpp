@@ -141,6 +141,95 @@ void unsat_soft_clauses_test()
 
   CHECK( disabled_clauses == std::vector<int>{ s0, s1 } );
   CHECK( enabled_clauses == std::vector<int>{} );
+
+  /* check statistics */
+  CHECK( stats.num_soft_clauses == 2u );
+  CHECK( stats.num_iterations > 0u );
+  CHECK( stats.sat.num_calls > stats.num_iterations );
+  CHECK( stats.sat.num_clauses >= 5u );
+  if constexpr ( !std::is_same_v<Algorithm, sat2::maxsat_linear> )
+  {
+    CHECK( stats.num_cores > 0u );
+    CHECK( stats.max_core_size > 0u );
+    CHECK( stats.total_core_size >= stats.num_cores );
+  }
+  CHECK( stats.to_json()["sat"]["num_calls"] == stats.sat.num_calls );
+}
+
+template<typename Algorithm>
+void warm_start_test( std::vector<int> const& hint )
+{
+  int sid = 1;
+
+  using maxsat_solver_t = sat2::maxsat_solver<Algorithm>;
+  sat2::maxsat_solver_statistics stats;
+  sat2::maxsat_solver_params ps;
+  maxsat_solver_t solver( stats, ps, sid );
+
+  /* allocate variables */
+  std::vector<int> v;
+  for ( auto i = 0; i < 3; ++i )
+    v.emplace_back( sid++ );
+
+  /* add hard-clauses */
+  solver.add_clause( { -v[0], -v[1] } );
+  solver.add_clause( { -v[1], -v[2] } );
+
+  /* add soft-clauses */
+  auto const s0 = solver.add_soft_clause( { v[0] } );
+  auto const s1 = solver.add_soft_clause( { v[1] } );
+  auto const s2 = solver.add_soft_clause( { v[2] } );
+
+  /* solve */
+  solver.warm_start( hint );
+  auto const result = solver.solve();
+  CHECK( result == maxsat_solver_t::state::success );
+
+  /* check optimum solution */
+  CHECK( solver.get_enabled_clauses() == std::vector<int>{ s0, s2 } );
+  CHECK( solver.get_disabled_clauses() == std::vector<int>{ s1 } );
+}
+
+template<typename Algorithm>
+void core_reduction_test( sat2::core_reduction_params const& cps )
+{
+  int sid = 1;
+
+  using maxsat_solver_t = sat2::maxsat_solver<Algorithm>;
+  sat2::maxsat_solver_statistics stats;
+  sat2::maxsat_solver_params ps;
+  ps.core_reduction = cps;
+  maxsat_solver_t solver( stats, ps, sid );
+
+  /* allocate variables */
+  std::vector<int> v;
+  for ( auto i = 0; i < 6; ++i )
+    v.emplace_back( sid++ );
+
+  /* add hard-clauses: at most one of each pair */
+  solver.add_clause( { -v[0], -v[1] } );
+  solver.add_clause( { -v[2], -v[3] } );
+  solver.add_clause( { -v[4], -v[5] } );
+
+  /* add soft-clauses */
+  std::vector<int> soft;
+  for ( auto i = 0; i < 6; ++i )
+    soft.emplace_back( solver.add_soft_clause( { v[i] }, 1 + ( i % 2 ) ) );
+
+  /* solve */
+  auto const result = solver.solve();
+  CHECK( result == maxsat_solver_t::state::success );
+
+  /* one clause of each pair is disabled; RC2 keeps the heavier ones */
+  auto const disabled_clauses = solver.get_disabled_clauses();
+  CHECK( disabled_clauses.size() == 3u );
+  if constexpr ( std::is_same_v<Algorithm, sat2::maxsat_rc2> )
+  {
+    CHECK( disabled_clauses == std::vector<int>{ soft[0], soft[2], soft[4] } );
+  }
+
+  CHECK( stats.num_cores >= 3u );
+  CHECK( stats.to_json().count( "num_core_literals_removed" ) == 1u );
 }
 
 TEST_CASE( "Test unsatisfiable hard-clauses", "[sat]" )
@@ -170,3 +259,72 @@ TEST_CASE( "Test unsatisfiable soft-clauses", "[sat]" )
   unsat_soft_clauses_test<sat2::maxsat_uc>();
   unsat_soft_clauses_test<sat2::maxsat_rc2>();
 }
+
+TEST_CASE( "Test warm start", "[sat]" )
+{
+  /* optimum solution */
+  warm_start_test<sat2::maxsat_linear>( { 1, -2, 3 } );
+  warm_start_test<sat2::maxsat_uc>( { 1, -2, 3 } );
+  warm_start_test<sat2::maxsat_rc2>( { 1, -2, 3 } );
+
+  /* non-optimum solution */
+  warm_start_test<sat2::maxsat_linear>( { -1, 2, -3 } );
+  warm_start_test<sat2::maxsat_uc>( { -1, 2, -3 } );
+  warm_start_test<sat2::maxsat_rc2>( { -1, 2, -3 } );
+
+  /* inconsistent solution */
+  warm_start_test<sat2::maxsat_linear>( { 1, 2, 3 } );
+  warm_start_test<sat2::maxsat_uc>( { 1, 2, 3 } );
+  warm_start_test<sat2::maxsat_rc2>( { 1, 2, 3 } );
+}
+
+TEST_CASE( "Test core reduction", "[sat]" )
+{
+  sat2::core_reduction_params cps;
+  cps.trim_rounds = 4u;
+  cps.minimize = true;
+  core_reduction_test<sat2::maxsat_uc>( cps );
+  core_reduction_test<sat2::maxsat_rc2>( cps );
+
+  cps.refine = false;
+  cps.minimize_max_calls = 1u;
+  core_reduction_test<sat2::maxsat_uc>( cps );
+  core_reduction_test<sat2::maxsat_rc2>( cps );
+}
+
+TEST_CASE( "Test cardinality encodings of linear search", "[sat]" )
+{
+  for ( auto const e : {sat2::cardinality_encoding::automatic, sat2::cardinality_encoding::totalizer,
+                        sat2::cardinality_encoding::sequential_counter, sat2::cardinality_encoding::sorting_network,
+                        sat2::cardinality_encoding::adder} )
+  {
+    int sid = 1;
+
+    sat2::maxsat_solver_statistics stats;
+    sat2::maxsat_solver_params ps;
+    ps.cardinality = e;
+    sat2::maxsat_solver<sat2::maxsat_linear> solver( stats, ps, sid );
+
+    /* allocate variables */
+    std::vector<int> v;
+    for ( auto i = 0; i < 9; ++i )
+      v.emplace_back( sid++ );
+
+    /* at most one variable of each group of three is true */
+    for ( auto g = 0; g < 9; g += 3 )
+    {
+      solver.add_clause( { -v[g], -v[g + 1] } );
+      solver.add_clause( { -v[g], -v[g + 2] } );
+      solver.add_clause( { -v[g + 1], -v[g + 2] } );
+    }
+
+    for ( const auto& x : v )
+    {
+      solver.add_soft_clause( { x } );
+    }
+
+    CHECK( solver.solve() == sat2::maxsat_solver<sat2::maxsat_linear>::state::success );
+    CHECK( solver.get_disabled_clauses().size() == 6u );
+    CHECK( solver.get_enabled_clauses().size() == 3u );
+  }
+}
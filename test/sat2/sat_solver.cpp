@@ -93,6 +93,38 @@ TEST_CASE( "Test get model", "[sat]" )
   CHECK( result == sat2::sat_solver::state::unsat );
 }
 
+TEST_CASE( "Bulk clause loading and model view", "[sat]" )
+{
+  sat2::sat_solver_statistics stats;
+  sat2::sat_solver_params ps;
+  sat2::sat_solver solver( stats, ps );
+
+  /* (x1 | x2) & (!x1 | x3) & (!x3) */
+  solver.add_clauses( { 1, 2, 0, -1, 3, 0, -3, 0 } );
+  CHECK( solver.get_num_variables() == 3u );
+  CHECK( stats.num_clauses == 3u );
+  CHECK( stats.num_literals == 5u );
+
+  CHECK( solver.solve() == sat2::sat_solver::state::sat );
+
+  auto const view = solver.get_model_view();
+  auto const m = solver.get_model();
+  CHECK( view.size() == 3u );
+  CHECK( view.size() == m.size() );
+  for ( auto v = 1; v <= 3; ++v )
+  {
+    CHECK( view[v] == m[v] );
+    CHECK( view[-v] == m[-v] );
+  }
+  CHECK( !view[1] );
+  CHECK(  view[2] );
+  CHECK( !view[3] );
+
+  /* empty clause */
+  solver.add_clauses( { 0 } );
+  CHECK( solver.solve() == sat2::sat_solver::state::unsat );
+}
+
 TEST_CASE( "Test get core", "[sat]" )
 {
   sat2::sat_solver_statistics stats;
@@ -208,3 +240,143 @@ TEST_CASE( "Test unsat core extraction", "[sat]" )
   /* verify that it's an unsat core */
   CHECK( solver.solve( cs ) == sat2::sat_solver::state::unsat );
 }
+
+TEST_CASE( "Minimize unsat core in place", "[sat]" )
+{
+  sat2::sat_solver_statistics stats;
+  sat2::sat_solver_params ps;
+  sat2::sat_solver solver( stats, ps );
+
+  /* same example as above */
+  solver.add_clause( { -4,  1, 2 } );
+  solver.add_clause( { -5,  2 } );
+  solver.add_clause( { -6, -2, 3 } );
+  solver.add_clause( { -7, -2, -3 } );
+  solver.add_clause( { -8,  2, 3 } );
+  solver.add_clause( { -9, -1, 2, -3 } );
+
+  for ( auto refine : { true, false } )
+  {
+    std::vector<int> lits = { 4, 5, 6, 7, 8, 9 };
+    CHECK( solver.solve( lits ) == sat2::sat_solver::state::unsat );
+
+    auto const num_calls = sat2::minimize_core_in_place( solver, lits, -1, 0u, refine );
+    CHECK( num_calls <= 6u );
+    CHECK( solver.get_budget() == -1 );
+
+    /* the core is unsatisfiable and minimal */
+    CHECK( solver.solve( lits ) == sat2::sat_solver::state::unsat );
+    for ( auto i = 0u; i < lits.size(); ++i )
+    {
+      auto subset = lits;
+      subset.erase( subset.begin() + i );
+      CHECK( solver.solve( subset ) == sat2::sat_solver::state::sat );
+    }
+  }
+
+  /* trimming and a limited number of calls */
+  std::vector<int> lits = { 4, 5, 6, 7, 8, 9 };
+  sat2::core_reduction_params cps;
+  cps.trim_rounds = 2u;
+  cps.minimize = true;
+  cps.minimize_max_calls = 1u;
+  sat2::reduce_core( solver, lits, cps );
+  CHECK( lits.size() <= 6u );
+  CHECK( solver.solve( lits ) == sat2::sat_solver::state::unsat );
+}
+
+TEST_CASE( "Export and import learnt clauses", "[sat]" )
+{
+  /* pigeon-hole problem: 4 pigeons, 3 holes */
+  auto const var = []( int p, int h ){ return 1 + 3 * p + h; };
+  std::vector<std::vector<int>> clauses;
+  for ( auto p = 0; p < 4; ++p )
+  {
+    clauses.push_back( { var( p, 0 ), var( p, 1 ), var( p, 2 ) } );
+  }
+  for ( auto h = 0; h < 3; ++h )
+  {
+    for ( auto p = 0; p < 4; ++p )
+    {
+      for ( auto q = p + 1; q < 4; ++q )
+      {
+        clauses.push_back( { -var( p, h ), -var( q, h ) } );
+      }
+    }
+  }
+
+  sat2::sat_solver_statistics stats;
+  sat2::sat_solver_params ps;
+  sat2::sat_solver solver( stats, ps );
+  for ( const auto& c : clauses )
+  {
+    solver.add_clause( c );
+  }
+  CHECK( solver.solve() == sat2::sat_solver::state::unsat );
+
+  auto const learnts = solver.export_learnt_clauses( 3u, 12u );
+  for ( const auto& c : learnts )
+  {
+    CHECK( c.size() <= 3u );
+    for ( const auto& l : c )
+    {
+      CHECK( abs( l ) <= 12 );
+    }
+  }
+
+  /* the learnt clauses are implied: the problem with one pigeon less remains satisfiable */
+  sat2::sat_solver other( stats, ps );
+  for ( const auto& c : clauses )
+  {
+    other.add_clause( c );
+  }
+  other.import_learnt_clauses( learnts );
+  CHECK( other.solve() == sat2::sat_solver::state::unsat );
+  CHECK( other.solve( { -var( 3, 0 ) } ) == sat2::sat_solver::state::unsat );
+}
+
+TEST_CASE( "SAT-solver statistics", "[sat]" )
+{
+  /* pigeon-hole problem: 4 pigeons, 3 holes */
+  auto const var = []( int p, int h ){ return 1 + 3 * p + h; };
+
+  sat2::sat_solver_statistics stats;
+  sat2::sat_solver_params ps;
+  sat2::sat_solver solver( stats, ps );
+  for ( auto p = 0; p < 4; ++p )
+  {
+    solver.add_clause( { var( p, 0 ), var( p, 1 ), var( p, 2 ) } );
+  }
+  for ( auto h = 0; h < 3; ++h )
+  {
+    for ( auto p = 0; p < 4; ++p )
+    {
+      for ( auto q = p + 1; q < 4; ++q )
+      {
+        solver.add_clause( { -var( p, h ), -var( q, h ) } );
+      }
+    }
+  }
+
+  CHECK( stats.num_clauses == 22u );
+  CHECK( stats.num_literals == 48u );
+  CHECK( stats.num_variables == 12u );
+  CHECK( stats.num_calls == 0u );
+
+  CHECK( solver.solve( { -var( 3, 0 ), -var( 3, 1 ), -var( 3, 2 ) } ) == sat2::sat_solver::state::unsat );
+  CHECK( solver.solve() == sat2::sat_solver::state::unsat );
+
+  CHECK( stats.num_calls == 2u );
+  CHECK( stats.num_unsat == 2u );
+  CHECK( stats.num_sat == 0u );
+  CHECK( stats.conflicts > 0u );
+  CHECK( stats.decisions > 0u );
+  CHECK( stats.propagations > 0u );
+  CHECK( stats.time_last_solve <= stats.time_max_solve );
+  CHECK( stats.time_max_solve <= stats.time_solve );
+
+  auto const json = stats.to_json();
+  CHECK( json["num_calls"] == 2u );
+  CHECK( json["conflicts"] == stats.conflicts );
+  CHECK( json.count( "time_solve" ) == 1u );
+}
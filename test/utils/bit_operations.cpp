@@ -0,0 +1,48 @@
+#include <catch.hpp>
+
+#include <easy/utils/bit_operations.hpp>
+
+#include <random>
+
+using namespace easy;
+
+TEST_CASE( "Count bits of 64-bit words", "[bit_operations]" )
+{
+  const auto naive_popcount = []( uint64_t x ) {
+    uint32_t count = 0u;
+    for ( ; x; x >>= 1u )
+    {
+      count += x & 1u;
+    }
+    return count;
+  };
+
+  const auto naive_ctz = []( uint64_t x ) {
+    uint32_t count = 0u;
+    for ( ; ( x & 1u ) == 0u; x >>= 1u )
+    {
+      ++count;
+    }
+    return count;
+  };
+
+  CHECK( utils::popcount( 0u ) == 0u );
+  CHECK( utils::popcount( ~uint64_t( 0u ) ) == 64u );
+
+  for ( auto i = 0u; i < 64u; ++i )
+  {
+    auto const x = uint64_t( 1u ) << i;
+    CHECK( utils::popcount( x ) == 1u );
+    CHECK( utils::count_trailing_zeros( x ) == i );
+    CHECK( utils::detail::count_trailing_zeros_de_bruijn( x ) == i );
+  }
+
+  std::mt19937_64 rng( 0xcafeu );
+  for ( auto i = 0u; i < 1000u; ++i )
+  {
+    auto const x = rng() | ( uint64_t( 1u ) << ( i % 64u ) );
+    CHECK( utils::popcount( x ) == naive_popcount( x ) );
+    CHECK( utils::count_trailing_zeros( x ) == naive_ctz( x ) );
+    CHECK( utils::detail::count_trailing_zeros_de_bruijn( x ) == naive_ctz( x ) );
+  }
+}
@@ -0,0 +1,89 @@
+#include <catch.hpp>
+
+#include <easy/utils/dynamic_bitset.hpp>
+
+#include <random>
+
+using namespace easy;
+
+TEST_CASE( "Grow dynamic_bitset bit by bit", "[dynamic_bitset]" )
+{
+  utils::dynamic_bitset<> bs;
+  std::vector<bool> reference;
+
+  std::mt19937 rng( 0x41 );
+  for ( auto i = 0; i < 300; ++i )
+  {
+    bool const value = rng() & 1;
+    bs.push_back( value );
+    reference.push_back( value );
+  }
+
+  CHECK( bs.num_bits() == 300u );
+  CHECK( bs.num_blocks() == 5u );
+  for ( auto i = 0u; i < reference.size(); ++i )
+  {
+    CHECK( bs[i] == reference[i] );
+  }
+
+  bs.resize( 70u );
+  CHECK( bs.num_blocks() == 2u );
+  bs.resize( 130u, true );
+  CHECK( bs.count() == std::count( reference.begin(), reference.begin() + 70, true ) + 60u );
+}
+
+TEST_CASE( "Bulk operations on dynamic_bitset", "[dynamic_bitset]" )
+{
+  utils::dynamic_bitset<> a( 150u ), b( 150u );
+  for ( auto i : {0u, 3u, 64u, 100u, 149u} )
+  {
+    a.set_bit( i );
+  }
+  for ( auto i : {3u, 65u, 100u} )
+  {
+    b.set_bit( i );
+  }
+
+  CHECK( a.count() == 5u );
+  CHECK( a.any() );
+  CHECK( utils::dynamic_bitset<>( 150u ).none() );
+
+  /* iterate over set bits */
+  std::vector<uint64_t> positions;
+  for ( auto pos = a.find_first(); pos != a.npos; pos = a.find_next( pos ) )
+  {
+    positions.push_back( pos );
+  }
+  CHECK( positions == std::vector<uint64_t>{0u, 3u, 64u, 100u, 149u} );
+  CHECK( b.find_next( 100u ) == b.npos );
+
+  auto c = a;
+  c &= b;
+  CHECK( c.count() == 2u );
+  c = a;
+  c |= b;
+  CHECK( c.count() == 6u );
+  c = a;
+  c ^= b;
+  CHECK( c.count() == 4u );
+  CHECK( c.test( 65u ) );
+  CHECK( !c.test( 100u ) );
+
+  c.flip();
+  CHECK( c.count() == 146u );
+
+  auto d = b;
+  d.swap( c );
+  CHECK( d.count() == 146u );
+  CHECK( c == b );
+  CHECK( c != a );
+}
+
+TEST_CASE( "dynamic_bitset with 32-bit blocks", "[dynamic_bitset]" )
+{
+  utils::dynamic_bitset<uint32_t> bs( 40u, true );
+  CHECK( bs.num_blocks() == 2u );
+  CHECK( bs.count() == 40u );
+  bs.reset_bit( 33u );
+  CHECK( bs.find_next( 32u ) == 34u );
+}
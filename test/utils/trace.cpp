@@ -0,0 +1,189 @@
+#include <catch.hpp>
+
+#include <easy/esop/constructors.hpp>
+#include <easy/utils/trace.hpp>
+#include <kitty/constructors.hpp>
+#include <kitty/static_truth_table.hpp>
+
+#include <atomic>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace easy;
+
+TEST_CASE( "Trace buffer overwrites the oldest events", "[trace]" )
+{
+  utils::trace_buffer buffer( 1u, 3u );
+  CHECK( buffer.capacity() == 4u );
+
+  for ( auto i = 0u; i < 6u; ++i )
+  {
+    buffer.push( {"event", "test", i, 1u} );
+  }
+  CHECK( buffer.num_pushed() == 6u );
+
+  auto const events = buffer.events();
+  REQUIRE( events.size() == 4u );
+  for ( auto i = 0u; i < 4u; ++i )
+  {
+    CHECK( events[i].begin == i + 2u );
+  }
+
+  buffer.clear();
+  CHECK( buffer.events().empty() );
+}
+
+TEST_CASE( "Read trace buffer while events are pushed", "[trace]" )
+{
+  utils::trace_buffer buffer( 1u, 8u );
+  std::atomic<bool> done{false};
+
+  std::thread producer( [&]() {
+    for ( auto i = 0u; i < 200000u; ++i )
+    {
+      buffer.push( {"event", "test", i, 2u * i} );
+    }
+    done.store( true );
+  } );
+
+  /* every event that is read must be complete and in order */
+  auto num_inconsistent = 0u;
+  while ( !done.load() )
+  {
+    auto const events = buffer.events();
+    for ( auto k = 0u; k < events.size(); ++k )
+    {
+      if ( events[k].duration != 2u * events[k].begin || ( k > 0u && events[k].begin <= events[k - 1u].begin ) )
+      {
+        ++num_inconsistent;
+      }
+    }
+  }
+  producer.join();
+
+  CHECK( num_inconsistent == 0u );
+  CHECK( buffer.events().size() == buffer.capacity() );
+}
+
+TEST_CASE( "Record trace spans of several threads", "[trace]" )
+{
+  auto& tracer = utils::tracer::instance();
+  tracer.clear();
+
+  {
+    utils::trace_span span( "disabled", "test" );
+  }
+  CHECK( tracer.num_events() == 0u );
+
+  tracer.enable();
+  {
+    utils::trace_span span( "main", "test" );
+  }
+
+  /* the threads wait for each other, such that none takes over the buffer of another */
+  std::atomic<uint32_t> num_done{0u};
+  std::vector<std::thread> threads;
+  for ( auto t = 0u; t < 3u; ++t )
+  {
+    threads.emplace_back( [&num_done]() {
+        {
+          utils::trace_span outer( "outer", "test" );
+          for ( auto i = 0u; i < 10u; ++i )
+          {
+            utils::trace_span inner( "inner", "test" );
+          }
+        }
+        ++num_done;
+        while ( num_done.load() < 3u )
+        {
+          std::this_thread::yield();
+        }
+      } );
+  }
+  for ( auto& t : threads )
+  {
+    t.join();
+  }
+
+  /* spans of the library are recorded as well */
+  kitty::static_truth_table<4> tt;
+  kitty::create_from_hex_string( tt, "cafe" );
+  esop::esop_from_optimum_pkrm( tt );
+  tracer.disable();
+
+  CHECK( tracer.num_events() == 3u * 11u + 3u );
+
+  auto const trace = tracer.chrome_trace();
+  std::set<std::string> names;
+  std::set<uint32_t> tids;
+  for ( const auto& e : trace["traceEvents"] )
+  {
+    if ( e["ph"] == "X" )
+    {
+      names.insert( e["name"].get<std::string>() );
+      tids.insert( e["tid"].get<uint32_t>() );
+      CHECK( e["dur"].get<double>() >= 0.0 );
+    }
+  }
+  CHECK( names == std::set<std::string>{"main", "outer", "inner", "pkrm::expansions", "pkrm::cubes"} );
+  CHECK( tids.size() == 4u );
+
+  tracer.clear();
+  CHECK( tracer.num_events() == 0u );
+}
+
+TEST_CASE( "Trace buffer allocates slots on demand", "[trace]" )
+{
+  utils::trace_buffer buffer( 1u, 1u << 16u );
+  CHECK( buffer.num_allocated() == 0u );
+
+  for ( auto i = 0u; i < 10u; ++i )
+  {
+    buffer.push( {"event", "test", i, 1u} );
+  }
+  CHECK( buffer.num_allocated() == utils::trace_buffer::chunk_size );
+
+  for ( auto i = 0u; i < 3u * buffer.capacity(); ++i )
+  {
+    buffer.push( {"event", "test", i, 1u} );
+  }
+  CHECK( buffer.num_allocated() == buffer.capacity() );
+  CHECK( buffer.events().size() == buffer.capacity() );
+}
+
+TEST_CASE( "Buffers of exited threads are reused", "[trace]" )
+{
+  auto& tracer = utils::tracer::instance();
+  tracer.clear();
+  tracer.enable();
+
+  kitty::static_truth_table<4> tt;
+  kitty::create_from_hex_string( tt, "cafe" );
+
+  /* the parallel PKRM records spans in freshly spawned threads */
+  esop::pkrm_params ps;
+  ps.num_threads = 4u;
+  esop::pkrm_statistics st;
+
+  /* 20 rounds spawn more than 40 threads, of which only a few trace at the same time */
+  for ( auto k = 0u; k < 20u; ++k )
+  {
+    esop::esop_from_optimum_pkrm( tt, ps, st );
+
+    std::vector<std::thread> threads;
+    for ( auto t = 0u; t < 2u; ++t )
+    {
+      threads.emplace_back( []() { utils::trace_span span( "task", "test" ); } );
+    }
+    for ( auto& t : threads )
+    {
+      t.join();
+    }
+  }
+  tracer.disable();
+
+  CHECK( tracer.num_buffers() < 20u );
+  tracer.clear();
+}